@@ -0,0 +1,108 @@
+#include "Arduino.h"
+#include "Adafruit_SSD1306.h"
+#include "wifi.h"
+
+#include <chrono>
+#include <stdlib.h>
+
+HostSerial Serial;
+TwoWire Wire;
+HostWiFi WiFi;
+
+void HostSerial::log(const char* value, bool newline) {
+  static const bool verbose = getenv("HMI_EMULATOR_VERBOSE") != nullptr;
+  if(verbose) {
+    fputs(value, stderr);
+    if(newline) {
+      fputc('\n', stderr);
+    }
+  }
+}
+
+unsigned long millis() {
+  static auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire*, int8_t) :
+  Adafruit_GFX(w, h) {}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  free(buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t, uint8_t, bool, bool) {
+  if(!buffer) {
+    buffer = static_cast<uint8_t*>(malloc(WIDTH * ((HEIGHT + 7) / 8)));
+  }
+  if(buffer) {
+    clearDisplay();
+  }
+  return buffer != nullptr;
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if(x < 0 || y < 0 || x >= width() || y >= height()) {
+    return;
+  }
+  // same rotation handling as the real driver
+  switch(getRotation()) {
+    case 1:
+      std::swap(x, y);
+      x = WIDTH - x - 1;
+      break;
+    case 2:
+      x = WIDTH - x - 1;
+      y = HEIGHT - y - 1;
+      break;
+    case 3:
+      std::swap(x, y);
+      y = HEIGHT - y - 1;
+      break;
+  }
+
+  auto& byte = buffer[x + (y / 8) * WIDTH];
+  uint8_t bit = 1 << (y & 7);
+  switch(color) {
+    case SSD1306_WHITE:
+      byte |= bit;
+      break;
+    case SSD1306_BLACK:
+      byte &= ~bit;
+      break;
+    case SSD1306_INVERSE:
+      byte ^= bit;
+      break;
+  }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) const {
+  if(x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) {
+    return false;
+  }
+  return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
+
+bool Adafruit_SSD1306::writePbm(const char* path) const {
+  auto file = fopen(path, "wb");
+  if(!file) {
+    return false;
+  }
+  fprintf(file, "P4\n%d %d\n", WIDTH, HEIGHT);
+  for(int16_t y = 0; y < HEIGHT; y++) {
+    for(int16_t x = 0; x < WIDTH; x += 8) {
+      uint8_t bits = 0;
+      for(int16_t bit = 0; bit < 8; bit++) {
+        if(getPixel(x + bit, y)) {
+          bits |= 0x80 >> bit;
+        }
+      }
+      fputc(bits, file);
+    }
+  }
+  return fclose(file) == 0;
+}
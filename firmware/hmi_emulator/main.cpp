@@ -0,0 +1,238 @@
+#include "fghmi.h"
+#include "wifi.h"
+#include "dashboard.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace fg;
+
+namespace {
+
+  // values behind the dashboard pointers, changed like the control loop
+  // would change them
+  struct Sensors {
+    float temperature = 23.4;
+    float humidity = 61.2;
+    float co2 = 812;
+    float out_heater = 35;
+    float out_dehumidifier = 0;
+    float out_light = 100;
+    float out = 1;
+    float speed = 40;
+    float rpm = 1210;
+    float light = 80;
+    uint32_t out_co2 = 0;
+    bool day = true;
+    bool use_day = true;
+    uint8_t sensor_type = 2;
+
+    void step(unsigned second) {
+      temperature = 23.4 + (second % 7) * 0.1;
+      humidity = 61.2 - (second % 5) * 0.3;
+      co2 = 812 + (second % 11) * 3;
+      out_heater = (second * 7) % 100;
+      rpm = 1210 + (second % 3) * 15;
+      WiFi.rssi = (second / 30) % 2 ? -72 : -55;
+    }
+  };
+
+  Sensors sensors;
+
+  void pushSettingsMenu(UserInterface& ui);
+
+  void pushDashboard(UserInterface& ui) {
+#if defined(HMI_HWTYPE_CONTROLLER)
+    auto dashboard = ui.push<Dashboard>(&sensors.temperature, &sensors.humidity, &sensors.co2, &sensors.out_heater,
+      &sensors.out_dehumidifier, &sensors.out_light, &sensors.out_co2, &sensors.day, &sensors.sensor_type);
+#elif defined(HMI_HWTYPE_DRYER)
+    auto dashboard = ui.push<Dashboard>(&sensors.temperature, &sensors.humidity, &sensors.out_heater, &sensors.out_dehumidifier);
+#elif defined(HMI_HWTYPE_FAN)
+    auto dashboard = ui.push<Dashboard>(&sensors.temperature, &sensors.humidity, &sensors.speed, &sensors.rpm, &sensors.day);
+#elif defined(HMI_HWTYPE_FRIDGE)
+    auto dashboard = ui.push<Dashboard>(&sensors.temperature, &sensors.humidity, &sensors.co2, &sensors.out_heater,
+      &sensors.out_dehumidifier, &sensors.out_light, &sensors.out_co2, &sensors.day);
+#elif defined(HMI_HWTYPE_LIGHT)
+    auto dashboard = ui.push<Dashboard>(&sensors.temperature, &sensors.humidity, &sensors.light, &sensors.day);
+#elif defined(HMI_HWTYPE_PLUG)
+    auto dashboard = ui.push<Dashboard>(&sensors.temperature, &sensors.humidity, &sensors.co2, &sensors.out,
+      &sensors.sensor_type, &sensors.day, &sensors.use_day);
+#else
+#error "define the hwtype whose dashboard is emulated, e.g. HMI_HWTYPE_PLUG"
+#endif
+    dashboard->onEnter([&ui]() { pushSettingsMenu(ui); });
+  }
+
+  constexpr MenuDescriptor THRESHOLD_MENU[] = {
+    {"ON Day", ICON_TEMPERATURE, 0},
+    {"OFF Day", ICON_TEMPERATURE, 1},
+    {"ON Night", ICON_TEMPERATURE, 2},
+    {"OFF Night", ICON_TEMPERATURE, 3},
+  };
+
+  float thresholds[] = {25, 30, 20, 24};
+  uint32_t selected_mode = 1;
+  uint32_t dayrise = 21600;
+
+  // the widgets the controllers' settings menus are built from, the real
+  // menus need the controllers and their settings storage
+  void pushSettingsMenu(UserInterface& ui) {
+    auto menu = ui.push<SelectMenu>();
+    menu->addOption("Dashboard", ICON_DASHBOARD, [&ui]() { ui.pop(); });
+    menu->addOption("Control Mode", ICON_SETTINGS, [&ui]() {
+      ui.push<SelectInput>("Control Mode", selected_mode, std::vector<std::string>{"Off", "Heater", "Cooler", "Timer"}, [&ui](uint32_t mode) {
+        selected_mode = mode;
+        ui.pop();
+      });
+    });
+    menu->addOption("Dayrise (UTC)", ICON_DAY, [&ui]() {
+      ui.push<TimeEntry>("Dayrise (UTC)", dayrise, [&ui](uint32_t value) {
+        dayrise = value;
+        ui.pop();
+      });
+    });
+    menu->addOptions(THRESHOLD_MENU);
+    menu->onAction([&ui](const MenuDescriptor& entry) {
+      float& value = thresholds[entry.action];
+      ui.push<FloatInput>(entry.name, value, "C", 0, 40, 1, 0, [&ui, &value](float input) {
+        value = input;
+        ui.pop();
+      });
+    });
+  }
+
+  bool apply(UserInterface& ui, const char* action) {
+    if(!strcmp(action, "next")) {
+      ui.next();
+    }
+    else if(!strcmp(action, "prev")) {
+      ui.prev();
+    }
+    else if(!strcmp(action, "enter")) {
+      ui.enter();
+    }
+    else if(!strcmp(action, "hold")) {
+      ui.hold();
+    }
+    else if(strcmp(action, "tick")) {
+      fprintf(stderr, "unknown action '%s'\n", action);
+      return false;
+    }
+    return true;
+  }
+
+  std::vector<std::string> split(const char* actions) {
+    std::vector<std::string> result;
+    std::string list = actions;
+    size_t begin = 0;
+    while(begin < list.size()) {
+      auto end = list.find(',', begin);
+      end = end == std::string::npos ? list.size() : end;
+      if(end > begin) {
+        result.push_back(list.substr(begin, end - begin));
+      }
+      begin = end + 1;
+    }
+    return result;
+  }
+
+  // one ui tick per action, frames are written as <dir>/frame_NNN.pbm
+  int runScript(const char* script, const char* dump_dir) {
+    UserInterface ui;
+    ui.init();
+    pushDashboard(ui);
+
+    unsigned frame = 0;
+    for(auto& action : split(script)) {
+      if(!apply(ui, action.c_str())) {
+        return 2;
+      }
+
+      sensors.step(frame / 10);
+      ui.loop();
+      ui.cleanup();
+
+      if(dump_dir) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/frame_%03u.pbm", dump_dir, frame);
+        if(!UserInterface::display.writePbm(path)) {
+          fprintf(stderr, "could not write %s\n", path);
+          return 1;
+        }
+      }
+      frame++;
+    }
+    auto stats = ui.displayStats();
+    printf("%u frames, %u changed, %u bytes sent\n", stats.frames, stats.updates, stats.bytes);
+    return 0;
+  }
+
+  // Opens a scene with the setup actions, then runs it for a number of ui
+  // ticks feeding one of the inputs per tick in turn. Reports the time per
+  // tick (draw, frame diff and emulated transfer) and the bytes a real
+  // panel would have been sent.
+  void benchmark(const char* scene, const char* setup, const char* inputs, unsigned frames) {
+    UserInterface ui;
+    ui.init();
+    pushDashboard(ui);
+    for(auto& action : split(setup)) {
+      apply(ui, action.c_str());
+      ui.loop();
+      ui.cleanup();
+    }
+    ui.resetDisplayStats();
+
+    auto input = split(inputs);
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned frame = 0; frame < frames; frame++) {
+      sensors.step(frame / 10);
+      apply(ui, input[frame % input.size()].c_str());
+      ui.loop();
+      ui.cleanup();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    auto stats = ui.displayStats();
+    printf("%-10s %-10s %6u frames %8.1f us/frame %7.1f bytes/frame %5u changed\n",
+      HMI_HWTYPE_NAME, scene, frames, elapsed / 1000.0 / frames,
+      static_cast<double>(stats.bytes) / frames, stats.updates);
+  }
+
+}
+
+int main(int argc, char** argv) {
+  const char* script = nullptr;
+  const char* dump_dir = nullptr;
+  unsigned frames = 1000;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--script") && i + 1 < argc) {
+      script = argv[++i];
+    }
+    else if(!strcmp(argv[i], "--dump") && i + 1 < argc) {
+      dump_dir = argv[++i];
+    }
+    else if(!strcmp(argv[i], "--frames") && i + 1 < argc) {
+      frames = strtoul(argv[++i], nullptr, 10);
+    }
+    else {
+      fprintf(stderr, "usage: %s [--script next,prev,enter,hold,tick,...] [--dump dir] [--frames n]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if(script) {
+    return runScript(script, dump_dir);
+  }
+
+  // dashboards ignore next, it only keeps the panel from going to sleep
+  benchmark("dashboard", "", "next", frames);
+  benchmark("menu", "enter", "next,next,next,next,next,next,prev,prev,prev,prev,prev,prev", frames);
+  benchmark("select", "enter,next,enter", "next,next,prev,prev", frames);
+  benchmark("float", "enter,next,next,next,next,enter", "next,next,next,prev,prev,prev", frames);
+  return 0;
+}
@@ -0,0 +1,2 @@
+#pragma once
+// the emulator has no SPI or I2C devices, Adafruit GFX only needs the names
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Adafruit_GFX.h>
+#include "Wire.h"
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+
+// In memory SSD1306 with the same framebuffer layout as the panel: one
+// byte per column and 8 row page, least significant bit on top.
+class Adafruit_SSD1306 : public Adafruit_GFX {
+  uint8_t* buffer = nullptr;
+
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* wire = &Wire, int8_t rst_pin = -1);
+  ~Adafruit_SSD1306();
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0, bool reset = true, bool periph_begin = true);
+  void display() {}
+  void clearDisplay();
+  using Print::write;
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  bool getPixel(int16_t x, int16_t y) const;
+  uint8_t* getBuffer() { return buffer; }
+  void ssd1306_command(uint8_t) {}
+
+  // writes the frame as a binary PBM (P4) image
+  bool writePbm(const char* path) const;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+// Just enough of the Arduino core for Adafruit GFX and fghmi on the host.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <algorithm>
+
+#define ARDUINO 10819
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_pointer(addr) (*(void* const*)(addr))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+using std::min;
+using std::max;
+
+class String {
+  std::string value;
+public:
+  String(const char* str = "") : value(str) {}
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return value.size(); }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while(size--) {
+      n += write(*buffer++);
+    }
+    return n;
+  }
+  size_t write(const char* str) {
+    return str ? write(reinterpret_cast<const uint8_t*>(str), strlen(str)) : 0;
+  }
+  size_t print(const char* str) { return write(str); }
+};
+
+// fghmi only logs through Serial, the emulator keeps it quiet unless
+// HMI_EMULATOR_VERBOSE is set
+class HostSerial {
+public:
+  template<class T> void print(T value) { log(value, false); }
+  template<class T> void println(T value) { log(value, true); }
+  void println() { log("", true); }
+
+private:
+  template<class T> void log(T, bool) {}
+  void log(const char* value, bool newline);
+  void log(const __FlashStringHelper* value, bool newline) { log(reinterpret_cast<const char*>(value), newline); }
+};
+
+extern HostSerial Serial;
+
+unsigned long millis();
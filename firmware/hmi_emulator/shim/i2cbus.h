@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Wire.h"
+
+namespace fg {
+
+  enum class I2cPriority {
+    DISPLAY, SENSOR
+  };
+
+  class I2cBus {};
+
+  inline I2cBus& i2cBus(uint8_t) {
+    static I2cBus bus;
+    return bus;
+  }
+
+  // the emulated panel is always available
+  class I2cTransaction {
+  public:
+    I2cTransaction(I2cBus&, I2cPriority) {}
+    explicit operator bool() const { return true; }
+    TwoWire& wire() { return Wire; }
+    void fail() {}
+  };
+
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// The dashboards include the firmware's wifi.h only for the signal
+// strength, which the emulator sets per scene.
+#include "fghmi.h"
+
+class HostWiFi {
+public:
+  int8_t rssi = -55;
+  int8_t RSSI() const { return rssi; }
+};
+
+extern HostWiFi WiFi;
@@ -75,7 +75,9 @@ EspMQTTClient::EspMQTTClient(
   _mqttLastWillRetain = false;
   _mqttCleanSession = true;
   _mqttClient.setCallback([this](char* topic, uint8_t* payload, unsigned int length) {this->mqttMessageReceivedCallback(topic, payload, length);});
+  _mqttClient.setStreamCallback([this](char* topic, Stream& payload, uint32_t length) {this->mqttMessageStreamedCallback(topic, payload, length);});
   _failedMQTTConnectionAttemptCount = 0;
+  _maxStreamedPayloadSize = 16 * 1024;
 
   // HTTP/OTA update related
   _updateServerAddress = NULL;
@@ -144,9 +146,15 @@ void EspMQTTClient::enableOTA(const char *password, const uint16_t port)
     ArduinoOTA.setPort(port);
 }
 
-void EspMQTTClient::enableMQTTPersistence()
+void EspMQTTClient::enableMQTTPersistence(const uint32_t sessionExpirySeconds)
 {
   _mqttCleanSession = false;
+  _mqttClient.setSessionExpiry(sessionExpirySeconds);
+}
+
+void EspMQTTClient::enableMQTT5()
+{
+  _mqttClient.setProtocolVersion(MQTT_VERSION_5);
 }
 
 void EspMQTTClient::enableLastWillMessage(const char* topic, const char* message, const bool retain)
@@ -409,6 +417,17 @@ void EspMQTTClient::onMQTTConnectionLost()
 // =============== Public functions for interaction with thus lib =================
 
 
+void EspMQTTClient::reconnectMqtt()
+{
+  _mqttClient.disconnect();
+  if (_mqttConnected)
+  {
+    _mqttConnected = false;
+    onMQTTConnectionLost();
+  }
+  _nextMqttConnectionAttemptMillis = millis();
+}
+
 bool EspMQTTClient::setMaxPacketSize(const uint16_t size)
 {
 
@@ -444,49 +463,95 @@ bool EspMQTTClient::publish(const String &topic, const String &payload, bool ret
   return success;
 }
 
-bool EspMQTTClient::subscribe(const String &topic, MessageReceivedCallback messageReceivedCallback, uint8_t qos)
+bool EspMQTTClient::publish(const String &topic, const String &payload, bool retain, uint16_t topicAlias)
 {
-  // Do not try to subscribe if MQTT is not connected.
+  // Do not try to publish if MQTT is not connected.
   if(!isConnected())
   {
     if (_enableSerialLogs)
-      Serial.println("MQTT! Trying to subscribe when disconnected, skipping.");
+      Serial.println("MQTT! Trying to publish when disconnected, skipping.");
 
     return false;
   }
 
-  bool success = _mqttClient.subscribe(topic.c_str(), qos);
+  bool success = _mqttClient.publish(topic.c_str(), (const uint8_t*)payload.c_str(), payload.length(), retain, topicAlias);
 
-  if(success)
+  if (_enableSerialLogs)
+  {
+    if(success)
+      Serial.printf("MQTT << [%s|%u] %s\n", topic.c_str(), topicAlias, payload.c_str());
+    else
+      Serial.println("MQTT! publish failed, is the message too long or the topic alias not accepted by the broker ?");
+  }
+
+  return success;
+}
+
+bool EspMQTTClient::publish(const String &topic, const String &payload, bool retain, uint8_t qos, uint16_t* msgId)
+{
+  // Do not try to publish if MQTT is not connected.
+  if(!isConnected())
   {
-    // Add the record to the subscription list only if it does not exists.
-    bool found = false;
-    for (std::size_t i = 0; i < _topicSubscriptionList.size() && !found; i++)
-      found = _topicSubscriptionList[i].topic.equals(topic);
+    if (_enableSerialLogs)
+      Serial.println("MQTT! Trying to publish when disconnected, skipping.");
 
-    if(!found)
-      _topicSubscriptionList.push_back({ topic, messageReceivedCallback, NULL });
+    return false;
   }
-  
+
+  bool success = _mqttClient.publish(topic.c_str(), (const uint8_t*)payload.c_str(), payload.length(), retain, qos, msgId);
+
   if (_enableSerialLogs)
   {
     if(success)
-      Serial.printf("MQTT: Subscribed to [%s]\n", topic.c_str());
+      Serial.printf("MQTT << [%s] QoS %u %s\n", topic.c_str(), qos, payload.c_str());
     else
-      Serial.println("MQTT! subscribe failed");
+      Serial.println("MQTT! publish failed, is the message too long or the in-flight window full ?");
   }
 
   return success;
 }
 
+bool EspMQTTClient::subscribe(const String &topic, MessageReceivedCallback messageReceivedCallback, uint8_t qos)
+{
+  return subscribe({ topic, messageReceivedCallback, NULL, NULL }, qos);
+}
+
 bool EspMQTTClient::subscribe(const String &topic, MessageReceivedCallbackWithTopic messageReceivedCallback, uint8_t qos)
 {
-  if(subscribe(topic, (MessageReceivedCallback)NULL, qos))
+  return subscribe({ topic, NULL, messageReceivedCallback, NULL }, qos);
+}
+
+bool EspMQTTClient::subscribe(const String &topic, MessageStreamedCallback messageStreamedCallback, uint8_t qos)
+{
+  return subscribe({ topic, NULL, NULL, messageStreamedCallback }, qos);
+}
+
+bool EspMQTTClient::subscribe(const TopicSubscriptionList::Record &record, uint8_t qos)
+{
+  // Do not try to subscribe if MQTT is not connected.
+  if(!isConnected())
   {
-    _topicSubscriptionList[_topicSubscriptionList.size()-1].callbackWithTopic = messageReceivedCallback;
-    return true;
+    if (_enableSerialLogs)
+      Serial.println("MQTT! Trying to subscribe when disconnected, skipping.");
+
+    return false;
+  }
+
+  bool success = _mqttClient.subscribe(record.topic.c_str(), qos);
+
+  // A topic subscribed again, e.g. after a reconnect, keeps only the new callback
+  if(success)
+    _topicSubscriptionList.set(record);
+
+  if (_enableSerialLogs)
+  {
+    if(success)
+      Serial.printf("MQTT: Subscribed to [%s]\n", record.topic.c_str());
+    else
+      Serial.println("MQTT! subscribe failed");
   }
-  return false;
+
+  return success;
 }
 
 bool EspMQTTClient::unsubscribe(const String &topic)
@@ -500,25 +565,21 @@ bool EspMQTTClient::unsubscribe(const String &topic)
     return false;
   }
 
-  for (std::size_t i = 0; i < _topicSubscriptionList.size(); i++)
+  if (_topicSubscriptionList.contains(topic))
   {
-    if (_topicSubscriptionList[i].topic.equals(topic))
+    if(_mqttClient.unsubscribe(topic.c_str()))
     {
-      if(_mqttClient.unsubscribe(topic.c_str()))
-      {
-        _topicSubscriptionList.erase(_topicSubscriptionList.begin() + i);
-        i--;
+      _topicSubscriptionList.remove(topic);
 
-        if(_enableSerialLogs)
-          Serial.printf("MQTT: Unsubscribed from %s\n", topic.c_str());
-      }
-      else
-      {
-        if(_enableSerialLogs)
-          Serial.println("MQTT! unsubscribe failed");
+      if(_enableSerialLogs)
+        Serial.printf("MQTT: Unsubscribed from %s\n", topic.c_str());
+    }
+    else
+    {
+      if(_enableSerialLogs)
+        Serial.println("MQTT! unsubscribe failed");
 
-        return false;
-      }
+      return false;
     }
   }
 
@@ -581,6 +642,8 @@ bool EspMQTTClient::connectToMqttBroker()
 
     // explicitly set the server/port here in case they were not provided in the constructor
     _mqttClient.setServer(_mqttServerIp, _mqttServerPort);
+    // announced to MQTT 5 brokers, topic and headers fit into the buffer
+    _mqttClient.setMaximumPacketSize(_maxStreamedPayloadSize + _mqttClient.getBufferSize());
     success = _mqttClient.connect(_mqttClientName, _mqttUsername, _mqttPassword, _mqttLastWillTopic, 0, _mqttLastWillRetain, _mqttLastWillMessage, _mqttCleanSession);
   }
   else
@@ -627,12 +690,24 @@ bool EspMQTTClient::connectToMqttBroker()
         case 5:
           Serial.println("MQTT_CONNECT_UNAUTHORIZED");
           break;
+        default:
+          Serial.printf("reason code 0x%02x\n", _mqttClient.state());
+          break;
       }
 
       Serial.printf("MQTT: Retrying to connect in %i seconds.\n", _mqttReconnectionAttemptDelay / 1000);
     }
   }
 
+  // MQTT 3.1.1 brokers refuse the protocol level of MQTT 5
+  if (!success && _mqttClient.protocolVersion() == MQTT_VERSION_5 &&
+      (_mqttClient.state() == MQTT_CONNECT_BAD_PROTOCOL || _mqttClient.state() == MQTT_CONNECT_UNSUPPORTED_PROTOCOL_VERSION))
+  {
+    if (_enableSerialLogs)
+      Serial.println("MQTT: broker does not support MQTT 5, using 3.1.1 from now on.");
+    _mqttClient.setProtocolVersion(MQTT_VERSION_3_1_1);
+  }
+
   return success;
 }
 
@@ -656,79 +731,67 @@ void EspMQTTClient::processDelayedExecutionRequests()
   }
 }
 
-/**
- * Matching MQTT topics, handling the eventual presence of a single wildcard character
- *
- * @param topic1 is the topic may contain a wildcard
- * @param topic2 must not contain wildcards
- * @return true on MQTT topic match, false otherwise
- */
-bool EspMQTTClient::mqttTopicMatch(const String &topic1, const String &topic2) 
+void EspMQTTClient::mqttMessageReceivedCallback(char* topic, uint8_t* payload, unsigned int length)
 {
-  int i = 0;
-
-  if((i = topic1.indexOf('#')) >= 0) 
-  {
-    String t1a = topic1.substring(0, i);
-    String t1b = topic1.substring(i+1);
-    if((t1a.length() == 0 || topic2.startsWith(t1a)) &&
-       (t1b.length() == 0 || topic2.endsWith(t1b)))
-      return true;
-  } 
-  else if((i = topic1.indexOf('+')) >= 0) 
-  {
-    String t1a = topic1.substring(0, i);
-    String t1b = topic1.substring(i+1);
+  // Convert the payload into a String
+  // Messages that would fill the PubSubClient buffer are streamed instead (see mqttMessageStreamedCallback),
+  // so there is always room to add the string termination code at the end of the payload
+  payload[length] = '\0';
+  String payloadStr((char*)payload);
+  String topicStr(topic);
 
-    if((t1a.length() == 0 || topic2.startsWith(t1a))&&
-       (t1b.length() == 0 || topic2.endsWith(t1b))) 
-    {
-      if(topic2.substring(t1a.length(), topic2.length()-t1b.length()).indexOf('/') == -1)
-        return true;
-    }
-  } 
-  else 
-  {
-    return topic1.equals(topic2);
-  }
+  // Logging
+  if (_enableSerialLogs)
+    Serial.printf("MQTT >> [%s] %s\n", topic, payloadStr.c_str());
 
-  return false;
+  _topicSubscriptionList.dispatch(topicStr, payloadStr);
 }
 
-void EspMQTTClient::mqttMessageReceivedCallback(char* topic, uint8_t* payload, unsigned int length)
+// Messages that do not fit into the packet buffer are read from the connection
+// in chunks, so the buffer can stay small
+void EspMQTTClient::mqttMessageStreamedCallback(char* topic, Stream& payload, uint32_t length)
 {
-  // Convert the payload into a String
-  // First, We ensure that we dont bypass the maximum size of the PubSubClient library buffer that originated the payload
-  // This buffer has a maximum length of _mqttClient.getBufferSize() and the payload begin at "headerSize + topicLength + 1"
-  unsigned int strTerminationPos;
-  if (strlen(topic) + length + 9 >= _mqttClient.getBufferSize())
+  if (length > _maxStreamedPayloadSize)
   {
-    strTerminationPos = length - 1;
-
     if (_enableSerialLogs)
-      Serial.print("MQTT! Your message may be truncated, please set setMaxPacketSize() to a higher value.\n");
+      Serial.printf("MQTT! message of %u bytes on [%s] dropped, see setMaxStreamedPayloadSize()\n", length, topic);
+    return;
   }
-  else
-    strTerminationPos = length;
 
-  // Second, we add the string termination code at the end of the payload and we convert it to a String object
-  payload[strTerminationPos] = '\0';
-  String payloadStr((char*)payload);
   String topicStr(topic);
+  MessageStreamedCallback streamSubscriber = _topicSubscriptionList.streamSubscriber(topicStr);
+  if (streamSubscriber != NULL)
+  {
+    if (_enableSerialLogs)
+      Serial.printf("MQTT >> [%s] %u bytes streamed to the subscriber\n", topic, length);
+    streamSubscriber(topicStr, payload, length);
+    return;
+  }
 
-  // Logging
-  if (_enableSerialLogs)
-    Serial.printf("MQTT >> [%s] %s\n", topic, payloadStr.c_str());
+  String payloadStr;
+  if (!payloadStr.reserve(length))
+  {
+    if (_enableSerialLogs)
+      Serial.printf("MQTT! no memory for a message of %u bytes on [%s], dropped\n", length, topic);
+    return;
+  }
 
-  // Send the message to subscribers
-  for (std::size_t i = 0 ; i < _topicSubscriptionList.size() ; i++)
+  PubSubPayloadStream& stream = static_cast<PubSubPayloadStream&>(payload);
+  char chunk[128];
+  while (stream.remaining())
   {
-    if (mqttTopicMatch(_topicSubscriptionList[i].topic, String(topic)))
+    int count = stream.read((uint8_t*)chunk, sizeof(chunk));
+    if (count <= 0)
     {
-      if(_topicSubscriptionList[i].callback != NULL)
-        _topicSubscriptionList[i].callback(payloadStr); // Call the callback
-      if(_topicSubscriptionList[i].callbackWithTopic != NULL)
-        _topicSubscriptionList[i].callbackWithTopic(topicStr, payloadStr); // Call the callback
+      if (_enableSerialLogs)
+        Serial.printf("MQTT! message on [%s] timed out after %u of %u bytes\n", topic, payloadStr.length(), length);
+      return;
     }
+    payloadStr.concat(chunk, count);
   }
+
+  if (_enableSerialLogs)
+    Serial.printf("MQTT >> [%s] %u bytes streamed\n", topic, length);
+
+  _topicSubscriptionList.dispatch(topicStr, payloadStr);
 }
@@ -4,6 +4,7 @@
 #include <ArduinoOTA.h>
 #include <PubSubClient.h>
 #include <vector>
+#include "TopicSubscriptionList.h"
 
 #ifdef ESP8266
 
@@ -32,9 +33,8 @@
 void onConnectionEstablished(); // MUST be implemented in your sketch. Called once everythings is connected (Wifi, mqtt).
 
 typedef std::function<void()> ConnectionEstablishedCallback;
-typedef std::function<void(const String &message)> MessageReceivedCallback;
-typedef std::function<void(const String &topicStr, const String &message)> MessageReceivedCallbackWithTopic;
 typedef std::function<void()> DelayedExecutionCallback;
+typedef std::function<void(uint16_t msgId)> PublishAckCallback;
 
 class EspMQTTClient
 {
@@ -64,15 +64,11 @@ private:
   char* _mqttLastWillMessage;
   bool _mqttLastWillRetain;
   unsigned int _failedMQTTConnectionAttemptCount;
+  size_t _maxStreamedPayloadSize;
 
   PubSubClient _mqttClient;
 
-  struct TopicSubscriptionRecord {
-    String topic;
-    MessageReceivedCallback callback;
-    MessageReceivedCallbackWithTopic callbackWithTopic;
-  };
-  std::vector<TopicSubscriptionRecord> _topicSubscriptionList;
+  TopicSubscriptionList _topicSubscriptionList;
 
   // HTTP/OTA update related
   char* _updateServerAddress;
@@ -140,8 +136,10 @@ public:
   void enableHTTPWebUpdater(const char* username, const char* password, const char* address = "/"); // Activate the web updater, must be set before the first loop() call.
   void enableHTTPWebUpdater(const char* address = "/"); // Will set user and password equal to _mqttUsername and _mqttPassword
   void enableOTA(const char *password = NULL, const uint16_t port = 0); // Activate OTA updater, must be set before the first loop() call.
-  void enableMQTTPersistence(); // Tell the broker to establish a persistent connection. Disabled by default. Must be called before the first loop() execution
+  void enableMQTTPersistence(const uint32_t sessionExpirySeconds = 0xFFFFFFFF); // Tell the broker to establish a persistent connection. Disabled by default. Must be called before the first loop() execution. MQTT 5 brokers drop the session sessionExpirySeconds after the connection closed, the default never does
+  void enableMQTT5(); // Connect with MQTT 5 instead of 3.1.1, falls back to 3.1.1 if the broker rejects it. Must be called before the first loop() execution
   void enableLastWillMessage(const char* topic, const char* message, const bool retain = false); // Must be set before the first loop() call.
+  void setMaxStreamedPayloadSize(const size_t size) { _maxStreamedPayloadSize = size; } // Messages larger than the packet buffer are streamed up to this size, larger ones are dropped (MQTT 5 brokers do not send them). 16 KiB by default
   void enableDrasticResetOnConnectionFailures() {_drasticResetOnConnectionFailures = true;} // Can be usefull in special cases where the ESP board hang and need resetting (#59)
 
   /// Main loop, to call at each sketch loop()
@@ -150,10 +148,14 @@ public:
   // MQTT related
   bool setMaxPacketSize(const uint16_t size); // Pubsubclient >= 2.8; override the default value of MQTT_MAX_PACKET_SIZE
   bool publish(const String &topic, const String &payload, bool retain = false);
+  bool publish(const String &topic, const String &payload, bool retain, uint16_t topicAlias); // MQTT 5 only, see PubSubClient::publish()
+  bool publish(const String &topic, const String &payload, bool retain, uint8_t qos, uint16_t* msgId); // QoS 1 stores the packet id the PublishAckCallback reports, fails while the in-flight window is full
   bool subscribe(const String &topic, MessageReceivedCallback messageReceivedCallback, uint8_t qos = 0);
   bool subscribe(const String &topic, MessageReceivedCallbackWithTopic messageReceivedCallback, uint8_t qos = 0);
+  bool subscribe(const String &topic, MessageStreamedCallback messageStreamedCallback, uint8_t qos = 0); // Each call replaces the callback of an earlier subscription to the topic, whatever its kind. The payload is read while the callback runs, a message larger than the packet buffer is not copied into a String unless another subscription of the topic takes one
   bool unsubscribe(const String &topic);   //Unsubscribes from the topic, if it exists, and removes it from the CallbackList.
   void setKeepAlive(uint16_t keepAliveSeconds); // Change the keepalive interval (15 seconds by default)
+  void reconnectMqtt(); // Drop the broker connection and connect again on the next loop() call, e.g. after setMqttServer()
   inline void setMqttClientName(const char* name) { _mqttClientName = name; }; // Allow to set client name manually (must be done in setup(), else it will not work.)
   inline void setMqttServer(const char* server, const char* username = "", const char* password = "", const short port = 1883) { // Allow setting the MQTT info manually (must be done in setup())
     _mqttServerIp   = server;
@@ -171,6 +173,12 @@ public:
   inline bool isConnected() const { return isWifiConnected() && isMqttConnected(); }; // Return true if everything is connected
   inline bool isWifiConnected() const { return _wifiConnected; }; // Return true if wifi is connected
   inline bool isMqttConnected() const { return _mqttConnected; }; // Return true if mqtt is connected
+  inline bool isMqttSessionPresent() { return _mqttClient.sessionPresent(); }; // Return true if the broker resumed the session of enableMQTTPersistence()
+  inline uint8_t getMqttInflightCount() { return _mqttClient.inflight(); }; // QoS 1 publishes waiting for their PUBACK
+  inline uint8_t getMqttMaxInflight() { return _mqttClient.maxInflight(); };
+  inline void setMaxInflight(const uint8_t count) { _mqttClient.setMaxInflight(count); }; // Size of the QoS 1 in-flight window, at most MQTT_MAX_INFLIGHT
+  inline void setPublishAckCallback(PublishAckCallback callback) { _mqttClient.setPublishAckCallback(callback); }; // Called with the packet id of a QoS 1 publish once the broker has it
+  inline uint16_t getMqttTopicAliasMaximum() { return _mqttClient.topicAliasMaximum(); }; // Highest topic alias the broker accepts on the current connection, 0 without MQTT 5
   inline unsigned int getConnectionEstablishedCount() const { return _connectionEstablishedCount; }; // Return the number of time onConnectionEstablished has been called since the beginning.
 
   inline const char* getMqttClientName() { return _mqttClientName; };
@@ -197,8 +205,9 @@ private:
   void connectToWifi();
   bool connectToMqttBroker();
   void processDelayedExecutionRequests();
-  bool mqttTopicMatch(const String &topic1, const String &topic2);
+  bool subscribe(const TopicSubscriptionList::Record &record, uint8_t qos);
   void mqttMessageReceivedCallback(char* topic, uint8_t* payload, unsigned int length);
+  void mqttMessageStreamedCallback(char* topic, Stream& payload, uint32_t length);
 };
 
 #endif
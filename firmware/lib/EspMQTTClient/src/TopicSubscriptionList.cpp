@@ -0,0 +1,106 @@
+#include "TopicSubscriptionList.h"
+#include <StreamString.h>
+
+int TopicSubscriptionList::find(const String &topic) const
+{
+  for (std::size_t i = 0; i < _records.size(); i++)
+    if (_records[i].topic.equals(topic))
+      return i;
+  return -1;
+}
+
+void TopicSubscriptionList::set(const Record &record)
+{
+  // The whole record is replaced, so it never keeps the callback of another kind a previous subscribe() set
+  int i = find(record.topic);
+  if (i >= 0)
+    _records[i] = record;
+  else
+    _records.push_back(record);
+}
+
+bool TopicSubscriptionList::remove(const String &topic)
+{
+  int i = find(topic);
+  if (i < 0)
+    return false;
+  _records.erase(_records.begin() + i);
+  return true;
+}
+
+MessageStreamedCallback TopicSubscriptionList::streamSubscriber(const String &topicStr) const
+{
+  // a stream can only be read once, it goes to the first subscription that
+  // takes one unless another one needs the payload as a String anyway
+  MessageStreamedCallback streamCallback = NULL;
+  for (std::size_t i = 0 ; i < _records.size() ; i++)
+  {
+    if (match(_records[i].topic, topicStr))
+    {
+      if (_records[i].callback != NULL || _records[i].callbackWithTopic != NULL)
+        return NULL;
+      if (_records[i].streamCallback != NULL && streamCallback == NULL)
+        streamCallback = _records[i].streamCallback;
+    }
+  }
+  return streamCallback;
+}
+
+void TopicSubscriptionList::dispatch(const String &topicStr, const String &payloadStr) const
+{
+  for (std::size_t i = 0 ; i < _records.size() ; i++)
+  {
+    if (match(_records[i].topic, topicStr))
+    {
+      if(_records[i].callback != NULL)
+        _records[i].callback(payloadStr); // Call the callback
+      if(_records[i].callbackWithTopic != NULL)
+        _records[i].callbackWithTopic(topicStr, payloadStr); // Call the callback
+      if(_records[i].streamCallback != NULL)
+      {
+        StreamString stream;
+        stream.print(payloadStr);
+        _records[i].streamCallback(topicStr, stream, payloadStr.length());
+      }
+    }
+  }
+}
+
+/**
+ * Matching MQTT topics, handling the eventual presence of a single wildcard character
+ *
+ * @param topic1 is the topic may contain a wildcard
+ * @param topic2 must not contain wildcards
+ * @return true on MQTT topic match, false otherwise
+ */
+bool TopicSubscriptionList::match(const String &topic1, const String &topic2)
+{
+  int i = 0;
+
+  if((i = topic1.indexOf('#')) >= 0)
+  {
+    String t1a = topic1.substring(0, i);
+    String t1b = topic1.substring(i+1);
+    if((t1a.length() == 0 || topic2.startsWith(t1a)) &&
+       (t1b.length() == 0 || topic2.endsWith(t1b)))
+      return true;
+  }
+  else if((i = topic1.indexOf('+')) >= 0)
+  {
+    String t1a = topic1.substring(0, i);
+    String t1b = topic1.substring(i+1);
+
+    if((t1a.length() == 0 || topic2.startsWith(t1a))&&
+       (t1b.length() == 0 || topic2.endsWith(t1b)))
+    {
+      if(topic2.substring(t1a.length(), topic2.length()-t1b.length()).indexOf('/') == -1)
+        return true;
+    }
+  }
+  else
+  {
+    return topic1.equals(topic2);
+  }
+
+  return false;
+}
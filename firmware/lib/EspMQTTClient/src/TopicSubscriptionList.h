@@ -0,0 +1,46 @@
+#ifndef TOPIC_SUBSCRIPTION_LIST_H
+#define TOPIC_SUBSCRIPTION_LIST_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+typedef std::function<void(const String &message)> MessageReceivedCallback;
+typedef std::function<void(const String &topicStr, const String &message)> MessageReceivedCallbackWithTopic;
+typedef std::function<void(const String &topicStr, Stream &payload, uint32_t length)> MessageStreamedCallback;
+
+// The subscriptions of an EspMQTTClient, one record per topic filter. A record
+// holds the callback of the last subscribe() of its topic only, subscribing
+// again (e.g. after a reconnect) replaces it instead of adding a second one.
+class TopicSubscriptionList
+{
+public:
+  struct Record
+  {
+    String topic;
+    MessageReceivedCallback callback;
+    MessageReceivedCallbackWithTopic callbackWithTopic;
+    MessageStreamedCallback streamCallback;
+  };
+
+private:
+  std::vector<Record> _records;
+
+  int find(const String &topic) const;
+
+public:
+  void set(const Record &record); // Replaces the record of the same topic, adds it otherwise
+  bool remove(const String &topic); // Return true if the topic had a record
+  inline bool contains(const String &topic) const { return find(topic) >= 0; };
+  inline std::size_t size() const { return _records.size(); };
+  inline const Record& operator[](std::size_t index) const { return _records[index]; };
+
+  // The stream callback that takes a message on topicStr as it is read, NULL when
+  // the topic has none or another subscription needs the payload as a String
+  MessageStreamedCallback streamSubscriber(const String &topicStr) const;
+  void dispatch(const String &topicStr, const String &payloadStr) const; // Calls the callbacks of every matching record
+
+  static bool match(const String &topic1, const String &topic2); // topic1 may contain a wildcard, topic2 must not
+};
+
+#endif
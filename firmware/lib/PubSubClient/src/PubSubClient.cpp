@@ -193,21 +193,26 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
             }
         }
 
+        _sessionPresent = false;
+        _topicAliasMaximum = 0;
+        _reasonCode = 0;
+        _inflightCount = 0;
         if (result == 1) {
             nextMsgId = 1;
             // Leave room in the buffer for header and variable length field
             uint16_t length = MQTT_MAX_HEADER_SIZE;
             unsigned int j;
 
-#if MQTT_VERSION == MQTT_VERSION_3_1
-            uint8_t d[9] = {0x00,0x06,'M','Q','I','s','d','p', MQTT_VERSION};
-#define MQTT_HEADER_VERSION_LENGTH 9
-#elif MQTT_VERSION == MQTT_VERSION_3_1_1
-            uint8_t d[7] = {0x00,0x04,'M','Q','T','T',MQTT_VERSION};
-#define MQTT_HEADER_VERSION_LENGTH 7
-#endif
-            for (j = 0;j<MQTT_HEADER_VERSION_LENGTH;j++) {
-                this->buffer[length++] = d[j];
+            if (_protocolVersion == MQTT_VERSION_3_1) {
+                const uint8_t d[9] = {0x00,0x06,'M','Q','I','s','d','p',MQTT_VERSION_3_1};
+                for (j = 0;j<sizeof(d);j++) {
+                    this->buffer[length++] = d[j];
+                }
+            } else {
+                const uint8_t d[7] = {0x00,0x04,'M','Q','T','T',_protocolVersion};
+                for (j = 0;j<sizeof(d);j++) {
+                    this->buffer[length++] = d[j];
+                }
             }
 
             uint8_t v;
@@ -232,9 +237,41 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
             this->buffer[length++] = ((this->keepAlive) >> 8);
             this->buffer[length++] = ((this->keepAlive) & 0xFF);
 
+            if (_protocolVersion == MQTT_VERSION_5) {
+                // the properties always fit into a single byte length
+                uint16_t start = length++;
+                if (!cleanSession && _sessionExpiry) {
+                    this->buffer[length++] = MQTTPROP_SESSION_EXPIRY_INTERVAL;
+                    this->buffer[length++] = (_sessionExpiry >> 24);
+                    this->buffer[length++] = (_sessionExpiry >> 16) & 0xFF;
+                    this->buffer[length++] = (_sessionExpiry >> 8) & 0xFF;
+                    this->buffer[length++] = (_sessionExpiry & 0xFF);
+                }
+                // the broker drops packets that do not fit instead of
+                // sending them for readPacket to throw away, one byte is
+                // left for callbacks that terminate the payload in place.
+                // With a stream callback larger packets are read, the
+                // limit is the one set for them.
+                uint32_t maximumPacketSize = this->bufferSize - 1;
+                if (this->streamCallback) {
+                    maximumPacketSize = _maximumPacketSize;
+                }
+                if (maximumPacketSize) {
+                    this->buffer[length++] = MQTTPROP_MAXIMUM_PACKET_SIZE;
+                    this->buffer[length++] = (maximumPacketSize >> 24);
+                    this->buffer[length++] = (maximumPacketSize >> 16) & 0xFF;
+                    this->buffer[length++] = (maximumPacketSize >> 8) & 0xFF;
+                    this->buffer[length++] = (maximumPacketSize & 0xFF);
+                }
+                this->buffer[start] = length-start-1;
+            }
+
             CHECK_STRING_LENGTH(length,id)
             length = writeString(id,this->buffer,length);
             if (willTopic) {
+                if (_protocolVersion == MQTT_VERSION_5) {
+                    this->buffer[length++] = 0; // no will properties
+                }
                 CHECK_STRING_LENGTH(length,willTopic)
                 length = writeString(willTopic,this->buffer,length);
                 CHECK_STRING_LENGTH(length,willMessage)
@@ -265,14 +302,21 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
             uint8_t llen;
             uint32_t len = readPacket(&llen);
 
-            if (len == 4) {
-                if (buffer[3] == 0) {
+            // flags and return code, MQTT 5 adds properties behind them
+            if ((buffer[0]&0xF0) == MQTTCONNACK && len >= llen+3u) {
+                uint8_t code = buffer[llen+2];
+                _reasonCode = code;
+                if (code == 0) {
+                    if (_protocolVersion == MQTT_VERSION_5) {
+                        readConnackProperties(llen+3, len);
+                    }
                     lastInActivity = millis();
                     pingOutstanding = false;
+                    _sessionPresent = (buffer[llen+1] & 0x01);
                     _state = MQTT_CONNECTED;
                     return true;
                 } else {
-                    _state = buffer[3];
+                    _state = code;
                 }
             }
             _client->stop();
@@ -318,6 +362,10 @@ uint32_t PubSubClient::readPacket(uint8_t* lengthLength) {
     uint8_t digit = 0;
     uint16_t skip = 0;
     uint32_t start = 0;
+    // MQTT 5 publish properties, their length is decoded on the way
+    bool readingProperties = isPublish && _protocolVersion == MQTT_VERSION_5;
+    uint32_t propertiesLength = 0;
+    uint32_t propertiesMultiplier = 1;
 
     do {
         if (len == 5) {
@@ -338,6 +386,10 @@ uint32_t PubSubClient::readPacket(uint8_t* lengthLength) {
         if(!readByte(this->buffer, &len)) return 0;
         if(!readByte(this->buffer, &len)) return 0;
         skip = (this->buffer[*lengthLength+1]<<8)+this->buffer[*lengthLength+2];
+        // streamed unless a byte is left behind the payload, see setStreamCallback()
+        if (this->streamCallback && 1 + *lengthLength + length >= this->bufferSize) {
+            return readPublishStream(*lengthLength, length);
+        }
         start = 2;
         if (this->buffer[0]&MQTTQOS1) {
             // skip message id
@@ -348,7 +400,15 @@ uint32_t PubSubClient::readPacket(uint8_t* lengthLength) {
 
     for (uint32_t i = start;i<length;i++) {
         if(!readByte(&digit)) return 0;
-        if (this->stream) {
+        if (readingProperties && idx-*lengthLength-2>skip) {
+            propertiesLength += (digit & 127) * propertiesMultiplier;
+            propertiesMultiplier <<= 7;
+            skip++;
+            if ((digit & 128) == 0) {
+                skip += propertiesLength;
+                readingProperties = false;
+            }
+        } else if (this->stream) {
             if (isPublish && idx-*lengthLength-2>skip) {
                 this->stream->write(digit);
             }
@@ -367,6 +427,79 @@ uint32_t PubSubClient::readPacket(uint8_t* lengthLength) {
     return len;
 }
 
+// Reads a PUBLISH that does not fit into the buffer, the fixed header and the
+// topic length are already in it. Hands the payload to the stream callback
+// and returns 0 as the packet is done.
+uint32_t PubSubClient::readPublishStream(uint8_t lengthLength, uint32_t length) {
+    uint16_t tl = (this->buffer[lengthLength+1]<<8)+this->buffer[lengthLength+2];
+    uint16_t pos = lengthLength+3;
+    boolean qos1 = (this->buffer[0]&0x06) == MQTTQOS1;
+    // a topic that does not fit is read but not delivered
+    boolean fits = pos + tl < this->bufferSize;
+    uint32_t consumed = 2 + tl;
+    uint16_t msgId = 0;
+    uint8_t digit;
+    boolean complete = true;
+
+    for (uint16_t i = 0; i < tl && complete; i++) {
+        complete = readByte(&digit);
+        if (fits) {
+            this->buffer[pos+i] = digit;
+        }
+    }
+    if (qos1) {
+        for (uint8_t i = 0; i < 2 && complete; i++) {
+            complete = readByte(&digit);
+            msgId = (msgId << 8) + digit;
+        }
+        consumed += 2;
+    }
+    if (_protocolVersion == MQTT_VERSION_5) {
+        uint32_t propertiesLength = 0;
+        uint32_t multiplier = 1;
+        do {
+            complete = complete && multiplier <= 128*128*128 && readByte(&digit);
+            propertiesLength += (digit & 127) * multiplier;
+            multiplier <<= 7;
+            consumed++;
+        } while (complete && (digit & 128) != 0);
+        for (uint32_t i = 0; i < propertiesLength && complete; i++) {
+            complete = readByte(&digit);
+        }
+        consumed += propertiesLength;
+    }
+
+    if (complete && consumed <= length) {
+        PubSubPayloadStream payload(_client, length - consumed, this->socketTimeout*1000UL);
+        if (fits) {
+            this->buffer[pos+tl] = 0;
+            streamCallback((char*)this->buffer+pos, payload, length - consumed);
+        }
+        while (complete && payload.remaining()) {
+            complete = payload.read() >= 0;
+        }
+    } else {
+        complete = false;
+    }
+    if (!complete) {
+        // timed out or malformed, the connection is out of step
+        _state = MQTT_DISCONNECTED;
+        _client->stop();
+        return 0;
+    }
+
+    lastInActivity = millis();
+    if (qos1) {
+        this->buffer[0] = MQTTPUBACK;
+        this->buffer[1] = 2;
+        this->buffer[2] = (msgId >> 8);
+        this->buffer[3] = (msgId & 0xFF);
+        _client->write(this->buffer,4);
+        lastOutActivity = lastInActivity;
+    }
+    return 0;
+}
+
 boolean PubSubClient::loop() {
     if (connected()) {
         unsigned long t = millis();
@@ -398,24 +531,55 @@ boolean PubSubClient::loop() {
                         memmove(this->buffer+llen+2,this->buffer+llen+3,tl); /* move topic inside buffer 1 byte to front */
                         this->buffer[llen+2+tl] = 0; /* end the topic as a 'C' string with \x00 */
                         char *topic = (char*) this->buffer+llen+2;
+                        uint16_t pos = llen+3+tl;
+                        boolean qos1 = (this->buffer[0]&0x06) == MQTTQOS1;
                         // msgId only present for QOS>0
-                        if ((this->buffer[0]&0x06) == MQTTQOS1) {
-                            msgId = (this->buffer[llen+3+tl]<<8)+this->buffer[llen+3+tl+1];
-                            payload = this->buffer+llen+3+tl+2;
-                            callback(topic,payload,len-llen-3-tl-2);
-
+                        if (qos1) {
+                            msgId = (this->buffer[pos]<<8)+this->buffer[pos+1];
+                            pos += 2;
+                        }
+                        if (_protocolVersion == MQTT_VERSION_5 && !skipProperties(&pos, len)) {
+                            // malformed, dropped like a packet that is too large
+                            return true;
+                        }
+                        payload = this->buffer+pos;
+                        callback(topic,payload,len-pos);
+                        if (qos1) {
                             this->buffer[0] = MQTTPUBACK;
                             this->buffer[1] = 2;
                             this->buffer[2] = (msgId >> 8);
                             this->buffer[3] = (msgId & 0xFF);
                             _client->write(this->buffer,4);
                             lastOutActivity = t;
-
-                        } else {
-                            payload = this->buffer+llen+3+tl;
-                            callback(topic,payload,len-llen-3-tl);
                         }
                     }
+                } else if (type == MQTTPUBACK) {
+                    msgId = (this->buffer[llen+1]<<8)+this->buffer[llen+2];
+                    // MQTT 5 may add a reason code, no reason code is success
+                    _reasonCode = len > llen+3u ? this->buffer[llen+3] : 0;
+                    for (uint8_t i = 0; i < _inflightCount; i++) {
+                        if (_inflight[i] == msgId) {
+                            _inflight[i] = _inflight[--_inflightCount];
+                            if (pubackCallback) {
+                                pubackCallback(msgId);
+                            }
+                            break;
+                        }
+                    }
+                } else if (type == MQTTSUBACK) {
+                    // return code of the first topic, behind packet id and MQTT 5 properties
+                    uint16_t pos = llen+3;
+                    if (_protocolVersion != MQTT_VERSION_5 || skipProperties(&pos, len)) {
+                        if (pos < len) {
+                            _reasonCode = this->buffer[pos];
+                        }
+                    }
+                } else if (type == MQTTDISCONNECT) {
+                    // only MQTT 5 brokers say goodbye, with a reason code
+                    _reasonCode = len > llen+1u ? this->buffer[llen+1] : 0;
+                    _state = MQTT_DISCONNECTED;
+                    _client->stop();
+                    return false;
                 } else if (type == MQTTPINGREQ) {
                     this->buffer[0] = MQTTPINGRESP;
                     this->buffer[1] = 0;
@@ -446,14 +610,69 @@ boolean PubSubClient::publish(const char* topic, const uint8_t* payload, unsigne
 }
 
 boolean PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int plength, boolean retained) {
+    return publish(topic, payload, plength, retained, 0);
+}
+
+boolean PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int plength, boolean retained, uint16_t topicAlias) {
+    return publishPacket(topic, payload, plength, retained, 0, topicAlias);
+}
+
+boolean PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int plength, boolean retained, uint8_t qos, uint16_t* msgId) {
+    if (qos == 0) {
+        return publishPacket(topic, payload, plength, retained, 0, 0);
+    }
+    if (qos > 1 || _inflightCount >= _maxInflight) {
+        return false;
+    }
+    nextMsgId++;
+    if (nextMsgId == 0) {
+        nextMsgId = 1;
+    }
+    if (!publishPacket(topic, payload, plength, retained, nextMsgId, 0)) {
+        return false;
+    }
+    _inflight[_inflightCount++] = nextMsgId;
+    if (msgId) {
+        *msgId = nextMsgId;
+    }
+    return true;
+}
+
+// msgId is 0 for QoS 0
+boolean PubSubClient::publishPacket(const char* topic, const uint8_t* payload, unsigned int plength, boolean retained, uint16_t msgId, uint16_t topicAlias) {
     if (connected()) {
-        if (this->bufferSize < MQTT_MAX_HEADER_SIZE + 2+strnlen(topic, this->bufferSize) + plength) {
+        if (topicAlias && (_protocolVersion != MQTT_VERSION_5 || topicAlias > _topicAliasMaximum)) {
+            return false;
+        }
+        size_t topicLength = strnlen(topic, this->bufferSize);
+        if (topicLength == 0 && !topicAlias) {
+            return false;
+        }
+        unsigned int propertiesLength = 0;
+        if (_protocolVersion == MQTT_VERSION_5) {
+            propertiesLength = topicAlias ? 4 : 1;
+        }
+        if (this->bufferSize < MQTT_MAX_HEADER_SIZE + 2+topicLength + (msgId ? 2 : 0) + propertiesLength + plength) {
             // Too long
             return false;
         }
         // Leave room in the buffer for header and variable length field
         uint16_t length = MQTT_MAX_HEADER_SIZE;
         length = writeString(topic,this->buffer,length);
+        if (msgId) {
+            this->buffer[length++] = (msgId >> 8);
+            this->buffer[length++] = (msgId & 0xFF);
+        }
+        if (_protocolVersion == MQTT_VERSION_5) {
+            if (topicAlias) {
+                this->buffer[length++] = 3;
+                this->buffer[length++] = MQTTPROP_TOPIC_ALIAS;
+                this->buffer[length++] = (topicAlias >> 8);
+                this->buffer[length++] = (topicAlias & 0xFF);
+            } else {
+                this->buffer[length++] = 0;
+            }
+        }
 
         // Add payload
         uint16_t i;
@@ -463,6 +682,9 @@ boolean PubSubClient::publish(const char* topic, const uint8_t* payload, unsigne
 
         // Write the header
         uint8_t header = MQTTPUBLISH;
+        if (msgId) {
+            header |= MQTTQOS1;
+        }
         if (retained) {
             header |= 1;
         }
@@ -498,6 +720,9 @@ boolean PubSubClient::publish_P(const char* topic, const uint8_t* payload, unsig
     }
     this->buffer[pos++] = header;
     len = plength + 2 + tlen;
+    if (_protocolVersion == MQTT_VERSION_5) {
+        len++;
+    }
     do {
         digit = len  & 127; //digit = len %128
         len >>= 7; //len = len / 128
@@ -509,6 +734,9 @@ boolean PubSubClient::publish_P(const char* topic, const uint8_t* payload, unsig
     } while(len>0);
 
     pos = writeString(topic,this->buffer,pos);
+    if (_protocolVersion == MQTT_VERSION_5) {
+        this->buffer[pos++] = 0; // no properties
+    }
 
     rc += _client->write(this->buffer,pos);
 
@@ -518,7 +746,7 @@ boolean PubSubClient::publish_P(const char* topic, const uint8_t* payload, unsig
 
     lastOutActivity = millis();
 
-    expectedLength = 1 + llen + 2 + tlen + plength;
+    expectedLength = pos + plength;
 
     return (rc == expectedLength);
 }
@@ -528,6 +756,9 @@ boolean PubSubClient::beginPublish(const char* topic, unsigned int plength, bool
         // Send the header and variable length field
         uint16_t length = MQTT_MAX_HEADER_SIZE;
         length = writeString(topic,this->buffer,length);
+        if (_protocolVersion == MQTT_VERSION_5) {
+            this->buffer[length++] = 0; // no properties
+        }
         uint8_t header = MQTTPUBLISH;
         if (retained) {
             header |= 1;
@@ -614,7 +845,7 @@ boolean PubSubClient::subscribe(const char* topic, uint8_t qos) {
     if (qos > 1) {
         return false;
     }
-    if (this->bufferSize < 9 + topicLength) {
+    if (this->bufferSize < 9 + (_protocolVersion == MQTT_VERSION_5) + topicLength) {
         // Too long
         return false;
     }
@@ -627,6 +858,9 @@ boolean PubSubClient::subscribe(const char* topic, uint8_t qos) {
         }
         this->buffer[length++] = (nextMsgId >> 8);
         this->buffer[length++] = (nextMsgId & 0xFF);
+        if (_protocolVersion == MQTT_VERSION_5) {
+            this->buffer[length++] = 0; // no properties
+        }
         length = writeString((char*)topic, this->buffer,length);
         this->buffer[length++] = qos;
         return write(MQTTSUBSCRIBE|MQTTQOS1,this->buffer,length-MQTT_MAX_HEADER_SIZE);
@@ -639,7 +873,7 @@ boolean PubSubClient::unsubscribe(const char* topic) {
     if (topic == 0) {
         return false;
     }
-    if (this->bufferSize < 9 + topicLength) {
+    if (this->bufferSize < 9 + (_protocolVersion == MQTT_VERSION_5) + topicLength) {
         // Too long
         return false;
     }
@@ -651,6 +885,9 @@ boolean PubSubClient::unsubscribe(const char* topic) {
         }
         this->buffer[length++] = (nextMsgId >> 8);
         this->buffer[length++] = (nextMsgId & 0xFF);
+        if (_protocolVersion == MQTT_VERSION_5) {
+            this->buffer[length++] = 0; // no properties
+        }
         length = writeString(topic, this->buffer,length);
         return write(MQTTUNSUBSCRIBE|MQTTQOS1,this->buffer,length-MQTT_MAX_HEADER_SIZE);
     }
@@ -667,6 +904,78 @@ void PubSubClient::disconnect() {
     lastInActivity = lastOutActivity = millis();
 }
 
+// Moves pos behind the MQTT 5 properties starting at pos,
+// false if they do not fit into the packet
+boolean PubSubClient::skipProperties(uint16_t* pos, uint16_t length) {
+    uint32_t propertiesLength = 0;
+    uint32_t multiplier = 1;
+    uint8_t digit;
+    uint16_t p = *pos;
+    do {
+        if (p >= length || multiplier > 128*128*128) {
+            return false;
+        }
+        digit = this->buffer[p++];
+        propertiesLength += (digit & 127) * multiplier;
+        multiplier <<= 7;
+    } while ((digit & 128) != 0);
+    if (p + propertiesLength > length) {
+        return false;
+    }
+    *pos = p + propertiesLength;
+    return true;
+}
+
+void PubSubClient::readConnackProperties(uint16_t pos, uint16_t length) {
+    uint16_t end = pos;
+    if (!skipProperties(&end, length)) {
+        return;
+    }
+    // the property length is at most 4 bytes and ends with a byte < 128
+    while (this->buffer[pos++] & 128);
+
+    while (pos < end) {
+        uint8_t id = this->buffer[pos++];
+        uint16_t size;
+        switch (id) {
+        // byte
+        case 0x01: case 0x17: case 0x19: case 0x24: case 0x25: case 0x28: case 0x29: case 0x2A:
+            size = 1;
+            break;
+        // two byte integer
+        case 0x13: case 0x21: case MQTTPROP_TOPIC_ALIAS_MAXIMUM: case MQTTPROP_TOPIC_ALIAS:
+            size = 2;
+            break;
+        // four byte integer
+        case 0x02: case MQTTPROP_SESSION_EXPIRY_INTERVAL: case 0x18: case MQTTPROP_MAXIMUM_PACKET_SIZE:
+            size = 4;
+            break;
+        // string or binary data
+        case 0x03: case 0x08: case 0x09: case 0x12: case 0x15: case 0x16: case 0x1A: case 0x1C: case 0x1F:
+            if (pos + 2 > end) return;
+            size = 2 + ((this->buffer[pos]<<8) | this->buffer[pos+1]);
+            break;
+        // string pair
+        case 0x26:
+            if (pos + 2 > end) return;
+            size = 2 + ((this->buffer[pos]<<8) | this->buffer[pos+1]);
+            if (pos + size + 2 > end) return;
+            size += 2 + ((this->buffer[pos+size]<<8) | this->buffer[pos+size+1]);
+            break;
+        default:
+            // unknown, the rest can not be parsed
+            return;
+        }
+        if (pos + size > end) {
+            return;
+        }
+        if (id == MQTTPROP_TOPIC_ALIAS_MAXIMUM) {
+            _topicAliasMaximum = (this->buffer[pos]<<8) | this->buffer[pos+1];
+        }
+        pos += size;
+    }
+}
+
 uint16_t PubSubClient::writeString(const char* string, uint8_t* buf, uint16_t pos) {
     const char* idp = string;
     uint16_t i = 0;
@@ -723,6 +1032,16 @@ PubSubClient& PubSubClient::setCallback(MQTT_CALLBACK_SIGNATURE) {
     return *this;
 }
 
+PubSubClient& PubSubClient::setPublishAckCallback(MQTT_PUBACK_CALLBACK_SIGNATURE) {
+    this->pubackCallback = pubackCallback;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setStreamCallback(MQTT_STREAM_CALLBACK_SIGNATURE) {
+    this->streamCallback = streamCallback;
+    return *this;
+}
+
 PubSubClient& PubSubClient::setClient(Client& client){
     this->_client = &client;
     return *this;
@@ -733,6 +1052,30 @@ PubSubClient& PubSubClient::setStream(Stream& stream){
     return *this;
 }
 
+boolean PubSubClient::sessionPresent() {
+    return this->_sessionPresent;
+}
+
+uint8_t PubSubClient::protocolVersion() {
+    return this->_protocolVersion;
+}
+
+uint8_t PubSubClient::inflight() {
+    return this->_inflightCount;
+}
+
+uint8_t PubSubClient::maxInflight() {
+    return this->_maxInflight;
+}
+
+uint16_t PubSubClient::topicAliasMaximum() {
+    return this->_topicAliasMaximum;
+}
+
+uint8_t PubSubClient::reasonCode() {
+    return this->_reasonCode;
+}
+
 int PubSubClient::state() {
     return this->_state;
 }
@@ -767,3 +1110,90 @@ PubSubClient& PubSubClient::setSocketTimeout(uint16_t timeout) {
     this->socketTimeout = timeout;
     return *this;
 }
+PubSubClient& PubSubClient::setProtocolVersion(uint8_t version) {
+    this->_protocolVersion = version;
+    return *this;
+}
+PubSubClient& PubSubClient::setMaxInflight(uint8_t count) {
+    if (count < 1) {
+        count = 1;
+    } else if (count > MQTT_MAX_INFLIGHT) {
+        count = MQTT_MAX_INFLIGHT;
+    }
+    this->_maxInflight = count;
+    return *this;
+}
+PubSubClient& PubSubClient::setMaximumPacketSize(uint32_t size) {
+    this->_maximumPacketSize = size;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setSessionExpiry(uint32_t seconds) {
+    this->_sessionExpiry = seconds;
+    return *this;
+}
+
+PubSubPayloadStream::PubSubPayloadStream(Client* client, uint32_t length, uint32_t timeout) {
+    this->_client = client;
+    this->_remaining = length;
+    this->_timeout = timeout;
+}
+
+boolean PubSubPayloadStream::waitAvailable() {
+    uint32_t previousMillis = millis();
+    while (!_client->available()) {
+        yield();
+        if (millis() - previousMillis >= _timeout) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t PubSubPayloadStream::remaining() {
+    return this->_remaining;
+}
+
+int PubSubPayloadStream::available() {
+    uint32_t count = _client->available();
+    return count < _remaining ? count : _remaining;
+}
+
+int PubSubPayloadStream::read() {
+    if (_remaining == 0 || !waitAvailable()) {
+        return -1;
+    }
+    _remaining--;
+    return _client->read();
+}
+
+int PubSubPayloadStream::peek() {
+    if (_remaining == 0 || !waitAvailable()) {
+        return -1;
+    }
+    return _client->peek();
+}
+
+int PubSubPayloadStream::read(uint8_t* buf, size_t size) {
+    size_t count = 0;
+    while (count < size && _remaining && waitAvailable()) {
+        size_t chunk = size - count;
+        if (chunk > _remaining) {
+            chunk = _remaining;
+        }
+        int rc = _client->read(buf + count, chunk);
+        if (rc <= 0) {
+            break;
+        }
+        count += rc;
+        _remaining -= rc;
+    }
+    return count;
+}
+
+size_t PubSubPayloadStream::write(uint8_t) {
+    return 0;
+}
+
+void PubSubPayloadStream::flush() {
+}
@@ -14,8 +14,9 @@
 
 #define MQTT_VERSION_3_1      3
 #define MQTT_VERSION_3_1_1    4
+#define MQTT_VERSION_5        5
 
-// MQTT_VERSION : Pick the version
+// MQTT_VERSION : Pick the default version. Override with setProtocolVersion()
 //#define MQTT_VERSION MQTT_VERSION_3_1
 #ifndef MQTT_VERSION
 #define MQTT_VERSION MQTT_VERSION_3_1_1
@@ -36,6 +37,12 @@
 #define MQTT_SOCKET_TIMEOUT 15
 #endif
 
+// MQTT_MAX_INFLIGHT : QoS 1 publishes that may wait for their PUBACK at the
+//  same time. Override with setMaxInflight() up to this value
+#ifndef MQTT_MAX_INFLIGHT
+#define MQTT_MAX_INFLIGHT 8
+#endif
+
 // MQTT_MAX_TRANSFER_SIZE : limit how much data is passed to the network client
 //  in each write call. Needed for the Arduino Wifi Shield. Leave undefined to
 //  pass the entire MQTT packet in each write call.
@@ -52,6 +59,8 @@
 #define MQTT_CONNECT_UNAVAILABLE     3
 #define MQTT_CONNECT_BAD_CREDENTIALS 4
 #define MQTT_CONNECT_UNAUTHORIZED    5
+// MQTT 5 brokers report reason codes >= 0x80 instead, e.g.
+#define MQTT_CONNECT_UNSUPPORTED_PROTOCOL_VERSION 0x84
 
 #define MQTTCONNECT     1 << 4  // Client request to connect to Server
 #define MQTTCONNACK     2 << 4  // Connect Acknowledgment
@@ -73,18 +82,50 @@
 #define MQTTQOS1        (1 << 1)
 #define MQTTQOS2        (2 << 1)
 
+// MQTT 5 properties used by the client
+#define MQTTPROP_SESSION_EXPIRY_INTERVAL 0x11
+#define MQTTPROP_TOPIC_ALIAS_MAXIMUM     0x22
+#define MQTTPROP_TOPIC_ALIAS             0x23
+#define MQTTPROP_MAXIMUM_PACKET_SIZE     0x27
+
 // Maximum size of fixed header and variable length size header
 #define MQTT_MAX_HEADER_SIZE 5
 
 #if defined(ESP8266) || defined(ESP32)
 #include <functional>
 #define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+#define MQTT_PUBACK_CALLBACK_SIGNATURE std::function<void(uint16_t)> pubackCallback
+#define MQTT_STREAM_CALLBACK_SIGNATURE std::function<void(char*, Stream&, uint32_t)> streamCallback
 #else
 #define MQTT_CALLBACK_SIGNATURE void (*callback)(char*, uint8_t*, unsigned int)
+#define MQTT_PUBACK_CALLBACK_SIGNATURE void (*pubackCallback)(uint16_t)
+#define MQTT_STREAM_CALLBACK_SIGNATURE void (*streamCallback)(char*, Stream&, uint32_t)
 #endif
 
 #define CHECK_STRING_LENGTH(l,s) if (l+2+strnlen(s, this->bufferSize) > this->bufferSize) {_client->stop();return false;}
 
+// Payload of a PUBLISH that does not fit into the buffer, read straight
+// from the connection while the stream callback runs
+class PubSubPayloadStream : public Stream {
+private:
+   Client* _client;
+   uint32_t _remaining;
+   uint32_t _timeout;
+   boolean waitAvailable();
+public:
+   PubSubPayloadStream(Client* client, uint32_t length, uint32_t timeout);
+   // payload bytes not read yet
+   uint32_t remaining();
+   virtual int available();
+   // waits up to the socket timeout, -1 at the end of the payload
+   virtual int read();
+   virtual int peek();
+   // reads up to size bytes, fewer at the end of the payload or on a timeout
+   int read(uint8_t* buf, size_t size);
+   virtual size_t write(uint8_t);
+   virtual void flush();
+};
+
 class PubSubClient : public Print {
 private:
    Client* _client;
@@ -97,7 +138,14 @@ private:
    unsigned long lastInActivity;
    bool pingOutstanding;
    MQTT_CALLBACK_SIGNATURE;
+   MQTT_PUBACK_CALLBACK_SIGNATURE = nullptr;
+   MQTT_STREAM_CALLBACK_SIGNATURE = nullptr;
+   // packet ids of QoS 1 publishes waiting for their PUBACK
+   uint16_t _inflight[MQTT_MAX_INFLIGHT];
+   uint8_t _inflightCount = 0;
+   uint8_t _maxInflight = MQTT_MAX_INFLIGHT;
    uint32_t readPacket(uint8_t*);
+   uint32_t readPublishStream(uint8_t lengthLength, uint32_t length);
    boolean readByte(uint8_t * result);
    boolean readByte(uint8_t * result, uint16_t * index);
    boolean write(uint8_t header, uint8_t* buf, uint16_t length);
@@ -107,11 +155,21 @@ private:
    // Note: the header is built at the end of the first MQTT_MAX_HEADER_SIZE bytes, so will start
    //       (MQTT_MAX_HEADER_SIZE - <returned size>) bytes into the buffer
    size_t buildHeader(uint8_t header, uint8_t* buf, uint16_t length);
+   // MQTT 5 properties of a received packet
+   boolean skipProperties(uint16_t* pos, uint16_t length);
+   void readConnackProperties(uint16_t pos, uint16_t length);
+   boolean publishPacket(const char* topic, const uint8_t* payload, unsigned int plength, boolean retained, uint16_t msgId, uint16_t topicAlias);
    IPAddress ip;
    const char* domain;
    uint16_t port;
    Stream* stream;
    int _state;
+   boolean _sessionPresent = false;
+   uint8_t _protocolVersion = MQTT_VERSION;
+   uint32_t _sessionExpiry = 0;
+   uint32_t _maximumPacketSize = 0;
+   uint16_t _topicAliasMaximum = 0;
+   uint8_t _reasonCode = 0;
 public:
    PubSubClient();
    PubSubClient(Client& client);
@@ -134,10 +192,28 @@ public:
    PubSubClient& setServer(uint8_t * ip, uint16_t port);
    PubSubClient& setServer(const char * domain, uint16_t port);
    PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE);
+   // Called with the packet id of a QoS 1 publish when its PUBACK arrives
+   PubSubClient& setPublishAckCallback(MQTT_PUBACK_CALLBACK_SIGNATURE);
+   // Called instead of the callback for a PUBLISH that does not fit into the
+   // buffer, with a stream of its payload and the payload length. Only the
+   // topic has to fit. Bytes left unread are dropped after the call.
+   // Payloads handed to the callback then always have a byte behind them in
+   // the buffer, they can be terminated in place.
+   PubSubClient& setStreamCallback(MQTT_STREAM_CALLBACK_SIGNATURE);
+   // 1 to MQTT_MAX_INFLIGHT QoS 1 publishes waiting for their PUBACK
+   PubSubClient& setMaxInflight(uint8_t count);
    PubSubClient& setClient(Client& client);
    PubSubClient& setStream(Stream& stream);
    PubSubClient& setKeepAlive(uint16_t keepAlive);
    PubSubClient& setSocketTimeout(uint16_t timeout);
+   // MQTT_VERSION_3_1, MQTT_VERSION_3_1_1 or MQTT_VERSION_5, used from the next connect
+   PubSubClient& setProtocolVersion(uint8_t version);
+   // MQTT 5 only: seconds the broker keeps a session of cleanSession = false
+   // after the connection closed, 0 ends it with the connection
+   PubSubClient& setSessionExpiry(uint32_t seconds);
+   // MQTT 5 only: largest packet the broker may send while a stream callback
+   // is set, 0 for no limit. Without one the buffer size is announced.
+   PubSubClient& setMaximumPacketSize(uint32_t size);
 
    boolean setBufferSize(uint16_t size);
    uint16_t getBufferSize();
@@ -152,6 +228,14 @@ public:
    boolean publish(const char* topic, const char* payload, boolean retained);
    boolean publish(const char* topic, const uint8_t * payload, unsigned int plength);
    boolean publish(const char* topic, const uint8_t * payload, unsigned int plength, boolean retained);
+   // MQTT 5 only: publishes with a topic alias between 1 and topicAliasMaximum().
+   // The first publish with an alias assigns it to the topic, later ones may
+   // pass an empty topic. Aliases are forgotten with the connection.
+   boolean publish(const char* topic, const uint8_t * payload, unsigned int plength, boolean retained, uint16_t topicAlias);
+   // Publishes at QoS 0 or 1. A QoS 1 publish stores its packet id in msgId
+   // and fails while the in-flight window is full. Unacknowledged publishes
+   // are forgotten with the connection, resending them is up to the caller.
+   boolean publish(const char* topic, const uint8_t * payload, unsigned int plength, boolean retained, uint8_t qos, uint16_t* msgId);
    boolean publish_P(const char* topic, const char* payload, boolean retained);
    boolean publish_P(const char* topic, const uint8_t * payload, unsigned int plength, boolean retained);
    // Start to publish a message.
@@ -177,6 +261,18 @@ public:
    boolean loop();
    boolean connected();
    int state();
+   // Session present flag of the last CONNACK, true if the broker resumed
+   // a session started with cleanSession = false
+   boolean sessionPresent();
+   uint8_t protocolVersion();
+   // QoS 1 publishes still waiting for their PUBACK
+   uint8_t inflight();
+   uint8_t maxInflight();
+   // MQTT 5 only: highest topic alias the broker accepts, 0 if it takes none
+   uint16_t topicAliasMaximum();
+   // MQTT 5 only: reason code of the last CONNACK, SUBACK or DISCONNECT
+   // from the broker
+   uint8_t reasonCode();
 
 };
 
@@ -11,6 +11,10 @@ void callback(char* topic, byte* payload, unsigned int length) {
   // handle message arrived
 }
 
+void streamCallback(char* topic, Stream& payload, uint32_t length) {
+  // handle streamed message arrived
+}
+
 
 int test_connect_fails_no_network() {
     IT("fails to connect if underlying client doesn't connect");
@@ -121,6 +125,53 @@ int test_connect_non_clean_session() {
 
     state = client.state();
     IS_TRUE(state == MQTT_CONNECTED);
+    IS_FALSE(client.sessionPresent());
+
+    END_IT
+}
+
+int test_connect_session_present() {
+    IT("reports a session resumed by the broker");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    byte expectServer[] = { 172, 16, 0, 2 };
+    shimClient.expectConnect(expectServer,1883);
+    byte connect[] = {0x10,0x18,0x0,0x4,0x4d,0x51,0x54,0x54,0x4,0x0,0x0,0xf,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31};
+    byte connack[] = { 0x20, 0x02, 0x01, 0x00 };
+
+    shimClient.expect(connect,26);
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    IS_FALSE(client.sessionPresent());
+
+    int rc = client.connect((char*)"client_test1",0,0,0,0,0,0,0);
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+    IS_TRUE(client.sessionPresent());
+
+    END_IT
+}
+
+int test_connect_session_present_cleared_on_failure() {
+    IT("clears the session present flag when a connect fails");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    byte connack[] = { 0x20, 0x02, 0x01, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.connect((char*)"client_test1",0,0,0,0,0,0,0);
+    IS_TRUE(rc);
+    IS_TRUE(client.sessionPresent());
+
+    client.disconnect();
+    shimClient.setAllowConnect(false);
+    rc = client.connect((char*)"client_test1",0,0,0,0,0,0,0);
+    IS_FALSE(rc);
+    IS_FALSE(client.sessionPresent());
 
     END_IT
 }
@@ -312,6 +363,149 @@ int test_connect_custom_keepalive() {
 }
 
 
+int test_connect_v5_properly_formatted() {
+    IT("sends a properly formatted MQTT 5 connect packet");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    byte connect[] = {0x10,0x1e,0x0,0x4,0x4d,0x51,0x54,0x54,0x5,0x2,0x0,0xf,0x5,0x27,0x0,0x0,0x0,0xff,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31};
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+
+    shimClient.expect(connect,32);
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+    IS_TRUE(client.state() == MQTT_CONNECTED);
+    IS_TRUE(client.topicAliasMaximum() == 0);
+
+    END_IT
+}
+
+int test_connect_v5_stream_maximum_packet_size() {
+    IT("announces the streamed maximum packet size with a stream callback");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    byte connect[] = {0x10,0x1e,0x0,0x4,0x4d,0x51,0x54,0x54,0x5,0x2,0x0,0xf,0x5,0x27,0x0,0x1,0x23,0x45,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31};
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+
+    shimClient.expect(connect,32);
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setStreamCallback(streamCallback);
+    client.setMaximumPacketSize(0x12345);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_connect_v5_stream_no_maximum_packet_size() {
+    IT("announces no maximum packet size with a stream callback and no limit");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    byte connect[] = {0x10,0x19,0x0,0x4,0x4d,0x51,0x54,0x54,0x5,0x2,0x0,0xf,0x0,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31};
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+
+    shimClient.expect(connect,27);
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setStreamCallback(streamCallback);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_connect_v5_session_expiry() {
+    IT("sends the MQTT 5 session expiry for a non-clean session");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    byte connect[] = {0x10,0x23,0x0,0x4,0x4d,0x51,0x54,0x54,0x5,0x0,0x0,0xf,0xa,0x11,0x0,0x0,0xe,0x10,0x27,0x0,0x0,0x0,0xff,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31};
+    byte connack[] = { 0x20, 0x03, 0x01, 0x00, 0x00 };
+
+    shimClient.expect(connect,37);
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    client.setSessionExpiry(3600);
+    int rc = client.connect((char*)"client_test1",0,0,0,0,0,0,0);
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+    IS_TRUE(client.sessionPresent());
+
+    END_IT
+}
+
+int test_connect_v5_connack_properties() {
+    IT("reads the topic alias maximum from the MQTT 5 connack properties");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    // assigned client identifier "ab", then a topic alias maximum of 10
+    byte connack[] = { 0x20, 0x0b, 0x00, 0x00, 0x08, 0x12, 0x00, 0x02, 0x61, 0x62, 0x22, 0x00, 0x0a };
+    shimClient.respond(connack,13);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+    IS_TRUE(client.topicAliasMaximum() == 10);
+
+    END_IT
+}
+
+int test_connect_v5_fails_on_reason_code() {
+    IT("fails to connect with the MQTT 5 reason code of the connack");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    byte connack[] = { 0x20, 0x03, 0x00, 0x84, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_FALSE(rc);
+    IS_TRUE(client.state() == MQTT_CONNECT_UNSUPPORTED_PROTOCOL_VERSION);
+    IS_TRUE(client.reasonCode() == 0x84);
+
+    END_IT
+}
+
+int test_connect_v5_with_will() {
+    IT("sends empty MQTT 5 will properties");
+    ShimClient shimClient;
+
+    shimClient.setAllowConnect(true);
+    byte connect[] = {0x10,0x2c,0x0,0x4,0x4d,0x51,0x54,0x54,0x5,0xe,0x0,0xf,0x5,0x27,0x0,0x0,0x0,0xff,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31,0x0,0x0,0x9,0x77,0x69,0x6c,0x6c,0x54,0x6f,0x70,0x69,0x63,0x0,0x0};
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+
+    shimClient.expect(connect,46);
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1",(char*)"willTopic",1,0,(char*)"");
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
 int main()
 {
     SUITE("Connect");
@@ -321,6 +515,8 @@ int main()
 
     test_connect_properly_formatted();
     test_connect_non_clean_session();
+    test_connect_session_present();
+    test_connect_session_present_cleared_on_failure();
     test_connect_accepts_username_password();
     test_connect_fails_on_bad_rc();
     test_connect_properly_formatted_hostname();
@@ -332,5 +528,12 @@ int main()
     test_connect_disconnect_connect();
 
     test_connect_custom_keepalive();
+    test_connect_v5_properly_formatted();
+    test_connect_v5_stream_maximum_packet_size();
+    test_connect_v5_stream_no_maximum_packet_size();
+    test_connect_v5_session_expiry();
+    test_connect_v5_connack_properties();
+    test_connect_v5_fails_on_reason_code();
+    test_connect_v5_with_will();
     FINISH
 }
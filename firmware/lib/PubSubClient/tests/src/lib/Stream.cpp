@@ -26,6 +26,18 @@ size_t Stream::write(uint8_t b)  {
 }
 
 
+int Stream::available() {
+    return 0;
+}
+
+int Stream::read() {
+    return -1;
+}
+
+int Stream::peek() {
+    return -1;
+}
+
 bool Stream::error() {
     return this->_error;
 }
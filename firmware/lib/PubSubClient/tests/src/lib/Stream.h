@@ -13,6 +13,9 @@ private:
 public:
     Stream();
     virtual size_t write(uint8_t);
+    virtual int available();
+    virtual int read();
+    virtual int peek();
     
     virtual bool error();
     virtual void expect(uint8_t *buf, size_t size);
@@ -176,6 +176,280 @@ int test_publish_P() {
 
 
 
+int test_publish_v5() {
+    IT("publishes with empty MQTT 5 properties");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x30,0xf,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.expect(publish,17);
+
+    rc = client.publish((char*)"topic",(char*)"payload");
+    IS_TRUE(rc);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_publish_v5_topic_alias() {
+    IT("publishes with an MQTT 5 topic alias");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x06, 0x00, 0x00, 0x03, 0x22, 0x00, 0x02 };
+    shimClient.respond(connack,8);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    // the first publish assigns the alias
+    byte assign[] = {0x30,0x12,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x3,0x23,0x0,0x1,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.expect(assign,20);
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,1);
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+
+    // later ones leave the topic empty
+    byte aliased[] = {0x30,0xd,0x0,0x0,0x3,0x23,0x0,0x1,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.expect(aliased,15);
+    rc = client.publish((char*)"",(const uint8_t*)"payload",7,false,1);
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_publish_topic_alias_rejected() {
+    IT("rejects topic aliases the broker does not accept");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x06, 0x00, 0x00, 0x03, 0x22, 0x00, 0x02 };
+    shimClient.respond(connack,8);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,3);
+    IS_FALSE(rc);
+    // an empty topic needs an alias
+    rc = client.publish((char*)"",(const uint8_t*)"payload",7,false,0);
+    IS_FALSE(rc);
+
+    ShimClient shimClient311;
+    shimClient311.setAllowConnect(true);
+    byte connack311[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient311.respond(connack311,4);
+
+    PubSubClient client311(server, 1883, callback, shimClient311);
+    rc = client311.connect((char*)"client_test1");
+    IS_TRUE(rc);
+    rc = client311.publish((char*)"topic",(const uint8_t*)"payload",7,false,1);
+    IS_FALSE(rc);
+
+    IS_FALSE(shimClient.error());
+    IS_FALSE(shimClient311.error());
+
+    END_IT
+}
+
+int test_publish_P_v5() {
+    IT("publishes using PROGMEM with empty MQTT 5 properties");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte payload[] = { 0x01,0x02,0x03,0x0,0x05 };
+    int length = 5;
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x31,0xd,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x1,0x2,0x3,0x0,0x5};
+    shimClient.expect(publish,15);
+
+    rc = client.publish_P((char*)"topic",payload,length,true);
+    IS_TRUE(rc);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+uint16_t lastAckedMsgId = 0;
+int ackCount = 0;
+
+void pubackCallback(uint16_t msgId) {
+    lastAckedMsgId = msgId;
+    ackCount++;
+}
+
+int test_publish_qos1() {
+    IT("publishes qos 1 and releases it on puback");
+    lastAckedMsgId = 0;
+    ackCount = 0;
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setPublishAckCallback(pubackCallback);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x32,0x10,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x2,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.expect(publish,18);
+
+    uint16_t msgId = 0;
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,1,&msgId);
+    IS_TRUE(rc);
+    IS_TRUE(msgId == 2);
+    IS_TRUE(client.inflight() == 1);
+    IS_FALSE(shimClient.error());
+
+    byte puback[] = {0x40,0x2,0x0,0x2};
+    shimClient.respond(puback,4);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(client.inflight() == 0);
+    IS_TRUE(ackCount == 1);
+    IS_TRUE(lastAckedMsgId == 2);
+
+    // a repeated puback is ignored
+    shimClient.respond(puback,4);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(ackCount == 1);
+
+    END_IT
+}
+
+int test_publish_qos1_window() {
+    IT("pipelines qos 1 publishes up to the in-flight window");
+    lastAckedMsgId = 0;
+    ackCount = 0;
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setPublishAckCallback(pubackCallback);
+    client.setMaxInflight(2);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    uint16_t first = 0, second = 0, third = 0;
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,1,&first);
+    IS_TRUE(rc);
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,1,&second);
+    IS_TRUE(rc);
+    IS_TRUE(first != second);
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,1,&third);
+    IS_FALSE(rc);
+    IS_TRUE(client.inflight() == 2);
+
+    // qos 0 does not take part in the window
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,0,NULL);
+    IS_TRUE(rc);
+
+    // acknowledged out of order
+    byte puback[] = {0x40,0x2,(byte)(second >> 8),(byte)(second & 0xFF)};
+    shimClient.respond(puback,4);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(lastAckedMsgId == second);
+    IS_TRUE(client.inflight() == 1);
+
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,1,&third);
+    IS_TRUE(rc);
+    IS_TRUE(client.inflight() == 2);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_publish_qos1_cleared_on_connect() {
+    IT("forgets unacknowledged qos 1 publishes with the connection");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    uint16_t msgId = 0;
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,1,&msgId);
+    IS_TRUE(rc);
+    IS_TRUE(client.inflight() == 1);
+
+    client.disconnect();
+    shimClient.respond(connack,4);
+    rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+    IS_TRUE(client.inflight() == 0);
+
+    END_IT
+}
+
+int test_publish_qos1_v5() {
+    IT("publishes qos 1 with MQTT 5 properties behind the packet id");
+    lastAckedMsgId = 0;
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    client.setPublishAckCallback(pubackCallback);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x32,0x11,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x2,0x0,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.expect(publish,19);
+
+    uint16_t msgId = 0;
+    rc = client.publish((char*)"topic",(const uint8_t*)"payload",7,false,1,&msgId);
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+
+    // no matching subscribers
+    byte puback[] = {0x40,0x3,0x0,0x2,0x10};
+    shimClient.respond(puback,5);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(lastAckedMsgId == 2);
+    IS_TRUE(client.reasonCode() == 0x10);
+
+    END_IT
+}
+
 int main()
 {
     SUITE("Publish");
@@ -186,6 +460,14 @@ int main()
     test_publish_not_connected();
     test_publish_too_long();
     test_publish_P();
+    test_publish_v5();
+    test_publish_v5_topic_alias();
+    test_publish_topic_alias_rejected();
+    test_publish_P_v5();
+    test_publish_qos1();
+    test_publish_qos1_window();
+    test_publish_qos1_cleared_on_connect();
+    test_publish_qos1_v5();
 
     FINISH
 }
@@ -324,6 +324,329 @@ int test_receive_qos1() {
     END_IT
 }
 
+int test_receive_v5_properties() {
+    IT("receives an MQTT 5 message with properties");
+    reset_callback();
+
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    // payload format indicator
+    byte publish[] = {0x30,0x11,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x2,0x1,0x1,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.respond(publish,19);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+
+    IS_TRUE(callback_called);
+    IS_TRUE(strcmp(lastTopic,"topic")==0);
+    IS_TRUE(memcmp(lastPayload,"payload",7)==0);
+    IS_TRUE(lastLength == 7);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_receive_v5_qos1() {
+    IT("receives an MQTT 5 qos1 message");
+    reset_callback();
+
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x32,0x11,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x12,0x34,0x0,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.respond(publish,19);
+
+    byte puback[] = {0x40,0x2,0x12,0x34};
+    shimClient.expect(puback,4);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+
+    IS_TRUE(callback_called);
+    IS_TRUE(strcmp(lastTopic,"topic")==0);
+    IS_TRUE(memcmp(lastPayload,"payload",7)==0);
+    IS_TRUE(lastLength == 7);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_receive_v5_stream() {
+    IT("streams an MQTT 5 message without its properties");
+    reset_callback();
+
+    Stream stream;
+    stream.expect((uint8_t*)"payload",7);
+
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient, stream);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x30,0x11,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x2,0x1,0x1,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.respond(publish,19);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+
+    IS_TRUE(callback_called);
+    IS_TRUE(lastLength == 7);
+
+    IS_FALSE(stream.error());
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_receive_v5_disconnect() {
+    IT("closes on an MQTT 5 disconnect from the broker");
+    reset_callback();
+
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    // session taken over
+    byte disconnect[] = {0xe0,0x1,0x8e};
+    shimClient.respond(disconnect,3);
+
+    rc = client.loop();
+    IS_FALSE(rc);
+    IS_FALSE(client.connected());
+    IS_TRUE(client.reasonCode() == 0x8e);
+    IS_FALSE(callback_called);
+
+    END_IT
+}
+
+bool stream_callback_called = false;
+char streamedTopic[64];
+char streamedPayload[1024];
+unsigned int streamedLength;
+unsigned int streamedRead;
+// bytes the stream callback reads before it returns, all if 0
+unsigned int streamReadLimit;
+
+void reset_stream_callback() {
+    stream_callback_called = false;
+    streamedTopic[0] = '\0';
+    streamedLength = 0;
+    streamedRead = 0;
+    streamReadLimit = 0;
+}
+
+void streamCallback(char* topic, Stream& stream, uint32_t length) {
+    stream_callback_called = true;
+    strcpy(streamedTopic,topic);
+    streamedLength = length;
+    PubSubPayloadStream& payload = static_cast<PubSubPayloadStream&>(stream);
+    unsigned int limit = streamReadLimit ? streamReadLimit : length;
+    // in chunks smaller than the buffer, then byte by byte
+    while (streamedRead + 8 <= limit) {
+        int rc = payload.read((uint8_t*)streamedPayload+streamedRead,8);
+        if (rc <= 0) {
+            break;
+        }
+        streamedRead += rc;
+    }
+    while (streamedRead < limit) {
+        int c = stream.read();
+        if (c < 0) {
+            break;
+        }
+        streamedPayload[streamedRead++] = c;
+    }
+}
+
+int test_receive_oversized_message_streamed() {
+    IT("streams a message larger than the buffer");
+    reset_callback();
+    reset_stream_callback();
+
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setBufferSize(32);
+    client.setStreamCallback(streamCallback);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    // 100 bytes of payload behind "topic"
+    byte bigPublish[109] = {0x30,0x6b,0x0,0x5,0x74,0x6f,0x70,0x69,0x63};
+    for (int i = 0; i < 100; i++) {
+        bigPublish[9+i] = 'a' + i % 26;
+    }
+    shimClient.respond(bigPublish,109);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+
+    IS_TRUE(stream_callback_called);
+    IS_FALSE(callback_called);
+    IS_TRUE(strcmp(streamedTopic,"topic")==0);
+    IS_TRUE(streamedLength == 100);
+    IS_TRUE(streamedRead == 100);
+    IS_TRUE(memcmp(streamedPayload,bigPublish+9,100)==0);
+
+    // messages that fit still go to the callback
+    byte publish[] = {0x30,0xe,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.respond(publish,16);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(callback_called);
+    IS_TRUE(memcmp(lastPayload,"payload",7)==0);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_receive_streamed_unread_dropped() {
+    IT("drops what the stream callback leaves unread");
+    reset_callback();
+    reset_stream_callback();
+    streamReadLimit = 10;
+
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setBufferSize(32);
+    client.setStreamCallback(streamCallback);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte bigPublish[109] = {0x30,0x6b,0x0,0x5,0x74,0x6f,0x70,0x69,0x63};
+    memset(bigPublish+9,'A',100);
+    shimClient.respond(bigPublish,109);
+    byte publish[] = {0x30,0xe,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x70,0x61,0x79,0x6c,0x6f,0x61,0x64};
+    shimClient.respond(publish,16);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(streamedRead == 10);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(callback_called);
+    IS_TRUE(strcmp(lastTopic,"topic")==0);
+    IS_TRUE(lastLength == 7);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_receive_streamed_qos1() {
+    IT("acknowledges a streamed qos 1 message");
+    reset_callback();
+    reset_stream_callback();
+
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setBufferSize(32);
+    client.setStreamCallback(streamCallback);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte bigPublish[111] = {0x32,0x6d,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x12,0x34};
+    memset(bigPublish+11,'A',100);
+    shimClient.respond(bigPublish,111);
+
+    byte puback[] = {0x40,0x2,0x12,0x34};
+    shimClient.expect(puback,4);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(stream_callback_called);
+    IS_TRUE(streamedLength == 100);
+    IS_TRUE(streamedRead == 100);
+    IS_TRUE(streamedPayload[99] == 'A');
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_receive_streamed_v5() {
+    IT("streams an MQTT 5 message without its properties");
+    reset_callback();
+    reset_stream_callback();
+
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    client.setBufferSize(40);
+    client.setStreamCallback(streamCallback);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    // content type "json"
+    byte bigPublish[117] = {0x30,0x73,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x7,0x3,0x0,0x4,0x6a,0x73,0x6f,0x6e};
+    memset(bigPublish+17,'A',100);
+    shimClient.respond(bigPublish,117);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(stream_callback_called);
+    IS_TRUE(streamedLength == 100);
+    IS_TRUE(streamedRead == 100);
+    IS_TRUE(streamedPayload[0] == 'A');
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
 int main()
 {
     SUITE("Receive");
@@ -335,6 +658,14 @@ int main()
     test_resize_buffer();
     test_receive_oversized_stream_message();
     test_receive_qos1();
+    test_receive_v5_properties();
+    test_receive_v5_qos1();
+    test_receive_v5_stream();
+    test_receive_v5_disconnect();
+    test_receive_oversized_message_streamed();
+    test_receive_streamed_unread_dropped();
+    test_receive_streamed_qos1();
+    test_receive_streamed_v5();
 
     FINISH
 }
@@ -164,6 +164,60 @@ int test_unsubscribe_not_connected() {
     END_IT
 }
 
+int test_subscribe_v5() {
+    IT("subscribes with empty MQTT 5 properties");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte subscribe[] = { 0x82,0xb,0x0,0x2,0x0,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x1 };
+    shimClient.expect(subscribe,13);
+    // granted qos 1, behind empty properties
+    byte suback[] = { 0x90,0x4,0x0,0x2,0x0,0x1 };
+    shimClient.respond(suback,6);
+
+    rc = client.subscribe((char*)"topic",1);
+    IS_TRUE(rc);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(client.reasonCode() == 0x01);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_unsubscribe_v5() {
+    IT("unsubscribes with empty MQTT 5 properties");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x03, 0x00, 0x00, 0x00 };
+    shimClient.respond(connack,5);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    client.setProtocolVersion(MQTT_VERSION_5);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte unsubscribe[] = { 0xA2,0xa,0x0,0x2,0x0,0x0,0x5,0x74,0x6f,0x70,0x69,0x63 };
+    shimClient.expect(unsubscribe,12);
+
+    rc = client.unsubscribe((char*)"topic");
+    IS_TRUE(rc);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
 int main()
 {
     SUITE("Subscribe");
@@ -174,5 +228,7 @@ int main()
     test_subscribe_too_long();
     test_unsubscribe();
     test_unsubscribe_not_connected();
+    test_subscribe_v5();
+    test_unsubscribe_v5();
     FINISH
 }
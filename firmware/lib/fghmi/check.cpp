@@ -1,7 +1,7 @@
 #include "check.h"
 
-#include <sstream>
-#include <iomanip>
+#include "textbuffer.h"
+
 namespace fg {
 
   CheckDisplay::CheckDisplay(std::function<void(void)> callback) : callback(callback) {}
@@ -12,19 +12,13 @@ namespace fg {
     UserInterface::display.setTextSize(1);
     printCentered("CHECK DISPLAY & KNOB", 10);
 
-    std::stringstream value_print;
-    for(unsigned i = 0; i < position; i++) {
-      value_print << "-";
-    }
-    value_print << "X";
-    for(unsigned i = position; i < 10; i++) {
-      value_print << "-";
-    }
-    printCentered(value_print.str().c_str(), 30);
+    TextBuffer<24> value_print;
+    value_print.repeat('-', position).append('X').repeat('-', 10 - position);
+    printCentered(value_print.c_str(), 30);
 
-    value_print.str(std::string());
-    value_print << "CLICKS: " << clicks;
-    printCentered(value_print.str().c_str(), 40);
+    value_print.clear();
+    value_print.append("CLICKS: ").integer(clicks);
+    printCentered(value_print.c_str(), 40);
     printCentered("hold to continue", 50);
 
     UserInterface::display.setTextSize(1);
@@ -1,5 +1,5 @@
 #include "error.h"
-#include <sstream>
+#include "textbuffer.h"
 
 namespace fg {
 
@@ -11,9 +11,9 @@ namespace fg {
     UserInterface::display.setTextColor(SSD1306_WHITE); // Draw white text
 
     UserInterface::display.setTextSize(1);
-    std::stringstream value_print;
-    value_print << "ERROR " << current_error + 1 << "/" << errors.size();
-    printCentered(value_print.str().c_str(), 10);
+    TextBuffer<24> value_print;
+    value_print.append("ERROR ").integer(current_error + 1).append("/").integer(errors.size());
+    printCentered(value_print.c_str(), 10);
 
     // display.setFont(&FONT_VALUE);
     UserInterface::display.setTextSize(1);
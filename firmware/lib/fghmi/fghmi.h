@@ -1,6 +1,8 @@
 #pragma once
 
 #include "userinterface.h"
+#include "textbuffer.h"
+#include "spscring.h"
 // #include "button.h"
 #include "floatdisplay.h"
 #include "floatinput.h"
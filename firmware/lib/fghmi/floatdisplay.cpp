@@ -1,7 +1,7 @@
 #include "floatdisplay.h"
 
-#include <sstream>
-#include <iomanip>
+#include "textbuffer.h"
+
 namespace fg {
 
 FloatDisplay::FloatDisplay(std::string name, float* value, std::string unit, float precision, std::function<void(void)> callback)
@@ -11,14 +11,15 @@ FloatDisplay::FloatDisplay(std::string name, float* value, std::string unit, flo
   void FloatDisplay::draw() {
     UserInterface::display.setTextColor(SSD1306_WHITE); // Draw white text
     UserInterface::display.setTextSize(1);
-    std::string display_name = "< " + name + " >";
+    TextBuffer<32> display_name;
+    display_name.append("< ").append(name.c_str()).append(" >");
     printCentered(display_name.c_str(), 10);
 
     // display.setFont(&FONT_VALUE);
     UserInterface::display.setTextSize(2);
-    std::stringstream value_print;
-    value_print << std::fixed << std::setprecision(precision) << *value << unit;
-    printCentered(value_print.str().c_str(), 30);
+    TextBuffer<24> value_print;
+    value_print.fixed(*value, precision).append(unit.c_str());
+    printCentered(value_print.c_str(), 30);
   }
 
   void FloatDisplay::prev() {}
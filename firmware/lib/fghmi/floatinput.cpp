@@ -1,7 +1,7 @@
 #include "floatinput.h"
 
-#include <sstream>
-#include <iomanip>
+#include "textbuffer.h"
+
 namespace fg {
 
   FloatInput::FloatInput(std::string name, float value, std::string unit, float min, float max, float step, float precision, std::function<void(float)> listener)
@@ -14,10 +14,10 @@ namespace fg {
 
     // display.setFont(&FONT_VALUE);
     UserInterface::display.setTextSize(2);
-    std::stringstream value_print;
-    value_print << "< " << std::fixed << std::setprecision(precision) << value << unit << " >";
+    TextBuffer<32> value_print;
+    value_print.append("< ").fixed(value, precision).append(unit.c_str()).append(" >");
 
-    printCentered(value_print.str().c_str(), 30);
+    printCentered(value_print.c_str(), 30);
   }
 
   void FloatInput::prev() {
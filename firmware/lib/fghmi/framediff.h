@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace fg {
+
+  // Remembers what the panel currently shows and reports, per 8 row page
+  // of an SSD1306 framebuffer, the column range that differs from a new
+  // frame. Only ranges confirmed with update() count as shown, so a frame
+  // that could not be sent stays dirty.
+  template<uint16_t width, uint16_t height>
+  class FrameDiff {
+  public:
+    static constexpr uint8_t PAGES = height / 8;
+
+  private:
+    uint8_t shown[width * PAGES];
+    bool page_valid[PAGES];
+
+  public:
+    FrameDiff() { invalidate(); }
+
+    // forget the panel content, e.g. after a reset or wake up
+    void invalidate() {
+      for(auto& valid : page_valid) {
+        valid = false;
+      }
+    }
+
+    // first and last changed column of a page, false if it is unchanged
+    bool dirty(const uint8_t* frame, uint8_t page, uint16_t& first, uint16_t& last) const {
+      auto current = frame + page * width;
+      auto previous = shown + page * width;
+      if(!page_valid[page]) {
+        first = 0;
+        last = width - 1;
+        return true;
+      }
+
+      uint16_t begin = 0;
+      while(begin < width && current[begin] == previous[begin]) {
+        begin++;
+      }
+      if(begin == width) {
+        return false;
+      }
+      uint16_t end = width - 1;
+      while(current[end] == previous[end]) {
+        end--;
+      }
+      first = begin;
+      last = end;
+      return true;
+    }
+
+    void update(const uint8_t* frame, uint8_t page, uint16_t first, uint16_t last) {
+      memcpy(shown + page * width + first, frame + page * width + first, last - first + 1);
+      if(first == 0 && last == width - 1) {
+        page_valid[page] = true;
+      }
+    }
+  };
+
+}
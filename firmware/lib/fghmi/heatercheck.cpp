@@ -1,7 +1,7 @@
 #include "heatercheck.h"
 
-#include <sstream>
-#include <iomanip>
+#include "textbuffer.h"
+
 namespace fg {
 
 HeaterCheck::HeaterCheck(float* temp1, float* temp2, float* temp3, float* temp4, std::function<void(void)> callback)
@@ -11,18 +11,17 @@ HeaterCheck::HeaterCheck(float* temp1, float* temp2, float* temp3, float* temp4,
   void HeaterCheck::draw() {
     UserInterface::display.setTextColor(SSD1306_WHITE); // Draw white text
     UserInterface::display.setTextSize(1);
-    std::string display_name = "CHECKING HEATER";
-    printCentered(display_name.c_str(), 10);
+    printCentered("CHECKING HEATER", 10);
 
     // display.setFont(&FONT_VALUE);
     UserInterface::display.setTextSize(1);
-    std::stringstream value_print;
-    value_print << std::fixed << std::setprecision(1) << *temp1 << "C " << *temp2 << "C";
-    printCentered(value_print.str().c_str(), 30);
+    TextBuffer<24> value_print;
+    value_print.fixed(*temp1, 1).append("C ").fixed(*temp2, 1).append("C");
+    printCentered(value_print.c_str(), 30);
 
-    value_print.str(std::string());
-    value_print << std::fixed << std::setprecision(1) << *temp3 << "C " << *temp4 << "C";
-    printCentered(value_print.str().c_str(), 40);
+    value_print.clear();
+    value_print.fixed(*temp3, 1).append("C ").fixed(*temp4, 1).append("C");
+    printCentered(value_print.c_str(), 40);
   }
 
   void HeaterCheck::prev() {}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+
+namespace fg {
+
+  // Fixed slots for the objects on the menu stack, so navigating menus
+  // does not fragment the heap. allocate() returns nullptr when all slots
+  // are taken, the caller falls back to the heap.
+  template<size_t slot_size, size_t slots>
+  class SlotPool {
+    static_assert(slots <= 32, "slot usage is tracked in a 32 bit mask");
+
+    typename std::aligned_storage<slot_size, alignof(max_align_t)>::type storage[slots];
+    uint32_t used = 0;
+    uint32_t fallbacks = 0;
+
+  public:
+    static constexpr size_t SLOT_SIZE = slot_size;
+
+    void* allocate() {
+      for(size_t i = 0; i < slots; i++) {
+        if(!(used & (1u << i))) {
+          used |= 1u << i;
+          return &storage[i];
+        }
+      }
+      fallbacks++;
+      return nullptr;
+    }
+
+    bool owns(const void* ptr) const {
+      auto bytes = static_cast<const uint8_t*>(ptr);
+      auto begin = reinterpret_cast<const uint8_t*>(storage);
+      return bytes >= begin && bytes < begin + sizeof(storage);
+    }
+
+    void release(const void* ptr) {
+      auto offset = static_cast<const uint8_t*>(ptr) - reinterpret_cast<const uint8_t*>(storage);
+      used &= ~(1u << (offset / sizeof(storage[0])));
+    }
+
+    inline uint32_t fallbackCount() const { return fallbacks; }
+  };
+
+}
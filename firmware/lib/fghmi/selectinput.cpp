@@ -1,7 +1,7 @@
 #include "selectinput.h"
 
-#include <sstream>
-#include <iomanip>
+#include "textbuffer.h"
+
 namespace fg {
 
   SelectInput::SelectInput(std::string name, uint32_t value, std::vector<std::string> options, std::function<void(uint32_t)> listener)
@@ -16,9 +16,9 @@ namespace fg {
     // display.setFont(&FONT_VALUE);
     UserInterface::display.setTextSize(1);
 
-    std::stringstream value_print;
-    value_print << "< " << options[value] << " >";
-    printCentered(value_print.str().c_str(), 30);
+    TextBuffer<40> value_print;
+    value_print.append("< ").append(options[value].c_str()).append(" >");
+    printCentered(value_print.c_str(), 30);
   }
 
   void SelectInput::prev() {
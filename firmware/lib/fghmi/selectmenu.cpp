@@ -6,11 +6,18 @@ namespace fg {
   SelectMenu::SelectMenu() {}
 
   void SelectMenu::addOption(std::string name, std::function<void(void)> cb) {
-    options.push_back({name, cb, nullptr});
+    options.push_back({name, cb, nullptr, nullptr});
   }
 
   void SelectMenu::addOption(std::string name, icon_t icon, std::function<void(void)> cb) {
-    options.push_back({name, cb, icon});
+    options.push_back({name, cb, icon, nullptr});
+  }
+
+  void SelectMenu::addOptions(const MenuDescriptor* descriptors, size_t count) {
+    options.reserve(options.size() + count);
+    for(size_t i = 0; i < count; i++) {
+      options.push_back({std::string(), nullptr, descriptors[i].icon, &descriptors[i]});
+    }
   }
 
   void SelectMenu::draw() {
@@ -22,7 +29,7 @@ namespace fg {
         UserInterface::display.drawBitmap(0, 3, options[selected - 1].icon, 16, 16, SSD1306_WHITE);
       }
       UserInterface::display.setCursor(20, 7);
-      UserInterface::display.write(options[selected - 1].name.c_str());
+      UserInterface::display.write(options[selected - 1].label());
     }
 
     UserInterface::display.fillRect(0, 22, 128, 21, SSD1306_WHITE);
@@ -32,7 +39,7 @@ namespace fg {
 
     UserInterface::display.setTextColor(SSD1306_BLACK, SSD1306_WHITE);
     UserInterface::display.setCursor(20, 28);
-    UserInterface::display.write((options[selected].name).c_str());
+    UserInterface::display.write(options[selected].label());
     UserInterface::display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
 
     if(selected < options.size() - 1) {
@@ -40,7 +47,7 @@ namespace fg {
         UserInterface::display.drawBitmap(1, 48, options[selected + 1].icon, 16, 16, SSD1306_WHITE);
       }
       UserInterface::display.setCursor(20, 52);
-      UserInterface::display.write(options[selected + 1].name.c_str());
+      UserInterface::display.write(options[selected + 1].label());
     }
   }
 
@@ -53,7 +60,15 @@ namespace fg {
   }
 
   void SelectMenu::enter() {
-    options[selected].callback();
+    auto& option = options[selected];
+    if(option.descriptor) {
+      if(action_handler) {
+        action_handler(*option.descriptor);
+      }
+    }
+    else {
+      option.callback();
+    }
   }
 
   void SelectMenu::hold() {}
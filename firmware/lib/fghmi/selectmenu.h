@@ -4,21 +4,39 @@
 #include "icons.h"
 namespace fg {
 
+  // One entry of a static menu, meant for constexpr tables that stay in
+  // flash. The action id is passed to the menu's handler on enter.
+  struct MenuDescriptor {
+    const char* name;
+    icon_t icon;
+    uint16_t action;
+  };
+
   struct SelectMenuOption {
     std::string name;
     std::function<void(void)> callback;
     icon_t icon;
+    const MenuDescriptor* descriptor;
+
+    inline const char* label() const { return descriptor ? descriptor->name : name.c_str(); }
   };
 
   class SelectMenu: public MenuItem {
     std::vector<SelectMenuOption> options;
-    std::function<void(unsigned int)> listener;
+    std::function<void(const MenuDescriptor&)> action_handler;
     unsigned int selected = 0;
   public:
     SelectMenu();
     void addOption(std::string name, std::function<void(void)> cb);
     void addOption(std::string name, icon_t icon, std::function<void(void)> cb);
 
+    // adds table entries without copying their names, entering one calls
+    // the handler with the entry
+    void addOptions(const MenuDescriptor* descriptors, size_t count);
+    template<size_t N>
+    void addOptions(const MenuDescriptor (&descriptors)[N]) { addOptions(descriptors, N); }
+    void onAction(std::function<void(const MenuDescriptor&)> handler) { action_handler = handler; }
+
     void draw() override;
     void prev() override;
     void next() override;
@@ -26,4 +44,4 @@ namespace fg {
     void hold() override;
   };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+namespace fg {
+
+  // Lock free queue for exactly one producer and one consumer, e.g. an
+  // interrupt handler and the task reading its events. Head and tail run
+  // freely and are only masked on access, so all slots are usable. A push
+  // into a full ring is counted and rejected, never overwrites.
+  template<typename T, size_t size>
+  class SpscRing {
+    static_assert(size >= 2 && (size & (size - 1)) == 0, "ring size must be a power of two");
+
+    T slots[size];
+    std::atomic<uint32_t> head{0}; // written by the producer only
+    std::atomic<uint32_t> tail{0}; // written by the consumer only
+    std::atomic<uint32_t> dropped{0}; // written by the producer only
+
+  public:
+    // always inlined, so an IRAM interrupt handler pushing events does not
+    // call into flash
+    inline __attribute__((always_inline)) bool push(const T& value) {
+      auto h = head.load(std::memory_order_relaxed);
+      if(h - tail.load(std::memory_order_acquire) >= size) {
+        dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+      }
+      slots[h & (size - 1)] = value;
+      head.store(h + 1, std::memory_order_release);
+      return true;
+    }
+
+    bool pop(T& value) {
+      auto t = tail.load(std::memory_order_relaxed);
+      if(t == head.load(std::memory_order_acquire)) {
+        return false;
+      }
+      value = slots[t & (size - 1)];
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    }
+
+    bool empty() const {
+      return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+    inline uint32_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+  };
+
+}
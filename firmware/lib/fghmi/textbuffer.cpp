@@ -0,0 +1,90 @@
+#include "textbuffer.h"
+
+#include <math.h>
+
+namespace fg {
+
+  static constexpr unsigned MAX_PRECISION = 6;
+  static constexpr uint32_t POW10[MAX_PRECISION + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+  TextBuilder::TextBuilder(char* buffer, size_t size) : buffer(buffer), size(size) {
+    buffer[0] = 0;
+  }
+
+  void TextBuilder::clear() {
+    length = 0;
+    buffer[0] = 0;
+  }
+
+  TextBuilder& TextBuilder::append(char c) {
+    if(length + 1 < size) {
+      buffer[length++] = c;
+      buffer[length] = 0;
+    }
+    return *this;
+  }
+
+  TextBuilder& TextBuilder::append(const char* text) {
+    while(*text) {
+      append(*text++);
+    }
+    return *this;
+  }
+
+  TextBuilder& TextBuilder::repeat(char c, unsigned count) {
+    while(count--) {
+      append(c);
+    }
+    return *this;
+  }
+
+  static void appendUnsigned(TextBuilder& text, uint64_t value, unsigned min_digits) {
+    char digits[20];
+    unsigned count = 0;
+    do {
+      digits[count++] = '0' + value % 10;
+      value /= 10;
+    } while(value || count < min_digits);
+    while(count) {
+      text.append(digits[--count]);
+    }
+  }
+
+  TextBuilder& TextBuilder::integer(int32_t value) {
+    if(value < 0) {
+      append('-');
+    }
+    appendUnsigned(*this, value < 0 ? -static_cast<int64_t>(value) : value, 1);
+    return *this;
+  }
+
+  TextBuilder& TextBuilder::fixed(float value, unsigned precision) {
+    if(isnan(value)) {
+      return append("nan");
+    }
+    if(signbit(value)) {
+      append('-');
+      value = -value;
+    }
+    // beyond this the scaled value no longer fits 64 bits
+    if(isinf(value) || value >= 1e12f) {
+      return append("inf");
+    }
+
+    precision = precision > MAX_PRECISION ? MAX_PRECISION : precision;
+    // exact in double for any float, ties round to even like printf
+    double exact = static_cast<double>(value) * POW10[precision];
+    uint64_t scaled = static_cast<uint64_t>(exact);
+    double remainder = exact - scaled;
+    if(remainder > 0.5 || (remainder == 0.5 && (scaled & 1))) {
+      scaled++;
+    }
+    appendUnsigned(*this, scaled / POW10[precision], 1);
+    if(precision) {
+      append('.');
+      appendUnsigned(*this, scaled % POW10[precision], precision);
+    }
+    return *this;
+  }
+
+}
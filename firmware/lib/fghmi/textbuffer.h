@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace fg {
+
+  // Formats display text into a caller provided buffer without touching
+  // the heap, e.g.
+  //
+  //   TextBuffer<16> text;
+  //   text.fixed(*temperature, 1).append("C");
+  //   UserInterface::display.write(text.c_str());
+  //
+  // Output that does not fit is truncated.
+  class TextBuilder {
+    char* buffer;
+    size_t size;
+    size_t length = 0;
+
+  public:
+    TextBuilder(char* buffer, size_t size);
+
+    TextBuilder& append(const char* text);
+    TextBuilder& append(char c);
+    TextBuilder& integer(int32_t value);
+    TextBuilder& fixed(float value, unsigned precision);
+    TextBuilder& repeat(char c, unsigned count);
+    void clear();
+
+    inline const char* c_str() const { return buffer; }
+    inline size_t len() const { return length; }
+  };
+
+  template<size_t N>
+  class TextBuffer : public TextBuilder {
+    char storage[N];
+  public:
+    TextBuffer() : TextBuilder(storage, N) {}
+  };
+
+}
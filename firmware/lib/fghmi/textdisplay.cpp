@@ -1,7 +1,5 @@
 #include "textdisplay.h"
 
-#include <sstream>
-#include <iomanip>
 namespace fg {
 
   TextDisplay::TextDisplay(std::string text, uint8_t scale, std::function<void(void)> callback)
@@ -1,7 +1,7 @@
 #include "update.h"
 
-#include <sstream>
-#include <iomanip>
+#include "textbuffer.h"
+
 namespace fg {
 
   UpdateDisplay::UpdateDisplay() {}
@@ -15,10 +15,10 @@ namespace fg {
     // display.setFont(&FONT_VALUE);
     UserInterface::display.setTextSize(2);
 
-    std::stringstream value_print;
-    value_print << (int)percent << "%\r\n";
+    TextBuffer<8> value_print;
+    value_print.integer(percent).append("%\r\n");
 
-    printCentered(value_print.str().c_str(), 30);
+    printCentered(value_print.c_str(), 30);
 
     UserInterface::display.setTextSize(1);
   }
@@ -1,4 +1,5 @@
 #include "fghmi.h"
+#include "i2cbus.h"
 
 #include <SPI.h>
 #include <Wire.h>
@@ -8,8 +9,6 @@
 #define FONT_HEADER FreeSans9pt7b
 #define FONT_VALUE FreeSansBold18pt7b
 
-#include <sstream>
-#include <iomanip>
 
 
 
@@ -21,6 +20,11 @@
 #define OLED_RESET     -1 // Reset pin # (or -1 if sharing Arduino reset pin)
 #define SCREEN_ADDRESS 0x3C ///< See datasheet for Address; 0x3D for 128x64, 0x3C for 128x32
 
+// same clocks Adafruit_SSD1306::display() uses for a frame
+#define DISPLAY_I2C_FRQ 400000
+#define DISPLAY_I2C_FRQ_AFTER 100000
+#define DISPLAY_I2C_CHUNK 127 // Wire buffer minus the control byte
+
 
 namespace fg {
 
@@ -28,9 +32,13 @@ namespace fg {
 
   Adafruit_SSD1306 UserInterface::display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 
-  UserInterface::UserInterface() {}
+  UserInterface::UserInterface() {
+    items.reserve(MENU_POOL_SLOTS);
+    delete_items.reserve(MENU_POOL_SLOTS);
+  }
 
   void UserInterface::init() {
+    I2cTransaction transaction(i2cBus(0), I2cPriority::SENSOR);
     if(!UserInterface::display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
       Serial.println(F("SSD1306 allocation failed"));
       for(;;); // Don't proceed, loop forever
@@ -39,59 +47,158 @@ namespace fg {
 
     UserInterface::display.clearDisplay();
     UserInterface::display.display();
+    frame_diff.invalidate();
   }
 
   void UserInterface::loop() {
-    UserInterface::display.clearDisplay();
-
+    UiAction action;
     if(idle_ticks >= MAX_IDLE_TICKS) {
-      if(current_action != UiAction::NONE) {
-        idle_ticks = 0;
-        current_action = UiAction::NONE;
+      if(actions.empty()) {
+        // the panel is off, nothing is drawn or sent until an input arrives
+        if(panel_on) {
+          panel_on = !command(SSD1306_DISPLAYOFF);
+        }
+        return;
       }
-      UserInterface::display.display();
-      return;
+      // the waking input only turns the panel back on
+      idle_ticks = 0;
+      actions.pop(action);
     }
 
+    UserInterface::display.clearDisplay();
+
     if(items.size()) {
-      auto active_item = *items.rbegin();
-      active_item->draw();
-
-      switch(current_action) {
-        case UiAction::NEXT:
-          current_action = UiAction::NONE;
-          active_item->next();
-          idle_ticks = 0;
-          break;
-        case UiAction::PREV:
-          current_action = UiAction::NONE;
-          active_item->prev();
-          idle_ticks = 0;
-          break;
-        case UiAction::ENTER:
-          current_action = UiAction::NONE;
-          active_item->enter();
-          idle_ticks = 0;
-          break;
-        case UiAction::HOLD:
-          current_action = UiAction::NONE;
-          active_item->hold();
-          idle_ticks = 0;
-          break;
-        case UiAction::NONE:
-        default:
-          idle_ticks++;
+      // every queued action goes to the item on top at that point, an
+      // enter may have pushed or popped one
+      bool acted = false;
+      while(actions.pop(action)) {
+        auto active_item = *items.rbegin();
+        switch(action) {
+          case UiAction::NEXT:
+            active_item->next();
+            break;
+          case UiAction::PREV:
+            active_item->prev();
+            break;
+          case UiAction::ENTER:
+            active_item->enter();
+            break;
+          case UiAction::HOLD:
+            active_item->hold();
+            break;
+          case UiAction::NONE:
+          default:
+            break;
+        }
+        acted = true;
+        if(items.empty()) {
           break;
+        }
+      }
+
+      if(acted) {
+        idle_ticks = 0;
+      }
+      else {
+        idle_ticks++;
       }
-      current_action = UiAction::NONE;
 
+      if(items.size()) {
+        (*items.rbegin())->draw();
+      }
     }
-    UserInterface::display.display();
+
+    // the panel still holds the frame from before it went to sleep,
+    // switch it on once the current one was sent
+    if(flush() && !panel_on) {
+      panel_on = command(SSD1306_DISPLAYON);
+    }
+  }
+
+  bool UserInterface::command(uint8_t command) {
+    I2cTransaction transaction(i2cBus(0), I2cPriority::DISPLAY);
+    if(!transaction) {
+      return false;
+    }
+    auto& wire = transaction.wire();
+    wire.beginTransmission(SCREEN_ADDRESS);
+    wire.write(static_cast<uint8_t>(0x00)); // command stream
+    wire.write(command);
+    if(wire.endTransmission()) {
+      transaction.fail();
+      return false;
+    }
+    return true;
+  }
+
+  bool UserInterface::flush() {
+    // only pages that differ from what the panel shows are sent, within a
+    // page only the changed column range. If a sensor is waiting for the
+    // bus the frame is dropped and the difference is sent next tick.
+    display_stats.frames++;
+    auto frame = UserInterface::display.getBuffer();
+    bool updated = false;
+    I2cTransaction transaction(i2cBus(0), I2cPriority::DISPLAY);
+    if(!transaction) {
+      return false;
+    }
+
+    for(uint8_t page = 0; page < frame_diff.PAGES; page++) {
+      uint16_t first, last;
+      if(!frame_diff.dirty(frame, page, first, last)) {
+        continue;
+      }
+      if(!updated) {
+        transaction.wire().setClock(DISPLAY_I2C_FRQ);
+        updated = true;
+      }
+      if(!sendRange(transaction.wire(), page, first, last)) {
+        transaction.fail();
+        frame_diff.invalidate();
+        transaction.wire().setClock(DISPLAY_I2C_FRQ_AFTER);
+        return false;
+      }
+      frame_diff.update(frame, page, first, last);
+    }
+
+    if(updated) {
+      transaction.wire().setClock(DISPLAY_I2C_FRQ_AFTER);
+      display_stats.updates++;
+    }
+    return true;
+  }
+
+  bool UserInterface::sendRange(TwoWire& wire, uint8_t page, uint16_t first, uint16_t last) {
+    const uint8_t address[] = {
+      SSD1306_PAGEADDR, page, page,
+      SSD1306_COLUMNADDR, static_cast<uint8_t>(first), static_cast<uint8_t>(last)
+    };
+    wire.beginTransmission(SCREEN_ADDRESS);
+    wire.write(static_cast<uint8_t>(0x00)); // command stream
+    wire.write(address, sizeof(address));
+    if(wire.endTransmission()) {
+      return false;
+    }
+    display_stats.bytes += sizeof(address) + 1;
+
+    auto data = UserInterface::display.getBuffer() + page * SCREEN_WIDTH;
+    for(uint16_t column = first; column <= last; column += DISPLAY_I2C_CHUNK) {
+      uint16_t count = last - column + 1;
+      count = count > DISPLAY_I2C_CHUNK ? DISPLAY_I2C_CHUNK : count;
+      wire.beginTransmission(SCREEN_ADDRESS);
+      wire.write(static_cast<uint8_t>(0x40)); // data stream
+      wire.write(data + column, count);
+      if(wire.endTransmission()) {
+        return false;
+      }
+      display_stats.bytes += count + 1;
+    }
+    return true;
   }
 
   void UserInterface::pop() {
     Serial.print("POP ");
-    Serial.print(reinterpret_cast<uint32_t>(this));
+    Serial.print(reinterpret_cast<uintptr_t>(this));
     if(items.size()) {
       delete_items.push_back(*items.rbegin());
       items.pop_back();
@@ -102,7 +209,13 @@ namespace fg {
 
   void UserInterface::cleanup() {
     for(auto ptr : delete_items) {
-      delete ptr;
+      if(menu_pool.owns(ptr)) {
+        ptr->~MenuItem();
+        menu_pool.release(ptr);
+      }
+      else {
+        delete ptr;
+      }
     }
     delete_items.clear();
   }
@@ -9,9 +9,15 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 
+#include "framediff.h"
+#include "menupool.h"
+#include "spscring.h"
+
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <new>
+#include <string>
 #include <vector>
 
 namespace fg {
@@ -37,9 +43,22 @@ namespace fg {
     NONE, PREV, NEXT, ENTER, HOLD
   };
 
+  struct DisplayStats {
+    uint32_t frames = 0;
+    uint32_t updates = 0; // frames that changed at least one page
+    uint32_t bytes = 0;   // bytes sent to the panel
+  };
+
   class UserInterface {
 
-    UiAction current_action = UiAction::NONE;
+    // actions are applied in order on the next tick instead of the last
+    // one overwriting the others
+    SpscRing<UiAction, 16> actions;
+
+    // deep enough for the nested settings menus plus the items popped
+    // during one tick, larger stacks fall back to the heap
+    static constexpr size_t MENU_POOL_SLOTS = 12;
+    SlotPool<160, MENU_POOL_SLOTS> menu_pool;
 
     std::vector<MenuItem*> items;
     std::vector<MenuItem*> delete_items;
@@ -47,6 +66,14 @@ namespace fg {
 
     static constexpr unsigned int MAX_IDLE_TICKS = 300;
     unsigned int idle_ticks = 0;
+    bool panel_on = true;
+
+    FrameDiff<SCREEN_WIDTH, SCREEN_HEIGHT> frame_diff;
+    DisplayStats display_stats;
+
+    bool flush();
+    bool command(uint8_t command);
+    bool sendRange(TwoWire& wire, uint8_t page, uint16_t first, uint16_t last);
 
   public:
     static Adafruit_SSD1306 display;
@@ -58,8 +85,10 @@ namespace fg {
 
     template<class T, class... Args>
     T* push(Args... args) {
-      auto item = new T(args...);
-      items.push_back(reinterpret_cast<MenuItem*>(item));
+      static_assert(sizeof(T) <= decltype(menu_pool)::SLOT_SIZE, "menu item does not fit a pool slot");
+      void* slot = menu_pool.allocate();
+      T* item = slot ? new(slot) T(args...) : new T(args...);
+      items.push_back(item);
       return item;
     }
 
@@ -71,11 +100,17 @@ namespace fg {
       change_listener = fn;
     }
 
-    void prev() { current_action = UiAction::PREV; }
-    void next() { current_action = UiAction::NEXT; }
-    void enter() { current_action = UiAction::ENTER; }
-    void hold() { current_action = UiAction::HOLD; }
+    void prev() { actions.push(UiAction::PREV); }
+    void next() { actions.push(UiAction::NEXT); }
+    void enter() { actions.push(UiAction::ENTER); }
+    void hold() { actions.push(UiAction::HOLD); }
     bool isIdle() const { return idle_ticks >= MAX_IDLE_TICKS; }
+    bool isAsleep() const { return isIdle() && !panel_on; }
+
+    DisplayStats displayStats() const { return display_stats; }
+    void resetDisplayStats() { display_stats = DisplayStats(); }
+    uint32_t menuPoolFallbacks() const { return menu_pool.fallbackCount(); }
+    uint32_t droppedActions() const { return actions.droppedCount(); }
   };
 
   void printCentered(const char* text, uint8_t y);
@@ -0,0 +1,164 @@
+#include "i2cbus.h"
+#include "esp_timer.h"
+#include "driver/i2c.h"
+#include "driver/gpio.h"
+
+namespace fg {
+
+  static constexpr TickType_t SENSOR_LOCK_TIMEOUT = configTICK_RATE_HZ;
+
+  I2cBus::I2cBus(TwoWire& wire, uint8_t port) : wire(wire), port(port) {
+    mutex = xSemaphoreCreateRecursiveMutex();
+    window_start = esp_timer_get_time();
+  }
+
+  bool I2cBus::lock(I2cPriority priority) {
+    if(priority == I2cPriority::DISPLAY) {
+      if(sensors_waiting || xSemaphoreTakeRecursive(mutex, 0) != pdTRUE) {
+        counters.skipped++;
+        return false;
+      }
+      return true;
+    }
+
+    sensors_waiting++;
+    bool taken = xSemaphoreTakeRecursive(mutex, SENSOR_LOCK_TIMEOUT) == pdTRUE;
+    sensors_waiting--;
+
+    if(!taken) {
+      counters.errors++;
+    }
+    return taken;
+  }
+
+  void I2cBus::apply(const PinConfig& config) {
+    if(started && current.sda == config.sda && current.scl == config.scl) {
+      if(current.frequency != config.frequency) {
+        wire.setClock(config.frequency);
+        current.frequency = config.frequency;
+      }
+      return;
+    }
+
+    if(started && remap(config)) {
+      counters.remaps++;
+      return;
+    }
+
+    if(started) {
+      wire.end();
+      counters.reconfigurations++;
+    }
+    started = wire.begin(config.sda, config.scl, config.frequency);
+    current = config;
+  }
+
+  // Moves the running controller to other pins through the GPIO matrix,
+  // the driver and its clock setup stay installed. The pins left behind
+  // go back to plain inputs with pull-ups, so their bus idles high.
+  bool I2cBus::remap(const PinConfig& config) {
+    if(i2c_set_pin(static_cast<i2c_port_t>(port), config.sda, config.scl, true, true, I2C_MODE_MASTER) != ESP_OK) {
+      return false;
+    }
+    if(current.sda != config.sda && current.sda != config.scl) {
+      gpio_reset_pin(static_cast<gpio_num_t>(current.sda));
+    }
+    if(current.scl != config.sda && current.scl != config.scl) {
+      gpio_reset_pin(static_cast<gpio_num_t>(current.scl));
+    }
+    if(current.frequency != config.frequency) {
+      wire.setClock(config.frequency);
+    }
+    current = config;
+    return true;
+  }
+
+  bool I2cBus::begin(int sda, int scl, uint32_t frequency) {
+    if(!lock(I2cPriority::SENSOR)) {
+      return false;
+    }
+    home = {sda, scl, frequency};
+    apply(home);
+    xSemaphoreGiveRecursive(mutex);
+    return started;
+  }
+
+  bool I2cBus::beginSlave(uint8_t address, int sda, int scl, uint32_t frequency) {
+    if(!lock(I2cPriority::SENSOR)) {
+      return false;
+    }
+    if(started) {
+      wire.end();
+    }
+    slave = wire.begin(address, sda, scl, frequency);
+    started = false;
+    xSemaphoreGiveRecursive(mutex);
+    return slave;
+  }
+
+  bool I2cBus::acquire(I2cPriority priority) {
+    if(slave || !lock(priority)) {
+      return false;
+    }
+    if(depth == 0 && home.sda >= 0) {
+      apply(home);
+    }
+    if(depth++ == 0) {
+      acquired_at = esp_timer_get_time();
+      counters.transactions++;
+    }
+    return true;
+  }
+
+  bool I2cBus::acquire(I2cPriority priority, int sda, int scl, uint32_t frequency) {
+    if(slave || !lock(priority)) {
+      return false;
+    }
+    apply({sda, scl, frequency});
+    if(depth++ == 0) {
+      acquired_at = esp_timer_get_time();
+      counters.transactions++;
+    }
+    return true;
+  }
+
+  void I2cBus::release(bool error) {
+    if(error) {
+      counters.errors++;
+    }
+    if(--depth == 0) {
+      counters.busy_us += esp_timer_get_time() - acquired_at;
+    }
+    xSemaphoreGiveRecursive(mutex);
+  }
+
+  I2cBusStats I2cBus::stats() {
+    I2cBusStats result = counters;
+    result.window_us = esp_timer_get_time() - window_start;
+    return result;
+  }
+
+  void I2cBus::resetStats() {
+    counters = I2cBusStats();
+    window_start = esp_timer_get_time();
+  }
+
+  I2cTransaction::I2cTransaction(I2cBus& bus, I2cPriority priority) :
+    bus(bus), acquired(bus.acquire(priority)) {}
+
+  I2cTransaction::I2cTransaction(I2cBus& bus, I2cPriority priority, int sda, int scl, uint32_t frequency) :
+    bus(bus), acquired(bus.acquire(priority, sda, scl, frequency)) {}
+
+  I2cTransaction::~I2cTransaction() {
+    if(acquired) {
+      bus.release(failed);
+    }
+  }
+
+  I2cBus& i2cBus(uint8_t port) {
+    static I2cBus bus0(Wire, 0);
+    static I2cBus bus1(Wire1, 1);
+    return port ? bus1 : bus0;
+  }
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <atomic>
+
+namespace fg {
+
+  // Sensor transactions always win against display frames. A display
+  // frame is skipped (and counted) instead of waiting for the bus.
+  enum class I2cPriority : uint8_t {
+    SENSOR,
+    DISPLAY
+  };
+
+  struct I2cBusStats {
+    uint32_t transactions = 0;
+    uint32_t errors = 0;
+    uint32_t reconfigurations = 0; // driver reinstalled
+    uint32_t remaps = 0;           // pins switched on the running driver
+    uint32_t skipped = 0;
+    uint64_t busy_us = 0;
+    uint64_t window_us = 0;
+
+    float utilisation() const {
+      return window_us ? (float)busy_us / (float)window_us : 0.0f;
+    }
+  };
+
+  class I2cBus {
+    struct PinConfig {
+      int sda;
+      int scl;
+      uint32_t frequency;
+    };
+
+    TwoWire& wire;
+    const uint8_t port;
+    SemaphoreHandle_t mutex = NULL;
+    std::atomic<uint32_t> sensors_waiting{0};
+
+    PinConfig home = {-1, -1, 0};
+    PinConfig current = {-1, -1, 0};
+    bool started = false;
+    bool slave = false;
+
+    unsigned depth = 0;
+    int64_t acquired_at = 0;
+    int64_t window_start = 0;
+    I2cBusStats counters;
+
+    bool lock(I2cPriority priority);
+    void apply(const PinConfig& config);
+    bool remap(const PinConfig& config);
+
+  public:
+    I2cBus(TwoWire& wire, uint8_t port);
+
+    bool begin(int sda, int scl, uint32_t frequency = 100000);
+    bool beginSlave(uint8_t address, int sda, int scl, uint32_t frequency);
+
+    bool acquire(I2cPriority priority);
+    bool acquire(I2cPriority priority, int sda, int scl, uint32_t frequency);
+    void release(bool error = false);
+
+    inline TwoWire& get() { return wire; }
+    inline bool isSlave() const { return slave; }
+
+    I2cBusStats stats();
+    void resetStats();
+  };
+
+  class I2cTransaction {
+    I2cBus& bus;
+    bool acquired;
+    bool failed = false;
+  public:
+    I2cTransaction(I2cBus& bus, I2cPriority priority);
+    I2cTransaction(I2cBus& bus, I2cPriority priority, int sda, int scl, uint32_t frequency);
+    ~I2cTransaction();
+
+    I2cTransaction(const I2cTransaction&) = delete;
+    I2cTransaction& operator=(const I2cTransaction&) = delete;
+
+    inline explicit operator bool() const { return acquired; }
+    inline TwoWire& wire() { return bus.get(); }
+    inline void fail() { failed = true; }
+  };
+
+  // Port 0 is Wire, port 1 is Wire1.
+  I2cBus& i2cBus(uint8_t port);
+
+}
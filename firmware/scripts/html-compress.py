@@ -1,29 +1,22 @@
 ###############################################################
-# compresses all files found in ..\..\tasmota\html_uncompressed
-# write compressed C code to    ..\..\tasmota\html_compressed
-# Instructions:
-# open a console, e.g. in vscode, open a 'terminal'
-# cd .\tools\unishox
-# run:
-# python compress-html-uncompressed.py
+# gzips all files found in ../html and writes them as PROGMEM
+# byte arrays to ../src/html_compressed/<file>.h
 #
-# The intent it to commit both uncompressed and compressed to the repo
-# else this script would need to be run at build.
+# run from the scripts directory:
+# python html-compress.py
 #
-# Example Tasmota code:
-# #ifdef USE_UNISHOX_COMPRESSION
-#   #include "./html_compressed/HTTP_SCRIPT_CONSOL.h"
-# #else
-#   #include "./html_uncompressed/HTTP_SCRIPT_CONSOL.h"
-# #endif
+# Both the html sources and the generated headers are committed,
+# so the firmware build does not depend on this script.
 #
+# The portal sends the bytes as they are with
+# "Content-Encoding: gzip", the ETag lets browsers revalidate
+# a cached copy with a 304 instead of loading it again.
 ###############################################################
 
 from os import listdir
 from os import path
-from datetime import datetime
-import base64
-import zlib
+import gzip
+import hashlib
 
 path_uncompressed = path.join('..','html')
 path_compressed   = path.join('..','src', 'html_compressed')
@@ -31,40 +24,38 @@ path_compressed   = path.join('..','src', 'html_compressed')
 files = listdir(path_uncompressed)
 
 totalIn = 0
-totalSaved = 0
+totalOut = 0
 
 for file in files:
-  f = open(path_uncompressed + path.sep + file, "r")
-  input = f.read()
+  f = open(path_uncompressed + path.sep + file, "rb")
+  in_bytes = f.read()
   f.close()
 
   const_name = file.upper()
   const_name = const_name.replace('.', '_')
 
-  # parsing and cleaning
+  print("####### Compressing " + path_uncompressed + path.sep + file)
 
-  print("####### Parsing input from " + path_uncompressed + path.sep + file)
-
-  in_bytes = bytearray(input, 'utf-8')
   in_len = len(in_bytes)
-
-  bytes = input.encode('ascii')
-  zbytes = zlib.compress(bytes)
-  out_bytes = base64.b64encode(bytes)
+  # mtime 0 keeps the output identical for identical input
+  out_bytes = gzip.compress(in_bytes, compresslevel=9, mtime=0)
   out_len = len(out_bytes)
+  etag = hashlib.sha1(in_bytes).hexdigest()[:16]
 
-  print(out_bytes)
+  totalIn += in_len
+  totalOut += out_len
 
   def chunked(my_list, n):
       return [my_list[i * n:(i + 1) * n] for i in range((len(my_list) + n - 1) // n )]
 
-  # split in chunks of 20 characters
-  chunks = chunked(out_bytes, 80)
-
-  lines_raw = [ "\t\"" + chunk.decode('ascii') + "\"" for chunk in chunks ]
+  # 16 bytes per line
+  lines_raw = [ "\t" + ", ".join("0x{:02x}".format(b) for b in chunk) for chunk in chunked(out_bytes, 16) ]
 
-  line_complete = "const char " + const_name + "_COMPRESSED" +"[] PROGMEM = \n\t" + ("\n\t").join(lines_raw) + ";"
-  lines = "\nconst size_t " + const_name +"_SIZE = {size};\n{lines}\n\n".format(size=in_len, lines=line_complete)
+  line_complete = "const uint8_t " + const_name + "_GZ[] PROGMEM = {\n" + (",\n").join(lines_raw) + "\n};"
+  lines = "\nconst size_t " + const_name + "_SIZE = {size};\n".format(size=in_len)
+  lines = lines + "const size_t " + const_name + "_GZ_SIZE = {size};\n".format(size=out_len)
+  lines = lines + "const char " + const_name + "_ETAG[] = \"\\\"{etag}\\\"\";\n".format(etag=etag)
+  lines = lines + line_complete + "\n\n"
 
   comment = "/////////////////////////////////////////////////////////////////////\n"
   comment = comment + "// compressed by scripts/html-compress.py \n"
@@ -73,6 +64,6 @@ for file in files:
   f = open(path_compressed + path.sep + file + '.h', "w")
   f.write(comment + lines)
   f.close()
-  print("####### Wrote output to " + path_compressed + path.sep + file)
+  print("####### Wrote " + path_compressed + path.sep + file + ".h, " + str(in_len) + " -> " + str(out_len) + " bytes")
 
-print("If all files are in use, total saving was "+str(totalSaved)+" out of "+str(totalIn))
+print("total " + str(totalIn) + " bytes compressed to " + str(totalOut))
@@ -0,0 +1,74 @@
+#include "brokerlist.h"
+
+#include <stdlib.h>
+
+namespace fg {
+
+  void BrokerList::parse(const std::string& list, uint16_t default_port) {
+    brokers.clear();
+    current = 0;
+
+    size_t begin = 0;
+    while(begin <= list.size()) {
+      auto end = list.find(',', begin);
+      end = end == std::string::npos ? list.size() : end;
+      auto entry = list.substr(begin, end - begin);
+      begin = end + 1;
+
+      // surrounding spaces are ignored
+      auto first = entry.find_first_not_of(' ');
+      if(first == std::string::npos) {
+        continue;
+      }
+      entry = entry.substr(first, entry.find_last_not_of(' ') - first + 1);
+
+      Broker broker{entry, default_port};
+      auto colon = entry.rfind(':');
+      if(colon != std::string::npos) {
+        auto port = atoi(entry.c_str() + colon + 1);
+        if(port > 0 && port <= 65535) {
+          broker.host = entry.substr(0, colon);
+          broker.port = port;
+        }
+      }
+      if(broker.host.size()) {
+        brokers.push_back(broker);
+      }
+    }
+  }
+
+  bool BrokerList::update(bool connected, TickType_t now) {
+    if(connected) {
+      this->connected = true;
+      since = now;
+      return false;
+    }
+    if(this->connected) {
+      // just lost, the active broker gets the full timeout to come back
+      this->connected = false;
+      since = now;
+      return false;
+    }
+    if(brokers.size() < 2 || now - since < FAILOVER_TIMEOUT) {
+      return false;
+    }
+    select((current + 1) % brokers.size(), now);
+    return true;
+  }
+
+  bool BrokerList::probeDue(TickType_t now) {
+    if(!connected || current == 0 || now - last_probe < PROBE_INTERVAL) {
+      return false;
+    }
+    last_probe = now;
+    return true;
+  }
+
+  void BrokerList::select(size_t index, TickType_t now) {
+    current = index < brokers.size() ? index : 0;
+    connected = false;
+    since = now;
+    last_probe = now;
+  }
+
+}
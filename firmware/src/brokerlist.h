@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+namespace fg {
+
+  // Ordered brokers of the direct MQTT mode, the first one is preferred.
+  // When the active broker stays unreachable the next one is selected.
+  // While a fallback is active the preferred ones are health checked now
+  // and then, so the device returns as soon as one of them is back.
+  class BrokerList {
+  public:
+    struct Broker {
+      std::string host;
+      uint16_t port;
+    };
+
+    static constexpr TickType_t FAILOVER_TIMEOUT = configTICK_RATE_HZ * 10;
+    static constexpr TickType_t PROBE_INTERVAL = configTICK_RATE_HZ * 60;
+
+  private:
+    std::vector<Broker> brokers;
+    size_t current = 0;
+    bool connected = false;
+    TickType_t since = 0;
+    TickType_t last_probe = 0;
+
+  public:
+    // "host[:port],host[:port],...", entries without a port use the default
+    void parse(const std::string& list, uint16_t default_port);
+
+    inline size_t size() const { return brokers.size(); }
+    inline size_t activeIndex() const { return current; }
+    inline const Broker& active() const { return brokers[current]; }
+    inline const Broker& operator[](size_t index) const { return brokers[index]; }
+
+    // Feeds the connection state, returns true if another broker was
+    // selected and the client has to switch to it.
+    bool update(bool connected, TickType_t now);
+
+    // true if the preferred brokers should be health checked now
+    bool probeDue(TickType_t now);
+
+    void select(size_t index, TickType_t now);
+  };
+
+}
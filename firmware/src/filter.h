@@ -0,0 +1,234 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace fg {
+
+  // Sample storage for the windowed filters. FloatSample keeps full
+  // precision, Fixed16<scale> stores value * scale in an int16_t and halves
+  // the RAM of long windows (Fixed16<100> covers -327.68 .. 327.67 with two
+  // decimals, plenty for humidity and temperature).
+  struct FloatSample {
+    typedef float type;
+    typedef float sum_type;
+    static constexpr bool exact = false;
+
+    static inline type encode(float value) { return value; }
+    static inline float decode(type value) { return value; }
+    static inline float decodeSum(sum_type sum) { return sum; }
+  };
+
+  template<int scale>
+  struct Fixed16 {
+    typedef int16_t type;
+    typedef int32_t sum_type;
+    static constexpr bool exact = true;
+
+    static inline type encode(float value) {
+      float scaled = value * (float)scale;
+      scaled = scaled < -32768.0f ? -32768.0f : scaled > 32767.0f ? 32767.0f : scaled;
+      return (type)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+    }
+    static inline float decode(type value) { return (float)value / (float)scale; }
+    static inline float decodeSum(sum_type sum) { return (float)sum / (float)scale; }
+  };
+
+  // Moving average over the last size samples with a running sum, push()
+  // and avg() are O(1). Float sums are rebuilt once per window to keep
+  // rounding errors from accumulating, integer sums are exact.
+  template<int size, typename Storage = FloatSample>
+  class Avg {
+    typedef typename Storage::type sample_type;
+    typedef typename Storage::sum_type sum_type;
+
+    sample_type samples[size];
+    sum_type sum = 0;
+    unsigned position = 0;
+    unsigned filled = 0;
+
+  public:
+    void push(float value) {
+      auto sample = Storage::encode(value);
+      if(filled == size) {
+        sum -= samples[position];
+      }
+      else {
+        filled++;
+      }
+      samples[position++] = sample;
+      sum += sample;
+
+      if(position == size) {
+        position = 0;
+        if(!Storage::exact) {
+          sum = 0;
+          for(unsigned i = 0; i < filled; i++) {
+            sum += samples[i];
+          }
+        }
+      }
+    }
+
+    float avg() const {
+      return filled ? Storage::decodeSum(sum) / (float)filled : 0.0f;
+    }
+
+    float last() const {
+      return filled ? Storage::decode(samples[position ? position - 1 : size - 1]) : 0.0f;
+    }
+
+    unsigned count() const { return filled; }
+
+    void clear() {
+      sum = 0;
+      position = 0;
+      filled = 0;
+    }
+  };
+
+  // Exponential moving average, value += factor * (sample - value). The
+  // first sample primes it, so it does not ramp up from zero.
+  class Ema {
+    const float factor;
+    float current = 0.0f;
+    bool primed = false;
+
+  public:
+    explicit Ema(float factor) : factor(factor) {}
+
+    float push(float value) {
+      current = primed ? current + factor * (value - current) : value;
+      primed = true;
+      return current;
+    }
+
+    float value() const { return current; }
+
+    void clear() {
+      current = 0.0f;
+      primed = false;
+    }
+  };
+
+  // Minimum and maximum of the last size samples using two monotonic
+  // queues, amortised O(1) per push and O(1) per query.
+  template<int size, typename Storage = FloatSample>
+  class WindowMinMax {
+    typedef typename Storage::type sample_type;
+
+    struct Entry {
+      sample_type value;
+      uint32_t index;
+    };
+
+    struct Queue {
+      Entry entries[size];
+      unsigned head = 0;
+      unsigned length = 0;
+
+      inline Entry& front() { return entries[head]; }
+      inline const Entry& front() const { return entries[head]; }
+      inline Entry& back() { return entries[(head + length - 1) % size]; }
+      inline void popFront() { head = (head + 1) % size; length--; }
+      inline void popBack() { length--; }
+      inline void pushBack(const Entry& entry) { entries[(head + length++) % size] = entry; }
+    };
+
+    Queue minimum;
+    Queue maximum;
+    uint32_t pushed = 0;
+
+  public:
+    void push(float value) {
+      Entry entry = {Storage::encode(value), pushed++};
+
+      while(minimum.length && minimum.front().index + size < pushed) {
+        minimum.popFront();
+      }
+      while(maximum.length && maximum.front().index + size < pushed) {
+        maximum.popFront();
+      }
+
+      while(minimum.length && minimum.back().value >= entry.value) {
+        minimum.popBack();
+      }
+      while(maximum.length && maximum.back().value <= entry.value) {
+        maximum.popBack();
+      }
+      minimum.pushBack(entry);
+      maximum.pushBack(entry);
+    }
+
+    float min() const { return minimum.length ? Storage::decode(minimum.front().value) : 0.0f; }
+    float max() const { return maximum.length ? Storage::decode(maximum.front().value) : 0.0f; }
+
+    void clear() {
+      minimum = Queue();
+      maximum = Queue();
+      pushed = 0;
+    }
+  };
+
+  // Median of the last size samples. The window is kept sorted next to the
+  // ring buffer, so push() is a binary search plus one memmove and
+  // median() is O(1).
+  template<int size, typename Storage = FloatSample>
+  class Median {
+    typedef typename Storage::type sample_type;
+
+    sample_type samples[size];
+    sample_type sorted[size];
+    unsigned position = 0;
+    unsigned filled = 0;
+
+    unsigned lowerBound(sample_type value) const {
+      unsigned low = 0;
+      unsigned high = filled;
+      while(low < high) {
+        unsigned mid = (low + high) / 2;
+        if(sorted[mid] < value) {
+          low = mid + 1;
+        }
+        else {
+          high = mid;
+        }
+      }
+      return low;
+    }
+
+  public:
+    void push(float value) {
+      auto sample = Storage::encode(value);
+      if(filled == size) {
+        auto index = lowerBound(samples[position]);
+        memmove(&sorted[index], &sorted[index + 1], (filled - index - 1) * sizeof(sample_type));
+        filled--;
+      }
+
+      auto index = lowerBound(sample);
+      memmove(&sorted[index + 1], &sorted[index], (filled - index) * sizeof(sample_type));
+      sorted[index] = sample;
+      filled++;
+
+      samples[position++] = sample;
+      position = position == size ? 0 : position;
+    }
+
+    float median() const {
+      if(!filled) {
+        return 0.0f;
+      }
+      if(filled & 1) {
+        return Storage::decode(sorted[filled / 2]);
+      }
+      return (Storage::decode(sorted[filled / 2 - 1]) + Storage::decode(sorted[filled / 2])) / 2.0f;
+    }
+
+    void clear() {
+      position = 0;
+      filled = 0;
+    }
+  };
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace fg {
+
+  // Signed Q16.16 fixed point number, range -32768 .. 32767.99998 with a
+  // resolution of 1/65536. Products are rounded to the nearest step.
+  class Q16_16 {
+    int32_t raw = 0;
+
+    static constexpr Q16_16 fromRaw(int32_t value) { return Q16_16(value, 0); }
+    constexpr Q16_16(int32_t value, int) : raw(value) {}
+
+  public:
+    static constexpr int32_t ONE = 1 << 16;
+
+    constexpr Q16_16() {}
+    constexpr Q16_16(int value) : raw(value * ONE) {}
+    constexpr Q16_16(float value) : raw((int32_t)(value * ONE + (value < 0 ? -0.5f : 0.5f))) {}
+    constexpr Q16_16(double value) : raw((int32_t)(value * ONE + (value < 0 ? -0.5 : 0.5))) {}
+
+    constexpr explicit operator float() const { return (float)raw / (float)ONE; }
+    constexpr int32_t toRaw() const { return raw; }
+
+    constexpr Q16_16 operator-() const { return fromRaw(-raw); }
+    constexpr Q16_16 operator+(Q16_16 other) const { return fromRaw(raw + other.raw); }
+    constexpr Q16_16 operator-(Q16_16 other) const { return fromRaw(raw - other.raw); }
+    constexpr Q16_16 operator*(Q16_16 other) const {
+      return fromRaw((int32_t)(((int64_t)raw * other.raw + (ONE >> 1)) >> 16));
+    }
+
+    Q16_16& operator+=(Q16_16 other) { raw += other.raw; return *this; }
+    Q16_16& operator-=(Q16_16 other) { raw -= other.raw; return *this; }
+
+    constexpr bool operator<(Q16_16 other) const { return raw < other.raw; }
+    constexpr bool operator>(Q16_16 other) const { return raw > other.raw; }
+    constexpr bool operator<=(Q16_16 other) const { return raw <= other.raw; }
+    constexpr bool operator>=(Q16_16 other) const { return raw >= other.raw; }
+    constexpr bool operator==(Q16_16 other) const { return raw == other.raw; }
+    constexpr bool operator!=(Q16_16 other) const { return raw != other.raw; }
+  };
+
+}
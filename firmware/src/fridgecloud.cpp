@@ -1,5 +1,6 @@
 #include <memory>
 #include <queue>
+#include <algorithm>
 #include <sstream>
 #include <EspMQTTClient.h>
 #include <HTTPClient.h>
@@ -31,7 +32,7 @@ namespace fg {
 
   void Fridgecloud::init() {
 
-    SettingsManager provisioning(NVS_PART, "fg_provisioning");
+    SettingsManager& provisioning = fg::provisioning();
 
     if(fg::settings().getU8("mqtt_enabled")) {
       device_id = fg::settings().getStr("mqtt_id");
@@ -40,6 +41,9 @@ namespace fg {
       mqtt_port = fg::settings().getStr("mqtt_port");
       mqtt_password = fg::settings().getStr("mqtt_pass");
       custom_mqtt = true;
+
+      // mqtt_server may name several brokers, the first one is preferred
+      brokers.parse(mqtt_host, atoi(mqtt_port.c_str()));
     }
     else {
 
@@ -89,20 +93,48 @@ namespace fg {
       device_id.c_str()     // Client name that uniquely identify your device
     ));
 
+    // device_id is a stable client id, the broker can keep the session
+    // across reconnects
+    client->enableMQTTPersistence(SESSION_EXPIRY);
+
+    // bulk samples go out QoS 1, several at once
+    client->setMaxInflight(BULK_INFLIGHT);
+    client->setPublishAckCallback([this](uint16_t msg_id) {
+      statusAcknowledged(msg_id);
+    });
+
+    if(custom_mqtt) {
+      // state topics repeat with every status, MQTT 5 replaces them with
+      // short aliases. The buffer size is announced in the CONNECT.
+      client->setMaxPacketSize(MAX_PACKET_SIZE);
+      client->enableMQTT5();
+    }
+
+    if(brokers.size()) {
+      useActiveBroker();
+      if(brokers.size() > 1) {
+        client->setMqttReconnectionAttemptDelay(BROKER_RETRY_DELAY);
+      }
+    }
+
     log("message-device-booted");
   }
 
   void Fridgecloud::connect() {
     Serial.println("connecting to cloud");
 
-    client->setMaxPacketSize(1024);
+    client->setMaxPacketSize(MAX_PACKET_SIZE);
+
+    // commands and configuration use QoS 1, so a persistent session keeps
+    // what arrives while the device is offline
+    subscribed = true;
 
-    client->subscribe(topic_configuration.c_str(), [&](const String & topic, const String & payload) {
+    subscribed &= client->subscribe(topic_configuration.c_str(), [&](const String & topic, const String & payload) {
       Serial.println("new config");
       config_subject.next(payload);
-    });
+    }, SUBSCRIBE_QOS);
 
-    client->subscribe(topic_firmware.c_str(), [&](const String & topic, const String & payload) {
+    subscribed &= client->subscribe(topic_firmware.c_str(), [&](const String & topic, const String & payload) {
       Serial.println("loading firmware: " + payload);
 #ifndef NO_FIRMWARE_UPDATE
       if(payload != FIRMWARE_VERSION) {
@@ -111,9 +143,9 @@ namespace fg {
         updateFirmware(payload.c_str());
       }
 #endif
-    });
+    }, SUBSCRIBE_QOS);
 
-    client->subscribe(topic_fwupdate.c_str(), [&](const String & topic, const String & payload) {
+    subscribed &= client->subscribe(topic_fwupdate.c_str(), [&](const String & topic, const String & payload) {
       DynamicJsonDocument doc(1024);
       DeserializationError error = deserializeJson(doc, payload);
       if (error) {
@@ -129,9 +161,10 @@ namespace fg {
         updateFirmwareFromUrl(doc["url"]);
       }
 #endif
-    });
+    }, SUBSCRIBE_QOS);
 
-    client->subscribe(topic_command.c_str(), [&](const String & topic, const String & payload) {
+    // parsed straight from the connection, no copy of the payload
+    subscribed &= client->subscribe(topic_command.c_str(), [&](const String & topic, Stream & payload, uint32_t) {
       DynamicJsonDocument doc(1024);
       DeserializationError error = deserializeJson(doc, payload);
       if (error) {
@@ -140,14 +173,15 @@ namespace fg {
       }
 
       command_subject.next(doc);
-    });
+    }, SUBSCRIBE_QOS);
 
-    client->subscribe(topic_control.c_str(), [&](const String & topic, const String & payload) {
+    subscribed &= client->subscribe(topic_control.c_str(), [&](const String & topic, const String & payload) {
       auto output = topic.substring(topic_control.length() - 1);      
       control_subject.next(std::pair<std::string, std::string>(output.c_str(), payload.c_str()));
-    });
+    }, SUBSCRIBE_QOS);
 
-    client->subscribe(topic_tunnel_write.c_str(), [&](const String & topic, const String & payload) {
+    // tunnel data is only useful live, it is not queued for the session
+    subscribed &= client->subscribe(topic_tunnel_write.c_str(), [&](const String & topic, Stream & payload, uint32_t) {
       DynamicJsonDocument doc(1024);
       DeserializationError error = deserializeJson(doc, payload);
       if (error) {
@@ -246,9 +280,25 @@ namespace fg {
 
   void Fridgecloud::loop() {
     client->loop();
+    if(brokers.size() > 1) {
+      checkBrokers();
+    }
     if(connected != client->isMqttConnected()) {
       connected = client->isMqttConnected();
       if(connected) {
+        // acknowledgements of the old connection never come, unacknowledged
+        // samples go out again
+        for(auto& status : status_buffer) {
+          status.msg_id = 0;
+        }
+      }
+      if(connected && subscribed && client->isMqttSessionPresent()) {
+        // the broker kept subscriptions and queued messages, the
+        // configuration does not need to be fetched again
+        Serial.println("reconnected to mqtt server, session resumed.");
+        replayState();
+      }
+      else if(connected) {
         Serial.println("(re)connected to mqtt server.");
         StaticJsonDocument<1024> message_json;
         message_json["firmware_id"] = FIRMWARE_VERSION;
@@ -257,6 +307,7 @@ namespace fg {
 
         client->publish(topic_fetch.c_str(), stream.str().c_str());
         connect();
+        replayState();
       }
       else {
         Serial.println("lost connection to mqtt server.");
@@ -266,6 +317,10 @@ namespace fg {
       handleTunnelCloses();
       handleTunnelReads();
 
+      if(statusPending()) {
+        uploadStatus();
+      }
+
       while(log_queue.size()) {
         StaticJsonDocument<1024> message_json;
         message_json["severity"] = log_queue.front().second;
@@ -289,6 +344,9 @@ namespace fg {
     struct tm * ptm;
     struct tm timeinfo;
     static bool overflow = false;
+    static bool oversized = false;
+
+    status_subject.next(status);
 
     if(!custom_mqtt) {
       if(++current_sample >= SAMPLE_INTERVAL) {
@@ -310,9 +368,19 @@ namespace fg {
 
           std::stringstream stream;
           serializeJson(status, stream);
-          status_buffer.push_back(stream.str());
+          // would fail on every retry and hold back the samples after it
+          if(!fitsBulkPacket(stream.str().size())) {
+            if(!oversized) {
+              oversized = true;
+              Serial.printf("status of %u bytes does not fit a packet, dropped\n\r", static_cast<unsigned>(stream.str().size()));
+              log("message-status-too-large", 1);
+            }
+          }
+          else {
+            status_buffer.push_back({stream.str(), 0});
+          }
 
-          if(status_buffer.size() >= UPLOAD_INTERVAL) {
+          if(status_buffer.size() >= UPLOAD_INTERVAL && statusPending()) {
             uploadStatus();
           }
         }
@@ -327,37 +395,171 @@ namespace fg {
     else {
       for(auto kv : status["sensors"].as<JsonObject>()) {
         auto topic = topic_status + "/sensors/" + kv.key().c_str();
-        client->publish(topic.c_str(), kv.value());
+        publishState(topic, kv.value());
       }
       for(auto kv : status["outputs"].as<JsonObject>()) {
         auto topic = topic_status + "/outputs/" + kv.key().c_str();
-        client->publish(topic.c_str(), kv.value());
+        publishState(topic, kv.value());
       }
       return true;
     }
   }
 
+  void Fridgecloud::publishState(const String& topic, const String& payload) {
+    if(connected && publishAliased(topic, payload)) {
+      unsent_state.erase(topic);
+      return;
+    }
+    // only the latest value of a topic is worth replaying
+    unsent_state[topic] = payload;
+  }
+
+  void Fridgecloud::replayState() {
+    if(unsent_state.size()) {
+      Serial.printf("replaying %u unsent states\n\r", unsent_state.size());
+    }
+    for(auto it = unsent_state.begin(); it != unsent_state.end();) {
+      if(!publishAliased(it->first, it->second)) {
+        return;
+      }
+      it = unsent_state.erase(it);
+    }
+  }
+
+  bool Fridgecloud::publishAliased(const String& topic, const String& payload) {
+    if(alias_connection != client->getConnectionEstablishedCount()) {
+      alias_connection = client->getConnectionEstablishedCount();
+      topic_aliases.clear();
+    }
+
+    auto alias = topic_aliases.find(topic);
+    if(alias != topic_aliases.end()) {
+      return client->publish("", payload, false, alias->second);
+    }
+
+    // the first publish of a topic assigns the next free alias
+    uint16_t next = topic_aliases.size() + 1;
+    if(next > client->getMqttTopicAliasMaximum()) {
+      return client->publish(topic, payload);
+    }
+    if(!client->publish(topic, payload, false, next)) {
+      return false;
+    }
+    topic_aliases[topic] = next;
+    return true;
+  }
+
+  void Fridgecloud::useActiveBroker() {
+    auto& broker = brokers.active();
+    Serial.printf("mqtt broker %s:%u\n\r", broker.host.c_str(), broker.port);
+    client->setMqttServer(broker.host.c_str(), mqtt_user.c_str(), mqtt_password.c_str(), broker.port);
+  }
+
+  void Fridgecloud::checkBrokers() {
+    auto now = xTaskGetTickCount();
+    if(brokers.update(client->isMqttConnected(), now)) {
+      Serial.println("mqtt broker unreachable, failing over");
+      useActiveBroker();
+      client->reconnectMqtt();
+      return;
+    }
+
+    // on a fallback, go back to the first preferred broker that accepted
+    // connections again
+    if(!probe_running) {
+      int found = probe_found.exchange(-1);
+      if(found >= 0 && static_cast<size_t>(found) < brokers.activeIndex()) {
+        Serial.println("preferred mqtt broker is back");
+        brokers.select(found, now);
+        useActiveBroker();
+        client->reconnectMqtt();
+        return;
+      }
+    }
+
+    if(probe_running || !brokers.probeDue(now)) {
+      return;
+    }
+    probe_targets.clear();
+    for(size_t i = 0; i < brokers.activeIndex(); i++) {
+      probe_targets.push_back(brokers[i]);
+    }
+    probe_running = true;
+    if(xTaskCreate(runProbe, "broker_probe", BROKER_PROBE_STACK_SIZE, this, 1, NULL) != pdPASS) {
+      probe_running = false;
+    }
+  }
+
+  void Fridgecloud::runProbe(void* arg) {
+    auto cloud = static_cast<Fridgecloud*>(arg);
+    for(size_t i = 0; i < cloud->probe_targets.size(); i++) {
+      auto& broker = cloud->probe_targets[i];
+      WiFiClient probe;
+      if(probe.connect(broker.host.c_str(), broker.port, BROKER_PROBE_TIMEOUT)) {
+        probe.stop();
+        cloud->probe_found = i;
+        break;
+      }
+    }
+    cloud->probe_running = false;
+    vTaskDelete(NULL);
+  }
+
   void Fridgecloud::uploadStatus() {
-    Serial.println("Uploading bulk status");
     if(!connected) {
-      Serial.println("not connected to mqtt!");
       return;
     }
 
     try {
-      while(status_buffer.size()) {
-        if(!client->publish(topic_bulk.c_str(), status_buffer[0].c_str())) {
-          Serial.println("mqtt publish error");
+      // samples are released in statusAcknowledged()
+      for(auto& status : status_buffer) {
+        if(status.msg_id) {
+          continue;
+        }
+        if(client->getMqttInflightCount() >= client->getMqttMaxInflight()) {
+          break;
+        }
+        if(!client->publish(topic_bulk.c_str(), status.json.c_str(), false, 1, &status.msg_id)) {
+          if(!bulk_failed) {
+            Serial.println("mqtt publish error");
+          }
+          bulk_failed = true;
+          bulk_failed_at = xTaskGetTickCount();
           return;
         }
-        status_buffer.erase(status_buffer.begin());
+        bulk_failed = false;
       }
-      status_buffer.clear();
     }
     catch(...) {
       Serial.println("exception uploading status!");
     }
-    Serial.println("uploadStatus done");
+  }
+
+  bool Fridgecloud::statusPending() {
+    if(bulk_failed && xTaskGetTickCount() - bulk_failed_at < BULK_RETRY_DELAY) {
+      return false;
+    }
+    if(client->getMqttInflightCount() >= client->getMqttMaxInflight()) {
+      return false;
+    }
+    return std::any_of(status_buffer.begin(), status_buffer.end(), [](const BufferedStatus& status) {
+      return status.msg_id == 0;
+    });
+  }
+
+  bool Fridgecloud::fitsBulkPacket(size_t payload_size) const {
+    // QoS 1 publish as PubSubClient::publishPacket() builds it, with room
+    // for the empty MQTT 5 property list
+    return MQTT_MAX_HEADER_SIZE + 2 + topic_bulk.length() + 2 + 1 + payload_size <= MAX_PACKET_SIZE;
+  }
+
+  void Fridgecloud::statusAcknowledged(uint16_t msg_id) {
+    auto status = std::find_if(status_buffer.begin(), status_buffer.end(), [msg_id](const BufferedStatus& status) {
+      return status.msg_id == msg_id;
+    });
+    if(status != status_buffer.end()) {
+      status_buffer.erase(status);
+    }
   }
 
   void Fridgecloud::updateConfig(const char* data) {
@@ -484,7 +686,7 @@ namespace fg {
 
   bool Fridgecloud::registerWithCloud(std::string api_url, std::string password) {
     HTTPClient http;
-    SettingsManager provisioning(NVS_PART, "fg_provisioning");
+    SettingsManager& provisioning = fg::provisioning();
 
     std::string url = api_url + "/device/register";
     http.begin(url.c_str());
@@ -8,8 +8,11 @@
 #include "fghmi.h"
 #include "settings.h"
 #include "observeable.h"
+#include "brokerlist.h"
 #include "ArduinoJson.h"
 #include <array>
+#include <map>
+#include <atomic>
 
 #define NVS_PART "nvs_ro"
 
@@ -24,6 +27,14 @@ namespace fg {
     static constexpr unsigned int MAX_BUFFER_LEN = 120;
     static constexpr unsigned int SAMPLE_INTERVAL = 5;
     static constexpr unsigned int UPLOAD_INTERVAL = 1;
+    static constexpr unsigned int BROKER_RETRY_DELAY = 3000; // ms, several attempts fit into the failover timeout
+    static constexpr int32_t BROKER_PROBE_TIMEOUT = 300; // ms
+    static constexpr uint32_t BROKER_PROBE_STACK_SIZE = 4096;
+    static constexpr uint8_t SUBSCRIBE_QOS = 1;
+    static constexpr uint8_t BULK_INFLIGHT = 4; // bulk publishes waiting for their PUBACK at once
+    static constexpr TickType_t BULK_RETRY_DELAY = configTICK_RATE_HZ * 5; // after a failed bulk publish
+    static constexpr uint16_t MAX_PACKET_SIZE = 1024;
+    static constexpr uint32_t SESSION_EXPIRY = 60 * 60 * 24; // s, how long an MQTT 5 broker keeps the session of an offline device
 
     std::unique_ptr<EspMQTTClient> client;
     std::queue<std::pair<std::string, unsigned int>> log_queue;
@@ -52,14 +63,36 @@ namespace fg {
     Subject<JsonDocument> command_subject;
     Subject<bool> update_subject;
     Subject<std::pair<std::string,std::string>> control_subject;
+    Subject<JsonDocument> status_subject;
 
     bool custom_mqtt = false;
-
-    std::vector<std::string> status_buffer;
+    BrokerList brokers;
+    // direct mode state that did not reach a broker yet, newest value per topic
+    std::map<String, String> unsent_state;
+    // MQTT 5 topic aliases of the state topics, they only live as long as
+    // the connection they were assigned on
+    std::map<String, uint16_t> topic_aliases;
+    unsigned int alias_connection = 0;
+    // The preferred brokers are probed on a task of their own, a connect
+    // blocks for the DNS lookup and up to BROKER_PROBE_TIMEOUT per broker.
+    // The targets are only touched while no probe runs.
+    std::vector<BrokerList::Broker> probe_targets;
+    std::atomic<bool> probe_running{false};
+    std::atomic<int> probe_found{-1}; // index of the first reachable target
+
+    // samples stay buffered until the broker acknowledged them
+    struct BufferedStatus {
+      std::string json;
+      uint16_t msg_id; // of the unacknowledged publish, 0 while unsent
+    };
+    std::vector<BufferedStatus> status_buffer;
+    bool bulk_failed = false;
+    TickType_t bulk_failed_at = 0;
 
     UserInterface& ui;
 
     bool connected = false;
+    bool subscribed = false; // all subscriptions of connect() went through
     unsigned int current_sample = 0;
 
     static constexpr int TUNNEL_COUNT = 3;
@@ -71,6 +104,16 @@ namespace fg {
     };
     std::array<Tunnel, TUNNEL_COUNT> tunnels;
 
+    void useActiveBroker();
+    void checkBrokers();
+    static void runProbe(void* arg);
+    void publishState(const String& topic, const String& payload);
+    bool publishAliased(const String& topic, const String& payload);
+    bool statusPending();
+    bool fitsBulkPacket(size_t payload_size) const;
+    void statusAcknowledged(uint16_t msg_id);
+    void replayState();
+
   public:
     Fridgecloud(UserInterface& ui) : ui(ui) {}
 
@@ -90,6 +133,11 @@ namespace fg {
       control_subject.subscribe(callback);
     }
 
+    // every status the controller reports, before it is buffered
+    template<class F> void onStatus(F&& callback) {
+      status_subject.subscribe(callback);
+    }
+
     std::string requestPairingCode();
     void init();
     void connect();
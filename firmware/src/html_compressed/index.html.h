@@ -2,96 +2,113 @@
 // compressed by scripts/html-compress.py 
 /////////////////////////////////////////////////////////////////////
 
-const size_t INDEX_HTML_SIZE = 5373;
-const char INDEX_HTML_COMPRESSED[] PROGMEM = 
-		"PGh0bWw+CiAgPGhlYWQ+CiAgICA8dGl0bGU+UGxhbnRhbHl0aXg8L3RpdGxlPgogICAgPG1ldGEgbmFt"
-		"ZT0idmlld3BvcnQiIGNvbnRlbnQ9IndpZHRoPWRldmljZS13aWR0aCwgaW5pdGlhbC1zY2FsZT0xLjAi"
-		"PgoKICAgIDxzdHlsZT4KCiAgICAgIGlucHV0W3R5cGU9dGV4dF0sIGlucHV0W3R5cGU9dXJsXSwgaW5w"
-		"dXRbdHlwZT1lbWFpbF0sIGlucHV0W3R5cGU9cGFzc3dvcmRdLCBpbnB1dFt0eXBlPXRlbF0gewogICAg"
-		"ICAgIC13ZWJraXQtYXBwZWFyYW5jZTogbm9uZTsgLW1vei1hcHBlYXJhbmNlOiBub25lOwogICAgICAg"
-		"IGRpc3BsYXk6IGJsb2NrOwogICAgICAgIG1hcmdpbjogMDsKICAgICAgICB3aWR0aDogMTAwJTsgaGVp"
-		"Z2h0OiA0MHB4OwogICAgICAgIGxpbmUtaGVpZ2h0OiA0MHB4OyBmb250LXNpemU6IDE3cHg7CiAgICAg"
-		"ICAgYm9yZGVyOiAxcHggc29saWQgI2JiYjsKICAgICAgfQoKICAgICAgYnV0dG9uIHsKICAgICAgICAt"
-		"d2Via2l0LWFwcGVhcmFuY2U6IG5vbmU7IC1tb3otYXBwZWFyYW5jZTogbm9uZTsKICAgICAgICBkaXNw"
-		"bGF5OiBibG9jazsKICAgICAgICBtYXJnaW46IDA7CiAgICAgICAgbWFyZ2luLXRvcDogNXB4OwogICAg"
-		"ICAgIHdpZHRoOiAxMDAlOyBoZWlnaHQ6IDQwcHg7CiAgICAgICAgbGluZS1oZWlnaHQ6IDQwcHg7IGZv"
-		"bnQtc2l6ZTogMTdweDsKICAgICAgICBib3JkZXI6IDFweCBzb2xpZCAjYmJiOwogICAgICB9CgogICAg"
-		"ICBodG1sIHsKICAgICAgICBmb250LWZhbWlseTogc2Fucy1zZXJpZjsKICAgICAgICBmb250LXNpemU6"
-		"IDEyMCU7CiAgICAgICAgbGluZS1oZWlnaHQ6IDE1MCU7CiAgICAgIH0KCiAgICAgIC5oaWRkZW4gewog"
-		"ICAgICAgIGRpc3BsYXk6IG5vbmUgIWltcG9ydGFudDsKICAgICAgfQoKICAgICAgLmJveCB7CiAgICAg"
-		"ICAgd2lkdGg6IDEwMCU7IGhlaWdodDogNjBweDsKICAgICAgICBkaXNwbGF5OiBmbGV4OwogICAgICAg"
-		"IGp1c3RpZnktY29udGVudDogY2VudGVyOwogICAgICAgIGZsZXgtZGlyZWN0aW9uOiBjb2x1bW47CiAg"
-		"ICAgICAgYm9yZGVyOiAxcHggc29saWQgI2JiYjsKICAgICAgICB0ZXh0LWFsaWduOiBjZW50ZXI7CiAg"
-		"ICAgICAgbWFyZ2luLXRvcDogNXB4OwogICAgICB9CgogICAgICAuZXJyb3IgewogICAgICAgIGJvcmRl"
-		"cjogMXB4IHNvbGlkICNjNjY7CiAgICAgICAgYmFja2dyb3VuZC1jb2xvcjogI2ZjYzsKICAgICAgfQoK"
-		"ICAgICAgLm9rIHsKICAgICAgICBib3JkZXI6IDFweCBzb2xpZCAjNmM2OwogICAgICAgIGJhY2tncm91"
-		"bmQtY29sb3I6ICNjZmM7CiAgICAgIH0KCiAgICA8L3N0eWxlPgoKICAgIDxzY3JpcHQ+CgogICAgICBm"
-		"dW5jdGlvbiBzZW5kQ29uZmlnKCkgewogICAgICAgIGxldCB1aSA9IGRvY3VtZW50LnF1ZXJ5U2VsZWN0"
-		"b3IoJyN3aWZpLXVpJyk7CiAgICAgICAgbGV0IGZvcm0gPSBkb2N1bWVudC5xdWVyeVNlbGVjdG9yKCcj"
-		"d2lmaScpOwogICAgICAgIGxldCBjb25uZWN0aW5nID0gZG9jdW1lbnQucXVlcnlTZWxlY3RvcignI2Nv"
-		"bm5lY3RpbmcnKTsKICAgICAgICBsZXQgY29ubmVjdGVkID0gZG9jdW1lbnQucXVlcnlTZWxlY3Rvcign"
-		"I2Nvbm5lY3RlZCcpOwogICAgICAgIGxldCBlcnJvciA9IGRvY3VtZW50LnF1ZXJ5U2VsZWN0b3IoJyNl"
-		"cnJvcicpOwoKICAgICAgICB1aS5jbGFzc0xpc3QuYWRkKCdoaWRkZW4nKTsKICAgICAgICBjb25uZWN0"
-		"ZWQuY2xhc3NMaXN0LmFkZCgnaGlkZGVuJyk7CiAgICAgICAgZXJyb3IuY2xhc3NMaXN0LmFkZCgnaGlk"
-		"ZGVuJyk7CiAgICAgICAgY29ubmVjdGluZy5jbGFzc0xpc3QucmVtb3ZlKCdoaWRkZW4nKTsKCiAgICAg"
-		"ICAgbGV0IGZvcm1fZGF0YSA9IG5ldyBGb3JtRGF0YShmb3JtKTsKICAgICAgICBsZXQgcGF5bG9hZCA9"
-		"IEpTT04uc3RyaW5naWZ5KHsKICAgICAgICAgIHByaW1hcnk6IHsKICAgICAgICAgICAgc3NpZDogZm9y"
-		"bV9kYXRhLmdldCgncHJpbWFyeS1zc2lkJyksCiAgICAgICAgICAgIHBhc3N3b3JkOiBmb3JtX2RhdGEu"
-		"Z2V0KCdwcmltYXJ5LXBhc3N3b3JkJyksCiAgICAgICAgICB9LAogICAgICAgICAgc2Vjb25kYXJ5OiB7"
-		"CiAgICAgICAgICAgIHNzaWQ6IGZvcm1fZGF0YS5nZXQoJ3NlY29uZGFyeS1zc2lkJyksCiAgICAgICAg"
-		"ICAgIHBhc3N3b3JkOiBmb3JtX2RhdGEuZ2V0KCdzZWNvbmRhcnktcGFzc3dvcmQnKSwKICAgICAgICAg"
-		"IH0sCiAgICAgICAgfSk7CgogICAgICAgIHZhciB4aHIgPSBuZXcgWE1MSHR0cFJlcXVlc3QoKTsKICAg"
-		"ICAgICB2YXIgaG9zdCA9IHdpbmRvdy5sb2NhdGlvbi5wcm90b2NvbCArICIvLyIgKyB3aW5kb3cubG9j"
-		"YXRpb24uaG9zdDsKICAgICAgICB2YXIgdXJsID0gaG9zdCArICIvY29uZmlnIjsKICAgICAgICB4aHIu"
-		"b3BlbigiUE9TVCIsIHVybCwgdHJ1ZSk7CgogICAgICAgIHhoci5vbmxvYWQgPSBmdW5jdGlvbigpIHsK"
-		"ICAgICAgICAgIGlmKHRoaXMucmVzcG9uc2VUZXh0ID09ICdvaycpIHsKICAgICAgICAgICAgY29ubmVj"
-		"dGluZy5jbGFzc0xpc3QuYWRkKCdoaWRkZW4nKTsKICAgICAgICAgICAgY29ubmVjdGVkLmNsYXNzTGlz"
-		"dC5yZW1vdmUoJ2hpZGRlbicpOwogICAgICAgICAgfQogICAgICAgICAgZWxzZSB7CiAgICAgICAgICAg"
-		"IGNvbm5lY3RpbmcuY2xhc3NMaXN0LmFkZCgnaGlkZGVuJyk7CiAgICAgICAgICAgIGVycm9yLmNsYXNz"
-		"TGlzdC5yZW1vdmUoJ2hpZGRlbicpOwogICAgICAgICAgICB1aS5jbGFzc0xpc3QucmVtb3ZlKCdoaWRk"
-		"ZW4nKTsKICAgICAgICAgIH0KICAgICAgICB9CgogICAgICAgIHhoci5zZW5kKHBheWxvYWQpOwogICAg"
-		"ICB9CgogICAgICBmdW5jdGlvbiBzY2FuV2lmaSgpIHsKICAgICAgICBsZXQgc2NhbiA9IGRvY3VtZW50"
-		"LnF1ZXJ5U2VsZWN0b3IoJyNzY2FuJyk7CiAgICAgICAgbGV0IGNvbnRlbnQgPSBkb2N1bWVudC5xdWVy"
-		"eVNlbGVjdG9yKCcjc2NhbmNvbnRlbnQnKTsKCiAgICAgICAgZG9jdW1lbnQucXVlcnlTZWxlY3Rvcign"
-		"I3NjYW5uaW5nJykuY2xhc3NMaXN0LnJlbW92ZSgnaGlkZGVuJykKCiAgICAgICAgY29udGVudC5pbm5l"
-		"ckhUTUwgPSAiIgoKICAgICAgICB2YXIgeGhyID0gbmV3IFhNTEh0dHBSZXF1ZXN0KCk7CiAgICAgICAg"
-		"dmFyIGhvc3QgPSB3aW5kb3cubG9jYXRpb24ucHJvdG9jb2wgKyAiLy8iICsgd2luZG93LmxvY2F0aW9u"
-		"Lmhvc3Q7CiAgICAgICAgdmFyIHVybCA9IGhvc3QgKyAiL3NjYW4iOwogICAgICAgIHhoci5vcGVuKCJH"
-		"RVQiLCB1cmwsIHRydWUpOwoKICAgICAgICB4aHIub25sb2FkID0gZnVuY3Rpb24oKSB7CiAgICAgICAg"
-		"ICBsZXQgd2lmaSA9IEpTT04ucGFyc2UodGhpcy5yZXNwb25zZVRleHQpCiAgICAgICAgICBpZih3aWZp"
-		"KSB7CiAgICAgICAgICAgIGZvcihsZXQgc3NpZCBvZiB3aWZpKSB7CiAgICAgICAgICAgICAgY29udGVu"
-		"dC5pbm5lckhUTUwgKz0gIjx0cj48dGQ+IiArIHNzaWQgKyAiPC90ZD48dGQgc3R5bGU9XCJ0ZXh0LWFs"
-		"aWduOiByaWdodDtcIj48YnV0dG9uIG9uY2xpY2s9XCJzZWxlY3RXaWZpKCciICsgc3NpZCArICInKVwi"
-		"PlNlbGVjdDwvYnV0dG9uPjwvdGQ+IgogICAgICAgICAgICB9CgogICAgICAgICAgICBzY2FuLmNsYXNz"
-		"TGlzdC5yZW1vdmUoJ2hpZGRlbicpOwogICAgICAgICAgfQoKICAgICAgICAgIGRvY3VtZW50LnF1ZXJ5"
-		"U2VsZWN0b3IoJyNzY2FubmluZycpLmNsYXNzTGlzdC5hZGQoJ2hpZGRlbicpCiAgICAgICAgfQoKICAg"
-		"ICAgICB4aHIuc2VuZCgpOwogICAgICB9CgogICAgICBmdW5jdGlvbiBzZWxlY3RXaWZpKHNzaWQpIHsK"
-		"ICAgICAgICBkb2N1bWVudC5xdWVyeVNlbGVjdG9yKCcjcHJpbWFyeS1zc2lkJykudmFsdWUgPSBzc2lk"
-		"OwogICAgICAgIGRvY3VtZW50LnF1ZXJ5U2VsZWN0b3IoJyNzY2FuJykuY2xhc3NMaXN0LmFkZCgnaGlk"
-		"ZGVuJykKICAgICAgfQoKICAgICAgZnVuY3Rpb24gY2FuY2xlU2VsZWN0KCkgewogICAgICAgIGRvY3Vt"
-		"ZW50LnF1ZXJ5U2VsZWN0b3IoJyNzY2FuJykuY2xhc3NMaXN0LmFkZCgnaGlkZGVuJykKICAgICAgfQoK"
-		"ICAgIDwvc2NyaXB0PgogIDwvaGVhZD4KCiAgPGJvZHk+CiAgICA8aDE+SGVsbG88L2gxPgogICAgPHA+"
-		"V2VsY29tZSB0byBwbGFudGFseXRpeDwvcD4KCiAgICA8ZGl2IGlkPSJjb25uZWN0aW5nIiBjbGFzcz0i"
-		"aGlkZGVuIGJveCI+CiAgICAgIDxwPmNvbm5lY3RpbmcuLi48L3A+CiAgICA8L2Rpdj4KCiAgICA8ZGl2"
-		"IGlkPSJzY2FubmluZyIgY2xhc3M9ImhpZGRlbiBib3giPgogICAgICA8cD5zY2FubmluZy4uLjwvcD4K"
-		"ICAgIDwvZGl2PgoKICAgIDxkaXYgaWQ9ImNvbm5lY3RlZCIgY2xhc3M9ImhpZGRlbiBib3ggb2siPgog"
-		"ICAgICA8cD5jb25uZWN0aW9uIHN1Y2Nlc3NmdWw8L3A+CiAgICA8L2Rpdj4KCiAgICA8ZGl2IGlkPSJl"
-		"cnJvciIgY2xhc3M9ImhpZGRlbiBib3ggZXJyb3IiPgogICAgICA8cD5jb25uZWN0aW9uIGVycm9yPC9w"
-		"PgogICAgPC9kaXY+CgogICAgPGRpdiBpZD0ic2NhbiIgY2xhc3M9ImhpZGRlbiIgc3R5bGU9InBvc2l0"
-		"aW9uOiBhYnNvbHV0ZTsgbGVmdDogMDsgcmlnaHQ6IDA7IHRvcDogMDsgYm90dG9tOiAwOyBiYWNrZ3Jv"
-		"dW5kLWNvbG9yOiAjY2NjY2NjNTM7Ij4KICAgICAgPGRpdiBzdHlsZT0icG9zaXRpb246IGFic29sdXRl"
-		"OyBsZWZ0OiAyMDsgcmlnaHQ6IDIwOyB0b3A6IDIwOyBib3R0b206IDIwOyBiYWNrZ3JvdW5kLWNvbG9y"
-		"OiAjZmZmOyBib3JkZXItcmFkaXVzOiA1cHg7Ij4KICAgICAgICA8aDM+U2VsZWN0IE5ldHdvcms8L2gz"
-		"PgogICAgICAgIDx0YWJsZSBzdHlsZT0id2lkdGg6OTAlO21hcmdpbjo1JSIgaWQ9InNjYW5jb250ZW50"
-		"Ij4KICAgICAgICA8L3RhYmxlPgogICAgICAgIDxidXR0b24gc3R5bGU9IndpZHRoOjkwJTttYXJnaW46"
-		"NSUiIHR5cGU9J2J1dHRvbicgb25jbGljaz0iY2FuY2xlU2VsZWN0KCkiPkFib3J0PC9idXR0b24+CiAg"
-		"ICAgIDwvZGl2PgogICAgPC9kaXY+CgogICAgPGRpdiBpZD0id2lmaS11aSI+CiAgICAgIDxmb3JtIGlk"
-		"PSJ3aWZpIj4KICAgICAgICA8cD5wcmltYXJ5IG5ldHdvcms8L3A+CiAgICAgICAgPGxhYmVsIGZvcj0i"
-		"cHJpbWFyeS1zc2lkIj5TU0lEPC9sYWJlbD4KICAgICAgICA8aW5wdXQgaWQ9InByaW1hcnktc3NpZCIg"
-		"dHlwZT0idGV4dCIgbmFtZT0icHJpbWFyeS1zc2lkIiB2YWx1ZT0iIj4KICAgICAgICA8YnV0dG9uIHR5"
-		"cGU9J2J1dHRvbicgb25jbGljaz0ic2NhbldpZmkoKSI+U2NhbjwvYnV0dG9uPgogICAgICAgIDxsYWJl"
-		"bCBmb3I9InByaW1hcnktcGFzc3dvcmQiPlBhc3N3b3JkPC9sYWJlbD4KICAgICAgICA8aW5wdXQgdHlw"
-		"ZT0idGV4dCIgbmFtZT0icHJpbWFyeS1wYXNzd29yZCIgdmFsdWU9IiI+CgogICAgICA8L2Zvcm0+CiAg"
-		"ICAgIDxidXR0b24gdHlwZT0nYnV0dG9uJyBvbmNsaWNrPSJzZW5kQ29uZmlnKCkiPlNhdmU8L2J1dHRv"
-		"bj4KICAgIDwvZGl2PgoKICA8L2JvZHk+Cgo8L2h0bWw+";
+const size_t INDEX_HTML_SIZE = 5973;
+const size_t INDEX_HTML_GZ_SIZE = 1654;
+const char INDEX_HTML_ETAG[] = "\"82946722bfbc4be9\"";
+const uint8_t INDEX_HTML_GZ[] PROGMEM = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcd, 0x58, 0x5b, 0x6f, 0xdb, 0x36,
+	0x14, 0x7e, 0xcf, 0xaf, 0xe0, 0x54, 0x14, 0x76, 0xd0, 0xf8, 0x92, 0x74, 0xc9, 0x30, 0xdf, 0x80,
+	0x61, 0xdd, 0xd6, 0x0d, 0xbd, 0xa1, 0x09, 0xd0, 0x01, 0x6b, 0x31, 0xd0, 0xd2, 0x91, 0xcd, 0x99,
+	0x26, 0x35, 0x92, 0x8a, 0xe3, 0x0e, 0xf9, 0xef, 0x3b, 0xa4, 0x24, 0x8b, 0x92, 0x25, 0xdb, 0xc5,
+	0x80, 0x6d, 0x79, 0x88, 0x29, 0xf2, 0xdc, 0xf8, 0x91, 0xe7, 0x3b, 0x24, 0x27, 0x4b, 0xb3, 0xe6,
+	0xb3, 0x33, 0x42, 0x26, 0x4b, 0xa0, 0x91, 0x6d, 0x60, 0xd3, 0x30, 0xc3, 0x61, 0xf6, 0x8e, 0x53,
+	0x61, 0x28, 0xdf, 0x1a, 0xf6, 0x30, 0x19, 0x64, 0x5d, 0xd9, 0xf0, 0x1a, 0x0c, 0x25, 0x82, 0xae,
+	0x61, 0x1a, 0xdc, 0x33, 0xd8, 0x24, 0x52, 0x99, 0x80, 0x84, 0x52, 0x18, 0x10, 0x66, 0x1a, 0x6c,
+	0x58, 0x64, 0x96, 0xd3, 0x08, 0xee, 0x59, 0x08, 0x3d, 0xf7, 0x71, 0x41, 0x98, 0x60, 0x86, 0x51,
+	0xde, 0xd3, 0x21, 0xe5, 0x30, 0xbd, 0xec, 0x0f, 0x83, 0xd9, 0x59, 0x66, 0x4b, 0x9b, 0xad, 0xb5,
+	0xeb, 0x3e, 0x08, 0xca, 0x25, 0xa9, 0xf9, 0xcd, 0x6c, 0x13, 0x98, 0x1a, 0x78, 0x30, 0x9f, 0x2e,
+	0xfc, 0x9e, 0x54, 0xf1, 0x6a, 0x07, 0xac, 0x29, 0xab, 0x75, 0x25, 0x54, 0xeb, 0x8d, 0x54, 0x51,
+	0xb5, 0xd7, 0x00, 0xff, 0x44, 0xfe, 0xca, 0x7d, 0x10, 0xd2, 0xdb, 0xc0, 0x7c, 0xc5, 0x4c, 0x8f,
+	0x26, 0x09, 0x50, 0x45, 0x45, 0x08, 0x23, 0x22, 0xa4, 0x80, 0x31, 0xe9, 0xad, 0xe5, 0xe7, 0xfd,
+	0xee, 0x9d, 0x62, 0xc4, 0x74, 0xc2, 0xe9, 0x76, 0x44, 0xe6, 0x5c, 0x86, 0xab, 0xb2, 0x7f, 0x4d,
+	0xd5, 0x82, 0x89, 0x11, 0x19, 0x96, 0x5d, 0x6e, 0xe2, 0x23, 0x72, 0x39, 0x1c, 0x3e, 0x1d, 0x93,
+	0x25, 0xb0, 0xc5, 0xd2, 0x8c, 0xc8, 0xd7, 0xc3, 0xe4, 0xa1, 0x14, 0xe1, 0x4c, 0x40, 0xaf, 0x32,
+	0x44, 0x62, 0x04, 0xb1, 0xa7, 0xd9, 0x67, 0xf4, 0x7c, 0xf9, 0x8d, 0x2f, 0x3b, 0xc7, 0x39, 0x81,
+	0xc2, 0xde, 0xe4, 0x81, 0x68, 0xc9, 0x59, 0x44, 0x9e, 0xcc, 0xe7, 0xf3, 0x62, 0xfc, 0xb1, 0xc0,
+	0x6f, 0x9e, 0x1a, 0x23, 0xc5, 0xbf, 0x3c, 0xd5, 0xac, 0xab, 0x67, 0x64, 0x32, 0x22, 0xd7, 0x7e,
+	0xd0, 0xff, 0x0d, 0x06, 0x76, 0x43, 0x7b, 0x08, 0x38, 0x73, 0x31, 0x5d, 0x33, 0x8e, 0x93, 0xd1,
+	0x54, 0xe8, 0x9e, 0x06, 0xc5, 0xe2, 0x71, 0x55, 0x20, 0xf7, 0x77, 0x85, 0x91, 0x36, 0xc7, 0x76,
+	0x79, 0x5d, 0x0e, 0xed, 0x5c, 0xf5, 0x97, 0x2c, 0x8a, 0xc0, 0xc7, 0x7b, 0x07, 0x9b, 0x45, 0x93,
+	0x7c, 0xc5, 0xd6, 0x36, 0x39, 0x30, 0x8d, 0xf6, 0x55, 0xe7, 0xf2, 0xc1, 0xd3, 0x6b, 0x84, 0xea,
+	0xa6, 0x02, 0xd5, 0xce, 0x74, 0xcc, 0xc1, 0xeb, 0xfe, 0x23, 0xd5, 0x86, 0xc5, 0xdb, 0x5e, 0x9e,
+	0x7f, 0x23, 0x12, 0xe2, 0x7f, 0x50, 0xde, 0xfc, 0x50, 0xbc, 0x17, 0x31, 0x05, 0xa1, 0x61, 0x12,
+	0x57, 0x2e, 0x94, 0x3c, 0x5d, 0x8b, 0x53, 0x61, 0x25, 0xc4, 0x26, 0x62, 0x8f, 0x72, 0xb6, 0x10,
+	0xfb, 0xb6, 0x5b, 0x96, 0xbe, 0x9c, 0x25, 0x28, 0x25, 0x95, 0x37, 0xcf, 0x06, 0x67, 0xe1, 0xcd,
+	0x8d, 0x17, 0x0c, 0x0d, 0x57, 0x0b, 0x25, 0x53, 0x11, 0xe1, 0x84, 0xb8, 0x44, 0xc9, 0x27, 0x71,
+	0x18, 0xee, 0xdb, 0x95, 0xab, 0xc3, 0x46, 0x6f, 0xc2, 0xc3, 0x46, 0xc3, 0xb8, 0x6e, 0x74, 0x32,
+	0xf0, 0xa9, 0x68, 0xa2, 0x43, 0xc5, 0x12, 0xb3, 0x23, 0xa6, 0x38, 0x15, 0x0e, 0x3e, 0xa2, 0x41,
+	0x44, 0xdf, 0x4b, 0x11, 0xb3, 0x45, 0xf7, 0xdc, 0x0b, 0x81, 0x83, 0x21, 0x29, 0x23, 0x53, 0x12,
+	0xc9, 0x30, 0x5d, 0x23, 0x4a, 0xfd, 0x3f, 0x53, 0x50, 0xdb, 0x5b, 0xe0, 0x08, 0xbb, 0x54, 0xdd,
+	0xce, 0x93, 0x0d, 0x8b, 0x59, 0x2f, 0x65, 0x9d, 0xf3, 0x71, 0x45, 0x29, 0x96, 0x6a, 0x7d, 0x4c,
+	0xad, 0xae, 0x83, 0x4b, 0x2d, 0xec, 0x6a, 0x8a, 0xc5, 0x21, 0xcd, 0x52, 0xaa, 0x45, 0x1f, 0xa2,
+	0x13, 0xd4, 0x21, 0xaa, 0x6b, 0x67, 0x4b, 0x7a, 0x40, 0xd3, 0x09, 0x58, 0xad, 0x9d, 0x5a, 0xca,
+	0xfa, 0x21, 0x47, 0x66, 0x7e, 0xc5, 0xb4, 0xe9, 0xd3, 0x28, 0xea, 0x76, 0xb2, 0xc4, 0xf1, 0x4d,
+	0xef, 0xfc, 0x1d, 0x17, 0x75, 0x0e, 0x4e, 0xb6, 0x88, 0x00, 0x78, 0xb2, 0x0a, 0xd6, 0xf2, 0x1e,
+	0x7c, 0xf1, 0xbd, 0xe5, 0xf8, 0x3d, 0xa2, 0x58, 0xdf, 0xa6, 0x44, 0xc0, 0x86, 0xfc, 0x88, 0xdf,
+	0x2f, 0xf0, 0xb3, 0x6b, 0x07, 0x6a, 0x40, 0x24, 0x74, 0xcb, 0x25, 0xb5, 0x20, 0xfe, 0x72, 0xfb,
+	0xf6, 0x4d, 0x5f, 0x1b, 0x85, 0xae, 0x30, 0x15, 0xbb, 0xe5, 0xb6, 0x20, 0x24, 0x51, 0x0c, 0x93,
+	0x04, 0xb3, 0xd6, 0xef, 0x24, 0x44, 0x6b, 0x16, 0x8d, 0x4a, 0x6f, 0xfd, 0x05, 0x98, 0x6e, 0x27,
+	0x97, 0xed, 0xd9, 0xc1, 0xce, 0xf9, 0x45, 0x45, 0xa1, 0x28, 0x6c, 0xad, 0x4a, 0x85, 0x40, 0x55,
+	0xf1, 0xd1, 0xff, 0xd0, 0x80, 0x90, 0x44, 0xa7, 0x46, 0xb3, 0x93, 0xfe, 0xb2, 0x78, 0x4a, 0xb5,
+	0xa3, 0x11, 0x3d, 0xfa, 0xe8, 0xdf, 0x53, 0x45, 0x1e, 0x96, 0x2a, 0xc7, 0xfd, 0xd7, 0xd7, 0xaf,
+	0x5e, 0x1a, 0x93, 0xbc, 0x07, 0xdc, 0x5c, 0xda, 0x74, 0x3d, 0xe4, 0xad, 0xdc, 0x52, 0x6a, 0x83,
+	0x82, 0x1b, 0x26, 0x22, 0xb9, 0xe9, 0x63, 0x81, 0xa2, 0x36, 0x37, 0xfb, 0x89, 0x92, 0x46, 0x62,
+	0x86, 0x93, 0x67, 0x24, 0x18, 0x0c, 0x02, 0xfc, 0xa9, 0x4b, 0x58, 0xc5, 0xaa, 0x29, 0x3c, 0x54,
+	0xa0, 0x25, 0x67, 0xd0, 0x6a, 0x85, 0x2e, 0xb5, 0x83, 0x52, 0x06, 0x43, 0xea, 0xcb, 0x04, 0x44,
+	0x37, 0x78, 0xf7, 0xf6, 0xf6, 0x2e, 0xb8, 0xb0, 0x0a, 0x17, 0xc4, 0xa8, 0x14, 0xfc, 0xe0, 0x07,
+	0x03, 0x3f, 0x29, 0x55, 0x2a, 0x34, 0x1e, 0x3f, 0x88, 0x59, 0x82, 0xc7, 0x3d, 0x17, 0xee, 0x5b,
+	0x81, 0x4e, 0xb9, 0x21, 0x4c, 0x93, 0x44, 0x72, 0x0e, 0x51, 0x49, 0xd3, 0x05, 0xc3, 0x48, 0xf1,
+	0xde, 0xc9, 0x54, 0xf8, 0x05, 0x8f, 0x46, 0x71, 0xd7, 0x2c, 0x99, 0xc6, 0x0d, 0xac, 0x13, 0x29,
+	0x34, 0xdc, 0x21, 0x2d, 0x93, 0xe9, 0x94, 0x74, 0x30, 0xb8, 0xc8, 0x25, 0x79, 0x7d, 0x51, 0xc1,
+	0xdc, 0xb1, 0x35, 0xc8, 0xd4, 0x74, 0x0b, 0xdb, 0xdd, 0xba, 0x4c, 0x86, 0x81, 0x36, 0xd4, 0xa4,
+	0xfa, 0x28, 0xf2, 0xb9, 0x59, 0x27, 0x9c, 0x63, 0xf2, 0xd3, 0x0f, 0x75, 0x48, 0x9a, 0x85, 0x45,
+	0x9e, 0x28, 0xc5, 0xdc, 0x5a, 0xe5, 0x0a, 0x72, 0x39, 0x22, 0x68, 0x59, 0xb8, 0x1e, 0xda, 0xe3,
+	0x85, 0x2d, 0x9f, 0xc3, 0x4a, 0xef, 0xa3, 0xd7, 0x06, 0xae, 0xa1, 0x1d, 0x45, 0xb9, 0xda, 0x03,
+	0xb0, 0x91, 0x3f, 0x5a, 0xb8, 0xa6, 0x8d, 0xc1, 0xf6, 0xe9, 0xe6, 0x40, 0x70, 0xff, 0xcc, 0x7d,
+	0x9d, 0x15, 0x0f, 0xb9, 0xae, 0x51, 0xf2, 0x69, 0x51, 0x3e, 0x9e, 0x55, 0xb3, 0xa2, 0x7d, 0x51,
+	0xed, 0xb0, 0x5b, 0xa2, 0x9c, 0x22, 0xcf, 0xf7, 0x0a, 0x78, 0x59, 0x4f, 0x43, 0x2a, 0x3e, 0x60,
+	0x8d, 0xdb, 0xab, 0xa6, 0x76, 0xe0, 0x50, 0x95, 0xb1, 0xe3, 0x0d, 0x85, 0xcd, 0x9e, 0x81, 0x8e,
+	0xa9, 0xe5, 0x62, 0x15, 0xf2, 0x3f, 0xa8, 0x20, 0x5c, 0x7e, 0x1d, 0x00, 0xec, 0xcc, 0x2f, 0x3a,
+	0xd6, 0x76, 0x9f, 0xe1, 0xe2, 0xa9, 0x97, 0x77, 0xaf, 0x5f, 0x61, 0x30, 0x41, 0xf0, 0x7f, 0xa3,
+	0x39, 0x3b, 0xa9, 0x46, 0x92, 0xdb, 0x4f, 0xe8, 0xe6, 0x35, 0x6f, 0x61, 0x14, 0xe4, 0xc1, 0xab,
+	0xe1, 0xd5, 0xc8, 0x31, 0x9d, 0x5b, 0x40, 0xe4, 0x39, 0x3c, 0x9e, 0x72, 0x6e, 0x39, 0xd1, 0xa2,
+	0xd8, 0x44, 0x8b, 0x54, 0xaf, 0x08, 0x5d, 0x50, 0x26, 0x1a, 0xd8, 0xae, 0xa0, 0xa6, 0xa9, 0xb5,
+	0x7b, 0x80, 0xe1, 0x8a, 0x6d, 0xd4, 0xc0, 0x01, 0x04, 0x39, 0xd7, 0xa4, 0x4a, 0xb4, 0xa5, 0x9e,
+	0xdd, 0x38, 0xf6, 0x94, 0x55, 0xd4, 0xf1, 0x84, 0x2a, 0x0d, 0xfb, 0x2c, 0x71, 0x5e, 0x8d, 0xce,
+	0x6a, 0xd4, 0xe3, 0xc1, 0x4a, 0xd8, 0x75, 0x5b, 0x17, 0xeb, 0x25, 0x91, 0x31, 0x69, 0x92, 0x69,
+	0xda, 0x21, 0xcf, 0x70, 0x8b, 0x4c, 0x8c, 0x9a, 0x4d, 0x4c, 0x34, 0xb3, 0xcb, 0xe9, 0xf4, 0x71,
+	0x99, 0xf0, 0xd6, 0x1d, 0xd9, 0x4e, 0xe2, 0x4e, 0xa6, 0xd3, 0x8f, 0x81, 0x7f, 0x14, 0x57, 0xf6,
+	0x8e, 0x30, 0xfe, 0x18, 0xcc, 0x26, 0xf9, 0xa5, 0x4f, 0x8a, 0x90, 0xb3, 0x70, 0x85, 0x62, 0xda,
+	0xed, 0x5e, 0x97, 0x55, 0x1d, 0xdf, 0x5e, 0xe7, 0x1c, 0xc5, 0xb3, 0xad, 0x3d, 0x19, 0x64, 0x5a,
+	0x33, 0xe7, 0x23, 0xa8, 0x12, 0xe9, 0x59, 0x15, 0x65, 0x84, 0xf6, 0x64, 0xae, 0xf0, 0x3e, 0xbe,
+	0x2c, 0xa3, 0x2a, 0xc4, 0xd6, 0x46, 0x39, 0x55, 0xda, 0x6f, 0x20, 0x93, 0x72, 0xe2, 0x76, 0xce,
+	0x3e, 0xf6, 0xad, 0xd1, 0x54, 0x0f, 0x5d, 0xfd, 0x7b, 0xca, 0x53, 0xc0, 0xad, 0x60, 0x3f, 0xc7,
+	0xa7, 0xb1, 0xc3, 0xd1, 0x79, 0xec, 0x07, 0x6a, 0x49, 0x88, 0x43, 0x66, 0xa7, 0x7b, 0x52, 0x98,
+	0x5f, 0xe2, 0x08, 0xaf, 0x32, 0xf9, 0xed, 0xc5, 0xb6, 0xb3, 0x77, 0x1d, 0xdb, 0x9c, 0xcb, 0x68,
+	0x9b, 0x3f, 0xe1, 0x2c, 0x2f, 0x67, 0x2f, 0x81, 0x73, 0x89, 0xc3, 0x97, 0x79, 0x57, 0x32, 0xfb,
+	0x00, 0x3c, 0x94, 0x6b, 0x20, 0x46, 0x92, 0xc4, 0x7f, 0xfb, 0x49, 0x8a, 0x4b, 0x51, 0xc4, 0xee,
+	0x09, 0x8b, 0xa6, 0x41, 0x59, 0x9a, 0x02, 0xe2, 0x22, 0x9a, 0x06, 0xf9, 0x4d, 0x18, 0x6f, 0xb5,
+	0xc1, 0x2c, 0x8f, 0x06, 0x2d, 0x7a, 0x35, 0xac, 0xdf, 0x77, 0x86, 0xb2, 0xf8, 0xd0, 0x50, 0xdd,
+	0x66, 0xb1, 0x2b, 0x8e, 0x58, 0x2c, 0xc4, 0x8e, 0xda, 0xdb, 0x55, 0xe3, 0x06, 0x83, 0x44, 0xae,
+	0x9a, 0xa2, 0xb4, 0x3b, 0x28, 0x0d, 0x43, 0xd0, 0x3a, 0x4e, 0xf9, 0x61, 0xeb, 0xae, 0xd8, 0x36,
+	0x59, 0xce, 0x06, 0x9a, 0x8d, 0xbb, 0xb1, 0xe3, 0x28, 0xd4, 0xcc, 0x06, 0x79, 0xfa, 0x07, 0x89,
+	0xd4, 0x2c, 0xbb, 0xc2, 0xd3, 0x39, 0x5e, 0x73, 0x53, 0x03, 0x63, 0x24, 0xaf, 0xd8, 0xd8, 0xc7,
+	0x98, 0x8c, 0x0e, 0x5c, 0xcb, 0x5d, 0xc6, 0xf1, 0x77, 0x2e, 0x31, 0xc1, 0xd7, 0x59, 0xb3, 0xe1,
+	0x02, 0xec, 0xfe, 0xae, 0x9f, 0x8f, 0xcb, 0x58, 0x6d, 0x0c, 0x47, 0x5d, 0x5d, 0x95, 0xbe, 0xae,
+	0x0a, 0x67, 0x57, 0x9e, 0xb7, 0xab, 0x66, 0x77, 0x71, 0x1c, 0x8f, 0xf3, 0x7b, 0x7a, 0x4f, 0xd1,
+	0x88, 0xa5, 0x3a, 0x7b, 0x30, 0xd8, 0x79, 0xb7, 0x7b, 0xf2, 0x79, 0x4e, 0x4e, 0xe4, 0x0d, 0x18,
+	0xbc, 0x38, 0xac, 0x70, 0x73, 0x3e, 0xf7, 0xc6, 0x0d, 0x9d, 0x73, 0x28, 0x22, 0xcc, 0x1e, 0x4c,
+	0xbe, 0x1d, 0x3e, 0x1d, 0xe7, 0x2f, 0x52, 0xd7, 0x4f, 0x83, 0x1d, 0x82, 0x39, 0xc5, 0xfa, 0xc6,
+	0x07, 0x4e, 0xdb, 0xeb, 0xc8, 0x59, 0xf3, 0x90, 0x39, 0xf7, 0x76, 0xd8, 0xc9, 0x04, 0x3b, 0x3b,
+	0x7e, 0x0d, 0xaa, 0xc9, 0x1b, 0xcc, 0xbe, 0xc3, 0x79, 0x95, 0x84, 0x5a, 0xa0, 0x99, 0xad, 0x6e,
+	0xeb, 0x42, 0xe7, 0xcf, 0x01, 0x25, 0xfa, 0xee, 0x21, 0xa0, 0x18, 0xf1, 0x23, 0x4f, 0x66, 0x39,
+	0x45, 0xe1, 0x89, 0x21, 0x87, 0x25, 0xf1, 0x86, 0x39, 0x9d, 0x03, 0xb7, 0xa5, 0x07, 0x57, 0xcd,
+	0xa3, 0x32, 0x24, 0xfa, 0xdb, 0x9f, 0x5f, 0x4c, 0x06, 0x6e, 0xd8, 0x13, 0x77, 0xaf, 0xa2, 0xce,
+	0x4f, 0x45, 0x3a, 0x9b, 0xab, 0x2b, 0x30, 0x41, 0xfe, 0xb4, 0x5b, 0x1d, 0x77, 0xbc, 0x38, 0x0d,
+	0x82, 0x7d, 0x04, 0x5b, 0x50, 0x2a, 0x0f, 0x76, 0x18, 0x0a, 0xb6, 0xeb, 0x00, 0x35, 0x87, 0x5e,
+	0xdc, 0x19, 0x83, 0xd9, 0xbb, 0xbc, 0xd5, 0x36, 0x85, 0xf6, 0x80, 0x77, 0x36, 0xbc, 0xa0, 0x77,
+	0xab, 0x62, 0x61, 0xde, 0x61, 0x7e, 0x64, 0x06, 0xde, 0x53, 0x0f, 0xce, 0x81, 0xde, 0x43, 0x75,
+	0x0e, 0xe5, 0xba, 0x62, 0xbf, 0xa3, 0xd6, 0x33, 0xdc, 0xb1, 0xf6, 0x39, 0xfd, 0x6f, 0x96, 0x00,
+	0x17, 0x54, 0x55, 0x17, 0x00, 0x00
+};
 
@@ -0,0 +1,201 @@
+#include "lanserver.h"
+
+#include <WiFi.h>
+#include <ESPmDNS.h>
+#include <lwip/sockets.h>
+#include <algorithm>
+
+namespace fg {
+
+  namespace {
+    class Lock {
+      SemaphoreHandle_t mutex;
+    public:
+      explicit Lock(SemaphoreHandle_t mutex) : mutex(mutex) { xSemaphoreTake(mutex, portMAX_DELAY); }
+      ~Lock() { xSemaphoreGive(mutex); }
+    };
+
+    // the response of an event stream never ends, so the headers are
+    // written by hand instead of through httpd_resp_*
+    const char EVENTS_HEADER[] =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: text/event-stream\r\n"
+      "Cache-Control: no-cache\r\n"
+      "Access-Control-Allow-Origin: *\r\n"
+      "\r\n";
+  }
+
+  LanServer::LanServer() {
+    streams.fill(-1);
+  }
+
+  void LanServer::begin() {
+    if(httpd) {
+      return;
+    }
+    auto now = xTaskGetTickCount();
+    if(attempted && now - last_attempt < RETRY_INTERVAL) {
+      return;
+    }
+    attempted = true;
+    last_attempt = now;
+
+    if(!mutex) {
+      mutex = xSemaphoreCreateMutex();
+    }
+
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.ctrl_port = CONTROL_PORT;
+    config.stack_size = 6144; // room for a status copy
+    config.lru_purge_enable = true;
+    config.send_wait_timeout = 1; // a stalled display only delays the others by a second
+    config.global_user_ctx = this;
+    config.global_user_ctx_free_fn = [](void*) {};
+    config.close_fn = closeSocket;
+
+    if(httpd_start(&httpd, &config) != ESP_OK) {
+      Serial.println("failed to start lan server");
+      httpd = NULL;
+      return;
+    }
+
+    const httpd_uri_t handlers[] = {
+      {"/status", HTTP_GET, handleStatus, this},
+      {"/events", HTTP_GET, handleEvents, this},
+    };
+    for(auto& handler : handlers) {
+      httpd_register_uri_handler(httpd, &handler);
+    }
+
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    char hostname[32];
+    snprintf(hostname, sizeof(hostname), "plantalytix-%02x%02x%02x", mac[3], mac[4], mac[5]);
+    if(MDNS.begin(hostname)) {
+      MDNS.addService("http", "tcp", 80);
+      MDNS.addServiceTxt("http", "tcp", "status", "/status");
+      MDNS.addServiceTxt("http", "tcp", "events", "/events");
+      Serial.printf("lan status on http://%s.local/status\n\r", hostname);
+    }
+    else {
+      Serial.println("mdns failed");
+    }
+  }
+
+  void LanServer::publish(const JsonDocument& document) {
+    if(!httpd) {
+      return;
+    }
+    if(measureJson(document) >= MAX_STATUS_SIZE) {
+      Serial.println("status too large for lan server");
+      return;
+    }
+
+    char buffer[MAX_STATUS_SIZE];
+    size_t len = serializeJson(document, buffer, sizeof(buffer));
+    bool changed;
+    {
+      Lock lock(mutex);
+      changed = len != status_len || memcmp(buffer, status, len);
+      if(changed) {
+        memcpy(status, buffer, len);
+        status_len = len;
+        sequence++;
+      }
+    }
+
+    // unchanged status still gets a keepalive now and then, which is
+    // also how streams of vanished clients are found
+    auto now = xTaskGetTickCount();
+    if(changed || now - last_event > KEEPALIVE_INTERVAL) {
+      last_event = now;
+      httpd_queue_work(httpd, sendEventsWork, this);
+    }
+  }
+
+  void LanServer::sendEvents() {
+    char event[MAX_STATUS_SIZE + 32];
+    int len;
+    {
+      Lock lock(mutex);
+      if(sequence == sent_sequence) {
+        len = snprintf(event, sizeof(event), ": keepalive\n\n");
+      }
+      else {
+        len = snprintf(event, sizeof(event), "event: status\ndata: %.*s\n\n", static_cast<int>(status_len), status);
+        sent_sequence = sequence;
+      }
+    }
+
+    for(auto& fd : streams) {
+      if(fd >= 0 && httpd_socket_send(httpd, fd, event, len, 0) < 0) {
+        httpd_sess_trigger_close(httpd, fd);
+        fd = -1;
+      }
+    }
+  }
+
+  void LanServer::removeStream(int fd) {
+    std::replace(streams.begin(), streams.end(), fd, -1);
+  }
+
+  esp_err_t LanServer::handleStatus(httpd_req_t* req) {
+    auto server = static_cast<LanServer*>(req->user_ctx);
+    char body[MAX_STATUS_SIZE];
+    size_t len;
+    {
+      Lock lock(server->mutex);
+      len = server->status_len;
+      memcpy(body, server->status, len);
+    }
+
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    if(!len) {
+      httpd_resp_set_status(req, "503 Service Unavailable");
+      return httpd_resp_sendstr(req, "no status yet");
+    }
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, body, len);
+  }
+
+  esp_err_t LanServer::handleEvents(httpd_req_t* req) {
+    auto server = static_cast<LanServer*>(req->user_ctx);
+    auto slot = std::find(server->streams.begin(), server->streams.end(), -1);
+    if(slot == server->streams.end()) {
+      httpd_resp_set_status(req, "503 Service Unavailable");
+      return httpd_resp_sendstr(req, "too many event streams");
+    }
+
+    int fd = httpd_req_to_sockfd(req);
+    if(httpd_socket_send(server->httpd, fd, EVENTS_HEADER, sizeof(EVENTS_HEADER) - 1, 0) < 0) {
+      return ESP_FAIL;
+    }
+    *slot = fd;
+
+    // the new stream starts with the current status
+    char event[MAX_STATUS_SIZE + 32];
+    int len = 0;
+    {
+      Lock lock(server->mutex);
+      if(server->status_len) {
+        len = snprintf(event, sizeof(event), "event: status\ndata: %.*s\n\n", static_cast<int>(server->status_len), server->status);
+      }
+    }
+    if(len && httpd_socket_send(server->httpd, fd, event, len, 0) < 0) {
+      *slot = -1;
+      return ESP_FAIL;
+    }
+    return ESP_OK;
+  }
+
+  void LanServer::sendEventsWork(void* arg) {
+    static_cast<LanServer*>(arg)->sendEvents();
+  }
+
+  void LanServer::closeSocket(httpd_handle_t hd, int fd) {
+    static_cast<LanServer*>(httpd_get_global_user_ctx(hd))->removeStream(fd);
+    close(fd);
+  }
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <array>
+#include "Arduino.h"
+#include "ArduinoJson.h"
+#include "freertos/semphr.h"
+#include <esp_http_server.h>
+
+namespace fg {
+
+  // Status of the controller for displays on the local network, so they
+  // do not need the round trip through the cloud broker. Runs in station
+  // mode next to the cloud connection and is found by mDNS as
+  // plantalytix-xxxxxx.local:
+  //   GET /status  latest status document as JSON
+  //   GET /events  server-sent events, one "status" event per change
+  // Event streams are written from the server task, publishing only
+  // queues the work and never blocks the loop on a slow client.
+  class LanServer {
+    static constexpr size_t MAX_STREAMS = 4;
+    static constexpr size_t MAX_STATUS_SIZE = 1024;
+    static constexpr uint16_t CONTROL_PORT = ESP_HTTPD_DEF_CTRL_PORT + 1; // the portal has the default
+    static constexpr TickType_t KEEPALIVE_INTERVAL = configTICK_RATE_HZ * 15;
+    static constexpr TickType_t RETRY_INTERVAL = configTICK_RATE_HZ * 10;
+
+    httpd_handle_t httpd = NULL;
+    SemaphoreHandle_t mutex = NULL;
+    TickType_t last_attempt = 0;
+    bool attempted = false;
+
+    // guarded by mutex
+    char status[MAX_STATUS_SIZE];
+    size_t status_len = 0;
+    uint32_t sequence = 0;
+
+    // only touched by the server task
+    std::array<int, MAX_STREAMS> streams;
+    uint32_t sent_sequence = 0;
+
+    // only touched by publish()
+    TickType_t last_event = 0;
+
+    void sendEvents();
+    void removeStream(int fd);
+
+    static esp_err_t handleStatus(httpd_req_t* req);
+    static esp_err_t handleEvents(httpd_req_t* req);
+    static void sendEventsWork(void* arg);
+    static void closeSocket(httpd_handle_t hd, int fd);
+
+  public:
+    LanServer();
+
+    // starts server and mDNS, retried until it works, cheap once running
+    void begin();
+    inline bool active() const { return httpd != NULL; }
+
+    // takes a new status snapshot, open event streams get it if it changed
+    void publish(const JsonDocument& document);
+  };
+
+}
@@ -16,12 +16,16 @@
 #include "soc/rtc_cntl_reg.h"
 
 #include "fghmi.h"
+#include "i2cbus.h"
+#include "rotaryinput.h"
+#include "lanserver.h"
 
 void automationTick();
 
 std::unique_ptr<fg::AutomationController> control;
 fg::UserInterface ui;
 fg::Fridgecloud fgc(ui);
+fg::LanServer lan_server;
 
 #define ROTA 27
 #define ROTB 14
@@ -31,96 +35,60 @@ fg::Fridgecloud fgc(ui);
 // #define ROTB 19
 // #define BTN 5
 
-#define HOLD_TIMEOUT 1000
+#define BUS_STATS_INTERVAL 60
 
 static constexpr TickType_t CONTROL_TICK_INTERVAL = 1 * configTICK_RATE_HZ;
 static constexpr TickType_t UI_TICK_INTERVAL = configTICK_RATE_HZ / 10;
+static constexpr TickType_t UI_SLEEP_WAIT = configTICK_RATE_HZ / 50;
+
+fg::RotaryInput input(ROTA, ROTB, BTN);
+
+// Bus, display, input and Wi-Fi counters. Only printed when a bus had
+// errors or was reinstalled, or something was dropped or reconnected since
+// the last call, unless built with -DPRINT_BUS_STATS.
+void printBusStats() {
+  static uint32_t last_dropped = 0;
+  static uint32_t last_reconnects = 0;
+  bool noteworthy = false;
+
+  fg::I2cBusStats buses[2];
+  for(uint8_t port = 0; port < 2; port++) {
+    buses[port] = fg::i2cBus(port).stats();
+    fg::i2cBus(port).resetStats();
+    noteworthy |= buses[port].errors || buses[port].reconfigurations;
+  }
 
+  auto display = ui.displayStats();
+  ui.resetDisplayStats();
 
-void IRAM_ATTR isr() {
-  int rota = digitalRead(ROTA);
-  int rotb = digitalRead(ROTB);
+  uint32_t dropped = input.droppedEdges() + ui.droppedActions();
+  auto wifi = wifiLinkStats();
+  noteworthy |= dropped != last_dropped || wifi.reconnects != last_reconnects;
+  last_dropped = dropped;
+  last_reconnects = wifi.reconnects;
 
-  if(rotb) {
-    if(rota) {
-      ui.next();
-    }
-    else {
-      ui.prev();
-    }
+#ifndef PRINT_BUS_STATS
+  if(!noteworthy) {
+    return;
   }
-}
-
-// Robust Rotary encoder reading
-//
-// Copyright John Main - best-microcontroller-projects.com
-//
-#define CLK 2
-#define DATA 7
-
-static uint8_t prevNextCode = 0;
-static uint16_t store=0;
-
-
-// A vald CW or  CCW move returns 1, invalid returns 0.
-int8_t read_rotary() {
-  static int8_t rot_enc_table[] = {0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0};
-
-  prevNextCode <<= 2;
-  if (digitalRead(ROTB)) prevNextCode |= 0x02;
-  if (digitalRead(ROTA)) prevNextCode |= 0x01;
-  prevNextCode &= 0x0f;
-
-   // If valid then store as 16 bit data.
-   if  (rot_enc_table[prevNextCode] ) {
-      store <<= 4;
-      store |= prevNextCode;
-      //if (store==0xd42b) return 1;
-      //if (store==0xe817) return -1;
-      if ((store&0xff)==0x2b) return -1;
-      if ((store&0xff)==0x17) return 1;
-   }
-   return 0;
-}
+#endif
 
-static TimerHandle_t hold_timer = NULL;
-static TickType_t ui_action_delay = 0;
-static bool btn_down = false;
+  for(uint8_t port = 0; port < 2; port++) {
+    auto& stats = buses[port];
+    Serial.printf("I2C%u: %.1f%% busy, %u transactions, %u errors, %u reinits, %u pin switches, %u frames skipped\n\r",
+      port, stats.utilisation() * 100.0f, stats.transactions, stats.errors, stats.reconfigurations, stats.remaps, stats.skipped);
+  }
 
-void holdTimeout(void* unused) {
-  hold_timer = NULL;
-  ui.hold();
-}
+  Serial.printf("display: %u bytes/s, %u of %u frames changed\n\r",
+    display.bytes / BUS_STATS_INTERVAL, display.updates, display.frames);
 
-void IRAM_ATTR isr2() {
-  if(ui_action_delay < xTaskGetTickCount()) {
-    auto btn = digitalRead(BTN);
-    if(btn == 0 && !btn_down) {
-      if(!hold_timer) {
-        hold_timer = xTimerCreate("", HOLD_TIMEOUT, false, 0, &holdTimeout);
-        xTimerStart(hold_timer, 0);
-        btn_down = true;
-      }
-    }
+  Serial.printf("input: %u button edges dropped, %u ui actions dropped\n\r",
+    input.droppedEdges(), ui.droppedActions());
 
-    else if(btn == 1 && btn_down) {
-      if(hold_timer) {
-        xTimerDelete(hold_timer, 0);
-        hold_timer = NULL;
-        ui.enter();
-        ui_action_delay = xTaskGetTickCount() + 10;
-        btn_down = false;
-      }
-      if(btn_down) {
-        ui_action_delay = xTaskGetTickCount() + 10;
-        btn_down = false;
-      }
-    }
-  }
+  Serial.printf("wifi: %u reconnects, %u fast, last %u ms, longest %u ms\n\r",
+    wifi.reconnects, wifi.fast_reconnects, wifi.last_ms, wifi.longest_ms);
 }
 
-
-
 void setup()
 {
   using namespace fg;
@@ -138,15 +106,14 @@ void setup()
 
   control->initStatusMenu(&ui);
 
-  initializeWifi();
+  initializeWifi(&fgc);
   fgc.init();
   fgc.connect();
+  fgc.onStatus([](const JsonDocument& status) {
+    lan_server.publish(status);
+  });
 
-  pinMode(ROTA, INPUT_PULLUP);
-  pinMode(ROTB, INPUT_PULLUP);
-  pinMode(BTN, INPUT_PULLUP);
-
-  attachInterrupt(BTN, isr2, CHANGE);
+  input.begin(xTaskGetCurrentTaskHandle());
 
   esp_task_wdt_init(25, true); //enable panic so ESP32 restarts
   esp_task_wdt_add(NULL); //add current thread to WDT watch
@@ -170,18 +137,16 @@ void loop()
       last_controll_tick = xTaskGetTickCount();
 
       control->loop();
-    }
 
-    static int8_t c,val;
-    if( val=read_rotary() ) {
-      if(val == -1) {
-        ui.prev();
-      }
-      else {
-        ui.next();
+      static unsigned bus_stats_ticks = 0;
+      if(++bus_stats_ticks >= BUS_STATS_INTERVAL) {
+        bus_stats_ticks = 0;
+        printBusStats();
       }
     }
 
+    input.poll(ui);
+
     if((xTaskGetTickCount() - last_ui_tick) > UI_TICK_INTERVAL) {
       last_ui_tick = xTaskGetTickCount();
 
@@ -194,10 +159,18 @@ void loop()
 
     wifiTick();
     if(wifiIsConnected()) {
+      if(!wifiPortalActive()) {
+        lan_server.begin();
+      }
       fgc.loop();
     }
     esp_task_wdt_reset();
 
+    if(ui.isAsleep()) {
+      // nothing to draw, block instead of spinning until an input arrives
+      ulTaskNotifyTake(pdTRUE, UI_SLEEP_WAIT);
+    }
+
     if(Serial.available()) {
       if(Serial.read() == 'r') {
         // Serial.println("factory reset");
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include "Arduino.h"
+
+namespace fg {
+
+  namespace ntc {
+
+    constexpr double R1 = 100000.0;    // voltage divider resistor value
+    constexpr double BETA = 4250.0;    // Beta value
+    constexpr double T0 = 298.15;      // Temperature in Kelvin for 25 degree Celsius
+    constexpr double R0 = 100000.0;    // Resistance of Thermistor at 25 degree Celsius
+
+    constexpr int ADC_MAX = 4095;
+    constexpr uint32_t SUPPLY_MV = 3300;
+    constexpr int OVERSAMPLING = 16;
+
+    // one table entry every 16 ADC codes, linear interpolation in between
+    constexpr int TABLE_SHIFT = 4;
+    constexpr int TABLE_STEP = 1 << TABLE_SHIFT;
+    constexpr int TABLE_SIZE = (ADC_MAX + 1) / TABLE_STEP + 1;
+
+    // exact beta equation, only evaluated at compile time (and by tests)
+    constexpr double exactTemperature(double adc_val) {
+      return 1.0 / (1.0 / T0 + __builtin_log(R1 * adc_val / ((double)ADC_MAX - adc_val) / R0) / BETA) - 273.15;
+    }
+
+    // the ends of the range are clamped one code inwards to stay finite
+    constexpr float tableEntry(int index) {
+      return (float)exactTemperature(index == 0 ? 1.0 : index * TABLE_STEP >= ADC_MAX ? ADC_MAX - 1.0 : index * TABLE_STEP);
+    }
+
+    template<int... I> struct Indices {};
+    template<int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+    template<int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+    struct Table {
+      float values[TABLE_SIZE];
+    };
+
+    template<int... I> constexpr Table makeTable(Indices<I...>) {
+      return Table{{ tableEntry(I)... }};
+    }
+
+    constexpr Table TABLE = makeTable(MakeIndices<TABLE_SIZE>::type());
+
+  }
+
+  // ADC code to degree celsius using the compile time table
+  inline float ntcToTemp(uint16_t adc_val) {
+    adc_val = adc_val > ntc::ADC_MAX ? ntc::ADC_MAX : adc_val;
+    auto index = adc_val >> ntc::TABLE_SHIFT;
+    auto fraction = (float)(adc_val & (ntc::TABLE_STEP - 1)) / (float)ntc::TABLE_STEP;
+    auto lower = ntc::TABLE.values[index];
+    return lower + (ntc::TABLE.values[index + 1] - lower) * fraction;
+  }
+
+  // Averages eFuse calibrated readings and scales them back to an ideal
+  // 12 bit code of the 3.3V divider supply.
+  inline uint16_t ntcSample(uint8_t pin, uint32_t samples = ntc::OVERSAMPLING) {
+    uint32_t millivolts = 0;
+    for(uint32_t i = 0; i < samples; i++) {
+      millivolts += analogReadMilliVolts(pin);
+    }
+    uint32_t code = (millivolts * ntc::ADC_MAX + ntc::SUPPLY_MV * samples / 2) / (ntc::SUPPLY_MV * samples);
+    return code > ntc::ADC_MAX ? ntc::ADC_MAX : code;
+  }
+
+}
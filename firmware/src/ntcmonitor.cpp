@@ -0,0 +1,60 @@
+#include "ntcmonitor.h"
+#include "ntc.h"
+
+namespace fg {
+
+  NtcMonitor::NtcMonitor(Output& heater, uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4, float trip_temperature) :
+    heater(heater), pins{{pin1, pin2, pin3, pin4}}, trip_temperature(trip_temperature) {
+    for(auto& value : filtered) {
+      value = 0.0f;
+    }
+  }
+
+  void NtcMonitor::begin() {
+    for(auto pin : pins) {
+      pinMode(pin, INPUT);
+    }
+    sample(true);
+    xTaskCreatePinnedToCore(&NtcMonitor::run, "ntc", 2048, this, TASK_PRIORITY, &task, ARDUINO_RUNNING_CORE);
+  }
+
+  void NtcMonitor::sample(bool first) {
+    float hottest = -273.15f;
+    for(size_t i = 0; i < CHANNELS; i++) {
+      float temperature = ntcToTemp(ntcSample(pins[i], SAMPLES_PER_READ));
+      hottest = temperature > hottest ? temperature : hottest;
+      filtered[i] = first ? temperature : filtered[i] + FILTER_FACTOR * (temperature - filtered[i]);
+    }
+
+    // trip on the unfiltered sample, release only once the filtered values
+    // are back below the limit
+    if(hottest >= trip_temperature) {
+      heater.set(0);
+      if(!tripped) {
+        tripped = true;
+        trip_count++;
+      }
+    }
+    else if(tripped && maxTemperature() < trip_temperature) {
+      tripped = false;
+    }
+  }
+
+  void NtcMonitor::run(void* arg) {
+    auto monitor = static_cast<NtcMonitor*>(arg);
+    TickType_t last_wake = xTaskGetTickCount();
+    for(;;) {
+      vTaskDelayUntil(&last_wake, SAMPLE_INTERVAL);
+      monitor->sample(false);
+    }
+  }
+
+  float NtcMonitor::maxTemperature() const {
+    float hottest = filtered[0];
+    for(auto& value : filtered) {
+      hottest = value > hottest ? (float)value : hottest;
+    }
+    return hottest;
+  }
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+#include <atomic>
+#include "Arduino.h"
+#include "output.h"
+
+namespace fg {
+
+  // Samples the heater NTCs from a background task and cuts the heater as
+  // soon as one of them crosses the trip temperature, independent of the
+  // one second control loop. The control loop reads the filtered values.
+  class NtcMonitor {
+  public:
+    static constexpr size_t CHANNELS = 4;
+
+  private:
+    static constexpr TickType_t SAMPLE_INTERVAL = configTICK_RATE_HZ / 50;
+    static constexpr uint32_t SAMPLES_PER_READ = 4;
+    static constexpr float FILTER_FACTOR = 0.1f;
+    static constexpr UBaseType_t TASK_PRIORITY = 5;
+
+    Output& heater;
+    const std::array<uint8_t, CHANNELS> pins;
+    const float trip_temperature;
+
+    std::array<std::atomic<float>, CHANNELS> filtered;
+    std::atomic<bool> tripped{false};
+    std::atomic<uint32_t> trip_count{0};
+    TaskHandle_t task = NULL;
+
+    void sample(bool first);
+    static void run(void* arg);
+
+  public:
+    NtcMonitor(Output& heater, uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4, float trip_temperature);
+    void begin();
+
+    inline float temperature(size_t channel) const { return filtered[channel]; }
+    float maxTemperature() const;
+    inline bool isTripped() const { return tripped; }
+    inline uint32_t tripCount() const { return trip_count; }
+  };
+
+}
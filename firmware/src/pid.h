@@ -1,85 +1,74 @@
 #pragma once
 
+#include <stddef.h>
 #include "oned.h"
+#include "filter.h"
+#include "fixed.h"
 
 namespace fg {
 
-  template<int size>
-  class Avg {
-    float samples[size];
-    unsigned position = 0;
-    unsigned filled = 0;
-  public:
-    void push(float value) {
-      samples[position++] = value;
-      position = position == size ? 0 : position;
-      filled = filled < size ? filled + 1 : filled;
-    }
-
-    float avg() {
-      float sum = 0;
-      for(unsigned i = 0; i < filled; i++) {
-        sum += samples[i];
-      }
-      if(filled) {
-        sum /= (float)filled;
-        return sum;
-      }
-      else {
-        return 0.0;
-      }
-    }
-
-    void clear() {
-      position = 0;
-      filled = 0;
-    }
-  };
-
-  class Pid {
+  // PID controller with the output limited to 0..1. T is the type used for
+  // gains and state, float by default since the ESP32 FPU is single
+  // precision only. Q16_16 gives integer only math, but an integral step
+  // fi * error below 1/65536 rounds to zero: with the heater gain
+  // fi = 0.001 the integral stops moving for errors under about 0.008,
+  // so the output settles slightly off target.
+  template<typename T>
+  class BasicPid {
     static constexpr const size_t D_SMOOTHING = 10;
-    const double fp;
-    const double fi;
-    const double fd;
+    const T fp;
+    const T fi;
+    const T fd;
 
-    double previous;
+    T previous = T(0);
 
-    double p = 0;
-    double i = 0;
-    double d = 0;
+    T p = T(0);
+    T i = T(0);
+    T d = T(0);
 
     Avg<D_SMOOTHING> current_smooth;
     size_t d_wait = D_SMOOTHING;
 
+    static inline T limit(T min, T max, T value) {
+      return value < min ? min : value > max ? max : value;
+    }
+
   public:
-    Pid(double fp = 1.0, double fi = 0.0, double fd = 0.0) : fp(fp), fi(fi), fd(fd) {}
-    double tick(double current, double target) {
-      auto error = target - current;
-      p = fp * error;
+    BasicPid(float fp = 1.0f, float fi = 0.0f, float fd = 0.0f) : fp(T(fp)), fi(T(fi)), fd(T(fd)) {}
 
-      // double iupper = clamp(0, 1, 1.0 - p);
-      // double ilower = clamp(-1, 0, -1.0 - p);
-      i += fi * error;
-      // i = clamp(ilower, iupper, i);
-      i = clamp(-1, 1, i);
+    float tick(float current, float target) {
+      T error = T(target) - T(current);
+      p = fp * error;
 
+      // derivative on the smoothed measurement, so setpoint changes
+      // (day/night) do not kick the output
       current_smooth.push(current);
-      auto smooth_error = target - current_smooth.avg();
-
-      d = fd * (smooth_error - previous);
-      previous = smooth_error;
+      T smooth = T(current_smooth.avg());
+      d = fd * (previous - smooth);
+      previous = smooth;
 
       if(d_wait) {
-        d = 0;
+        d = T(0);
         d_wait--;
       }
 
-      return clamp(0, 1, p + i + d);
+      // anti-windup: only integrate while the output is not saturated in
+      // the direction the error would push it
+      T integrated = limit(T(-1), T(1), i + fi * error);
+      T output = p + integrated + d;
+      bool saturated = (output > T(1) && error > T(0)) || (output < T(0) && error < T(0));
+      if(!saturated) {
+        i = integrated;
+      }
+
+      return static_cast<float>(limit(T(0), T(1), p + i + d));
     }
 
-    double getP() { return p; }
-    double getI() { return i; }
-    double getD() { return d; }
+    float getP() const { return static_cast<float>(p); }
+    float getI() const { return static_cast<float>(i); }
+    float getD() const { return static_cast<float>(d); }
   };
 
-}
\ No newline at end of file
+  typedef BasicPid<float> Pid;
+
+}
@@ -0,0 +1,263 @@
+#include "portalserver.h"
+
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include <esp_task_wdt.h>
+#include <algorithm>
+
+#include "html_compressed/index.html.h"
+
+namespace fg {
+
+  namespace {
+    class Lock {
+      SemaphoreHandle_t mutex;
+    public:
+      explicit Lock(SemaphoreHandle_t mutex) : mutex(mutex) { xSemaphoreTake(mutex, portMAX_DELAY); }
+      ~Lock() { xSemaphoreGive(mutex); }
+    };
+
+    PortalServer* portalOf(httpd_req_t* req) {
+      return static_cast<PortalServer*>(req->user_ctx);
+    }
+
+    esp_err_t sendText(httpd_req_t* req, const char* status, const char* text) {
+      httpd_resp_set_status(req, status);
+      httpd_resp_set_type(req, "text/plain");
+      httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+      return httpd_resp_sendstr(req, text);
+    }
+  }
+
+  PortalServer::PortalServer(ConnectHandler connect) : connect(connect) {}
+
+  bool PortalServer::begin() {
+    if(httpd) {
+      return true;
+    }
+    if(!mutex) {
+      mutex = xSemaphoreCreateMutex();
+    }
+
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.stack_size = 6144; // room for the json documents
+    config.lru_purge_enable = true; // phones keep idle connections open
+    config.max_uri_handlers = 8;
+
+    if(httpd_start(&httpd, &config) != ESP_OK) {
+      Serial.println("failed to start portal server");
+      httpd = NULL;
+      return false;
+    }
+
+    const httpd_uri_t handlers[] = {
+      {"/portal", HTTP_GET, handleRoot, this},
+      {"/scan", HTTP_GET, handleScan, this},
+      {"/config", HTTP_POST, handleConfig, this},
+      {"/config", HTTP_GET, handleConfigStatus, this},
+    };
+    for(auto& handler : handlers) {
+      httpd_register_uri_handler(httpd, &handler);
+    }
+    // everything else, e.g. the OS connectivity checks, ends on the portal
+    httpd_register_err_handler(httpd, HTTPD_404_NOT_FOUND, handleNotFound);
+    return true;
+  }
+
+  void PortalServer::loop() {
+    if(!httpd) {
+      return;
+    }
+    auto now = xTaskGetTickCount();
+
+    if(job == JobState::DONE) {
+      if(!job_finished) {
+        job_finished = now;
+      }
+      else if(now - job_finished > RESTART_DELAY) {
+        ESP.restart();
+      }
+      return;
+    }
+
+    if(scanning) {
+      collectScan();
+      return;
+    }
+
+    // no scan while a connect job uses the radio
+    if(job == JobState::RUNNING) {
+      return;
+    }
+
+    bool start = false;
+    {
+      Lock lock(mutex);
+      start = scan_requested;
+      scan_requested = false;
+    }
+    if(start && WiFi.scanNetworks(true) == WIFI_SCAN_RUNNING) {
+      scanning = true;
+      scan_started = now;
+    }
+  }
+
+  bool PortalServer::scanFresh() const {
+    return scan_valid && xTaskGetTickCount() - scanned_at < SCAN_TTL;
+  }
+
+  void PortalServer::collectScan() {
+    auto found = WiFi.scanComplete();
+    if(found == WIFI_SCAN_RUNNING) {
+      if(xTaskGetTickCount() - scan_started > SCAN_TIMEOUT) {
+        Serial.println("wifi scan timeout");
+        WiFi.scanDelete();
+        scanning = false;
+      }
+      return;
+    }
+    scanning = false;
+    if(found < 0) {
+      Serial.println("wifi scan failed");
+      return;
+    }
+
+    std::vector<std::string> ssids;
+    for(int i = 0; i < found; i++) {
+      std::string ssid = WiFi.SSID(i).c_str();
+      if(ssid.size() && std::find(ssids.begin(), ssids.end(), ssid) == ssids.end()) {
+        ssids.push_back(ssid);
+      }
+    }
+    WiFi.scanDelete();
+
+    Serial.print(ssids.size());
+    Serial.println(" networks found");
+
+    Lock lock(mutex);
+    networks.swap(ssids);
+    scanned_at = xTaskGetTickCount();
+    scan_valid = true;
+  }
+
+  void PortalServer::runJob(void* arg) {
+    auto portal = static_cast<PortalServer*>(arg);
+    // the connect loop feeds the watchdog, which needs the task subscribed
+    esp_task_wdt_add(NULL);
+    bool connected = portal->connect(portal->job_ssid, portal->job_password);
+    portal->job = connected ? JobState::DONE : JobState::FAILED;
+    esp_task_wdt_delete(NULL);
+    vTaskDelete(NULL);
+  }
+
+  esp_err_t PortalServer::handleRoot(httpd_req_t* req) {
+    // the page only changes with the firmware, a cached copy is confirmed
+    // with a 304 instead of being sent again
+    httpd_resp_set_hdr(req, "ETag", INDEX_HTML_ETAG);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    char etag[sizeof(INDEX_HTML_ETAG)];
+    if(httpd_req_get_hdr_value_str(req, "If-None-Match", etag, sizeof(etag)) == ESP_OK && !strcmp(etag, INDEX_HTML_ETAG)) {
+      httpd_resp_set_status(req, "304 Not Modified");
+      return httpd_resp_send(req, NULL, 0);
+    }
+
+    // the gzip bytes go out as they are, straight from flash
+    httpd_resp_set_type(req, "text/html");
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    return httpd_resp_send(req, reinterpret_cast<const char*>(INDEX_HTML_GZ), INDEX_HTML_GZ_SIZE);
+  }
+
+  esp_err_t PortalServer::handleScan(httpd_req_t* req) {
+    auto portal = portalOf(req);
+    StaticJsonDocument<1024> response;
+    response.to<JsonArray>();
+    bool fresh;
+    {
+      Lock lock(portal->mutex);
+      fresh = portal->scanFresh();
+      if(fresh) {
+        for(auto& ssid : portal->networks) {
+          response.add(ssid);
+        }
+      }
+      else {
+        portal->scan_requested = true;
+      }
+    }
+
+    // 202 tells the page to ask again, the scan runs in the background
+    char body[1024];
+    serializeJson(response, body, sizeof(body));
+    httpd_resp_set_status(req, fresh ? "200 OK" : "202 Accepted");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_sendstr(req, body);
+  }
+
+  esp_err_t PortalServer::handleConfig(httpd_req_t* req) {
+    auto portal = portalOf(req);
+    if(req->content_len > MAX_BODY_SIZE) {
+      return sendText(req, "413 Payload Too Large", "error");
+    }
+
+    char body[MAX_BODY_SIZE + 1];
+    size_t received = 0;
+    while(received < req->content_len) {
+      int len = httpd_req_recv(req, body + received, req->content_len - received);
+      if(len == HTTPD_SOCK_ERR_TIMEOUT) {
+        continue;
+      }
+      if(len <= 0) {
+        return ESP_FAIL;
+      }
+      received += len;
+    }
+    body[received] = '\0';
+
+    StaticJsonDocument<384> config_data;
+    if(auto error = deserializeJson(config_data, body)) {
+      Serial.print(F("deserializeJson() failed: "));
+      Serial.println(error.f_str());
+      return sendText(req, "400 Bad Request", "error");
+    }
+
+    auto state = portal->job.load();
+    if(state == JobState::RUNNING) {
+      return sendText(req, "409 Conflict", "pending");
+    }
+    if(state == JobState::DONE) {
+      return sendText(req, "200 OK", "ok");
+    }
+
+    portal->job_ssid = config_data["primary"]["ssid"].as<std::string>();
+    portal->job_password = config_data["primary"]["password"].as<std::string>();
+    portal->job = JobState::RUNNING;
+    if(xTaskCreate(runJob, "portal_job", JOB_STACK_SIZE, portal, 1, NULL) != pdPASS) {
+      portal->job = JobState::FAILED;
+      return sendText(req, "200 OK", "error");
+    }
+    return sendText(req, "202 Accepted", "pending");
+  }
+
+  esp_err_t PortalServer::handleConfigStatus(httpd_req_t* req) {
+    switch(portalOf(req)->job.load()) {
+      case JobState::RUNNING:
+        return sendText(req, "200 OK", "pending");
+      case JobState::DONE:
+        return sendText(req, "200 OK", "ok");
+      case JobState::FAILED:
+        return sendText(req, "200 OK", "error");
+      case JobState::IDLE:
+      default:
+        return sendText(req, "200 OK", "idle");
+    }
+  }
+
+  esp_err_t PortalServer::handleNotFound(httpd_req_t* req, httpd_err_code_t) {
+    httpd_resp_set_status(req, "302 Found");
+    httpd_resp_set_hdr(req, "Location", "/portal");
+    return httpd_resp_sendstr(req, "redirect to captive portal");
+  }
+
+}
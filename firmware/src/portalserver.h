@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include "Arduino.h"
+#include "freertos/semphr.h"
+#include <esp_http_server.h>
+
+namespace fg {
+
+  // Captive portal on the IDF http server. Requests are served from the
+  // server's own task, so several clients can use the portal at once
+  // while the loop keeps running. Nothing slow happens inside a handler:
+  // Wi-Fi scans run in the background and are cached, connecting to the
+  // chosen network is a job the page polls for its result.
+  class PortalServer {
+  public:
+    // connects to the network and stores the credentials, runs in its own
+    // task and may block
+    using ConnectHandler = std::function<bool(const std::string& ssid, const std::string& password)>;
+
+  private:
+    enum class JobState : uint8_t {
+      IDLE, RUNNING, DONE, FAILED
+    };
+
+    static constexpr TickType_t SCAN_TTL = configTICK_RATE_HZ * 30;
+    static constexpr TickType_t SCAN_TIMEOUT = configTICK_RATE_HZ * 30;
+    static constexpr TickType_t RESTART_DELAY = configTICK_RATE_HZ * 10;
+    static constexpr size_t MAX_BODY_SIZE = 512;
+    static constexpr uint32_t JOB_STACK_SIZE = 6144;
+
+    ConnectHandler connect;
+    httpd_handle_t httpd = NULL;
+    SemaphoreHandle_t mutex = NULL;
+
+    // guarded by mutex
+    std::vector<std::string> networks;
+    TickType_t scanned_at = 0;
+    bool scan_valid = false;
+    bool scan_requested = false;
+
+    // only touched by loop()
+    bool scanning = false;
+    TickType_t scan_started = 0;
+    TickType_t job_finished = 0;
+
+    std::atomic<JobState> job{JobState::IDLE};
+    std::string job_ssid;
+    std::string job_password;
+
+    bool scanFresh() const;
+    void collectScan();
+
+    static void runJob(void* arg);
+    static esp_err_t handleRoot(httpd_req_t* req);
+    static esp_err_t handleScan(httpd_req_t* req);
+    static esp_err_t handleConfig(httpd_req_t* req);
+    static esp_err_t handleConfigStatus(httpd_req_t* req);
+    static esp_err_t handleNotFound(httpd_req_t* req, httpd_err_code_t error);
+
+  public:
+    PortalServer(ConnectHandler connect);
+
+    bool begin();
+    inline bool active() const { return httpd != NULL; }
+
+    // called from the loop, starts and collects scans and restarts once a
+    // connect job succeeded and the page had time to show it
+    void loop();
+  };
+
+}
@@ -0,0 +1,135 @@
+#include "rotaryinput.h"
+
+namespace fg {
+
+  RotaryInput::RotaryInput(uint8_t pin_a, uint8_t pin_b, uint8_t pin_button) :
+    pin_a(pin_a), pin_b(pin_b), pin_button(pin_button) {}
+
+  void RotaryInput::begin(TaskHandle_t wake_task) {
+    this->wake_task = wake_task;
+
+    pinMode(pin_a, INPUT_PULLUP);
+    pinMode(pin_b, INPUT_PULLUP);
+    pinMode(pin_button, INPUT_PULLUP);
+
+    // both channels count both edges of their pin and use the other pin
+    // for the direction, so every quadrature state change is counted
+    pcnt_config_t config = {};
+    config.pulse_gpio_num = pin_a;
+    config.ctrl_gpio_num = pin_b;
+    config.channel = PCNT_CHANNEL_0;
+    config.unit = PCNT_UNIT;
+    config.pos_mode = PCNT_COUNT_DEC;
+    config.neg_mode = PCNT_COUNT_INC;
+    config.lctrl_mode = PCNT_MODE_REVERSE;
+    config.hctrl_mode = PCNT_MODE_KEEP;
+    config.counter_h_lim = PCNT_LIMIT;
+    config.counter_l_lim = -PCNT_LIMIT;
+    pcnt_unit_config(&config);
+
+    config.pulse_gpio_num = pin_b;
+    config.ctrl_gpio_num = pin_a;
+    config.channel = PCNT_CHANNEL_1;
+    config.pos_mode = PCNT_COUNT_INC;
+    config.neg_mode = PCNT_COUNT_DEC;
+    pcnt_unit_config(&config);
+
+    pcnt_set_filter_value(PCNT_UNIT, PCNT_FILTER);
+    pcnt_filter_enable(PCNT_UNIT);
+    pcnt_counter_pause(PCNT_UNIT);
+    pcnt_counter_clear(PCNT_UNIT);
+    pcnt_counter_resume(PCNT_UNIT);
+    last_count = 0;
+
+    // the pin interrupts only wake the task, the counting is done above
+    attachInterruptArg(pin_button, buttonIsr, this, CHANGE);
+    attachInterruptArg(pin_a, encoderIsr, this, CHANGE);
+    attachInterruptArg(pin_b, encoderIsr, this, CHANGE);
+  }
+
+  void IRAM_ATTR RotaryInput::wake() {
+    if(wake_task) {
+      BaseType_t woken = pdFALSE;
+      vTaskNotifyGiveFromISR(wake_task, &woken);
+      if(woken) {
+        portYIELD_FROM_ISR();
+      }
+    }
+  }
+
+  void IRAM_ATTR RotaryInput::buttonIsr(void* arg) {
+    auto input = static_cast<RotaryInput*>(arg);
+    input->edges.push({xTaskGetTickCountFromISR(), digitalRead(input->pin_button) == LOW});
+    input->wake();
+  }
+
+  void IRAM_ATTR RotaryInput::encoderIsr(void* arg) {
+    static_cast<RotaryInput*>(arg)->wake();
+  }
+
+  void RotaryInput::poll(UserInterface& ui) {
+    int16_t count = 0;
+    if(pcnt_get_counter_value(PCNT_UNIT, &count) == ESP_OK) {
+      int32_t delta = count - last_count;
+      last_count = count;
+      if(delta > PCNT_LIMIT / 2) {
+        delta -= PCNT_LIMIT;
+      }
+      else if(delta < -PCNT_LIMIT / 2) {
+        delta += PCNT_LIMIT;
+      }
+      pending_counts += delta;
+      while(pending_counts >= COUNTS_PER_STEP) {
+        pending_counts -= COUNTS_PER_STEP;
+        ui.next();
+      }
+      while(pending_counts <= -COUNTS_PER_STEP) {
+        pending_counts += COUNTS_PER_STEP;
+        ui.prev();
+      }
+    }
+
+    // an edge counts once the level stayed for DEBOUNCE, bounces in
+    // between are dropped
+    ButtonEdge edge;
+    while(edges.pop(edge)) {
+      if(edge_pending && edge.time - pending_edge.time >= DEBOUNCE) {
+        applyEdge(pending_edge, ui);
+      }
+      pending_edge = edge;
+      edge_pending = true;
+    }
+
+    auto now = xTaskGetTickCount();
+    if(edge_pending && now - pending_edge.time >= DEBOUNCE) {
+      applyEdge(pending_edge, ui);
+      edge_pending = false;
+    }
+
+    if(pressed && !held && now - press_time >= HOLD_TIMEOUT) {
+      held = true;
+      ui.hold();
+    }
+  }
+
+  void RotaryInput::applyEdge(const ButtonEdge& edge, UserInterface& ui) {
+    if(edge.pressed == pressed) {
+      return;
+    }
+    pressed = edge.pressed;
+    if(pressed) {
+      press_time = edge.time;
+      held = false;
+    }
+    else if(!held) {
+      // a long press that was only seen after its release is still a hold
+      if(edge.time - press_time >= HOLD_TIMEOUT) {
+        ui.hold();
+      }
+      else {
+        ui.enter();
+      }
+    }
+  }
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include "Arduino.h"
+#include "driver/pcnt.h"
+#include "fghmi.h"
+
+namespace fg {
+
+  // Rotary encoder with push button. The encoder is decoded in hardware
+  // by a PCNT unit, so no step is lost while the loop is busy. Button
+  // edges are timestamped by an interrupt handler and queued; debouncing
+  // and hold detection run in poll() on the queued timestamps.
+  class RotaryInput {
+    static constexpr pcnt_unit_t PCNT_UNIT = PCNT_UNIT_0;
+    static constexpr int16_t PCNT_LIMIT = 32000; // counter wraps to 0 here
+    static constexpr int16_t COUNTS_PER_STEP = 4; // one detent is a full quadrature cycle
+    static constexpr uint16_t PCNT_FILTER = 1023; // APB cycles, ~12.8us of glitch filtering
+    static constexpr TickType_t DEBOUNCE = 10;
+    static constexpr TickType_t HOLD_TIMEOUT = configTICK_RATE_HZ;
+
+    struct ButtonEdge {
+      TickType_t time;
+      bool pressed;
+    };
+
+    const uint8_t pin_a, pin_b, pin_button;
+    TaskHandle_t wake_task = NULL;
+    SpscRing<ButtonEdge, 32> edges;
+
+    int16_t last_count = 0;
+    int32_t pending_counts = 0;
+
+    ButtonEdge pending_edge;
+    bool edge_pending = false;
+    bool pressed = false;
+    bool held = false;
+    TickType_t press_time = 0;
+
+    void applyEdge(const ButtonEdge& edge, UserInterface& ui);
+    void wake();
+    static void buttonIsr(void* arg);
+    static void encoderIsr(void* arg);
+
+  public:
+    RotaryInput(uint8_t pin_a, uint8_t pin_b, uint8_t pin_button);
+
+    // the task that gets notified on any input, e.g. to end a sleep early
+    void begin(TaskHandle_t wake_task);
+
+    // turns counted steps and button edges into ui actions
+    void poll(UserInterface& ui);
+
+    inline uint32_t droppedEdges() const { return edges.droppedCount(); }
+  };
+
+}
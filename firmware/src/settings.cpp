@@ -7,9 +7,20 @@
 
 #define NVS_PART "nvs"
 #define SETTINGS_NS "settings"
+#define PROVISIONING_PART "nvs_ro"
+#define PROVISIONING_NS "fg_provisioning"
 
 namespace fg {
 
+  namespace {
+    class Lock {
+      SemaphoreHandle_t mutex;
+    public:
+      explicit Lock(SemaphoreHandle_t mutex) : mutex(mutex) { xSemaphoreTake(mutex, portMAX_DELAY); }
+      ~Lock() { xSemaphoreGive(mutex); }
+    };
+  }
+
   SettingsManager::SettingsManager(const char* part, const char* ns, nvs_open_mode mode) {
     // Initialize NVS
     esp_err_t err = nvs_flash_init_partition(part);
@@ -23,6 +34,8 @@ namespace fg {
 
     err = nvs_open_from_partition(part, ns, mode, &my_handle);
     ESP_ERROR_CHECK( err );
+
+    cache_mutex = xSemaphoreCreateMutex();
   }
 
   SettingsManager::SettingsManager() {
@@ -38,69 +51,151 @@ namespace fg {
 
     err = nvs_open("settings", NVS_READWRITE, &my_handle);
     ESP_ERROR_CHECK( err );
+
+    cache_mutex = xSemaphoreCreateMutex();
   }
 
-  bool SettingsManager::has(const char* key) {
+  SettingsManager::CacheEntry* SettingsManager::cached(const char* key, nvs_type_t type) {
+    for(auto& entry : cache) {
+      if(entry.type == type && strncmp(entry.key, key, sizeof(entry.key)) == 0) {
+        cache_hits++;
+        return &entry;
+      }
+    }
+    cache_misses++;
+    return nullptr;
+  }
+
+  SettingsManager::CacheEntry& SettingsManager::insert(const char* key, nvs_type_t type) {
+    invalidate(key);
+    auto& entry = cache[cache_next];
+    cache_next = (cache_next + 1) % CACHE_ENTRIES;
+    strncpy(entry.key, key, sizeof(entry.key) - 1);
+    entry.type = type;
+    entry.found = false;
+    entry.length = 0;
+    entry.number = 0;
+    entry.str[0] = 0;
+    return entry;
+  }
+
+  void SettingsManager::invalidate(const char* key) {
+    for(auto& entry : cache) {
+      if(strncmp(entry.key, key, sizeof(entry.key)) == 0) {
+        entry.type = NVS_TYPE_ANY;
+      }
+    }
+  }
+
+  SettingsManager::CacheEntry& SettingsManager::loadStr(const char* key) {
+    auto entry = cached(key, NVS_TYPE_STR);
+    if(entry) {
+      return *entry;
+    }
+
+    auto& loaded = insert(key, NVS_TYPE_STR);
     size_t required_size;
     auto err = nvs_get_str(my_handle, key, nullptr, &required_size);
     assert(err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND);
-    if(err) {
-      return false;
-    }
-    else {
-      return true;
+    if(!err) {
+      loaded.found = true;
+      loaded.length = required_size - 1;
+      // longer values only remember their length and are read on demand
+      if(required_size <= CACHE_VALUE_SIZE) {
+        nvs_get_str(my_handle, key, loaded.str, &required_size);
+      }
     }
+    return loaded;
+  }
+
+  bool SettingsManager::has(const char* key) {
+    Lock lock(cache_mutex);
+    return loadStr(key).found;
   }
 
   uint8_t SettingsManager::getU8(const char* key) {
+    Lock lock(cache_mutex);
+    auto entry = cached(key, NVS_TYPE_U8);
+    if(entry) {
+      return entry->number;
+    }
+
     uint8_t value;
     auto err = nvs_get_u8(my_handle, key, &value);
     assert(err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND);
-    if(err) {
-      return 0;
-    }
-    else {
-      return value;
-    }
+    auto& loaded = insert(key, NVS_TYPE_U8);
+    loaded.found = !err;
+    loaded.number = err ? 0 : value;
+    return loaded.number;
   }
 
   float SettingsManager::getFloat(const char* key) {
-    uint32_t dummy;
-    auto err = nvs_get_u32(my_handle, key, &dummy);
-    assert(err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND);
-    if(err) {
-      return 0;
-    }
-    else {
-      float value;
-      memcpy(&value, &dummy, sizeof(float));
-      return value;
+    Lock lock(cache_mutex);
+    auto entry = cached(key, NVS_TYPE_U32);
+    if(!entry) {
+      uint32_t dummy;
+      auto err = nvs_get_u32(my_handle, key, &dummy);
+      assert(err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND);
+      entry = &insert(key, NVS_TYPE_U32);
+      entry->found = !err;
+      entry->number = err ? 0 : dummy;
     }
+
+    float value;
+    static_assert(sizeof(entry->number) == sizeof(value), "");
+    memcpy(&value, &entry->number, sizeof(float));
+    return value;
   }
 
+  bool SettingsManager::getStr(const char* key, char* value, size_t size) {
+    if(size == 0) {
+      return false;
+    }
+    value[0] = 0;
+
+    Lock lock(cache_mutex);
+    auto& entry = loadStr(key);
+    if(!entry.found || entry.length >= size) {
+      return false;
+    }
+    if(entry.length < CACHE_VALUE_SIZE) {
+      memcpy(value, entry.str, entry.length + 1);
+      return true;
+    }
+    size_t required_size = size;
+    return nvs_get_str(my_handle, key, value, &required_size) == ESP_OK;
+  }
 
   std::string SettingsManager::getStr(const char* key) {
-    size_t required_size;
-    auto err = nvs_get_str(my_handle, key, nullptr, &required_size);
-    assert(err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND);
-    if(err) {
+    Lock lock(cache_mutex);
+    auto& entry = loadStr(key);
+    if(!entry.found) {
       return "";
     }
-    else {
-      std::string value;
-      value.resize(required_size);
-      nvs_get_str(my_handle, key, const_cast<char*>(value.c_str()), &required_size);
-      return value;
+    if(entry.length < CACHE_VALUE_SIZE) {
+      return std::string(entry.str, entry.length);
     }
+    std::string value;
+    size_t required_size = entry.length + 1;
+    value.resize(required_size);
+    nvs_get_str(my_handle, key, &value[0], &required_size);
+    value.resize(entry.length);
+    return value;
   }
 
   esp_err_t SettingsManager::setStr(const char* key, const char* value) {
+    Lock lock(cache_mutex);
+    invalidate(key);
+    writes++;
     auto err = nvs_set_str(my_handle, key, value);
     ESP_ERROR_CHECK( err );
     return err;
   }
 
   esp_err_t SettingsManager::setU8(const char* key, uint8_t value){
+    Lock lock(cache_mutex);
+    invalidate(key);
+    writes++;
     return nvs_set_u8(my_handle, key, value);
   }
 
@@ -108,18 +203,49 @@ namespace fg {
     uint32_t dummy;
     static_assert(sizeof(dummy) == sizeof(value), "");
     memcpy(&dummy, &value, sizeof(float));
+    Lock lock(cache_mutex);
+    invalidate(key);
+    writes++;
     return nvs_set_u32(my_handle, key, dummy);
   }
 
+  bool SettingsManager::getBlob(const char* key, std::vector<uint8_t>& data) {
+    size_t required_size;
+    auto err = nvs_get_blob(my_handle, key, nullptr, &required_size);
+    assert(err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND);
+    if(err) {
+      data.clear();
+      return false;
+    }
+    data.resize(required_size);
+    return nvs_get_blob(my_handle, key, data.data(), &required_size) == ESP_OK;
+  }
+
+  esp_err_t SettingsManager::setBlob(const char* key, const void* data, size_t size) {
+    Lock lock(cache_mutex);
+    invalidate(key);
+    writes++;
+    auto err = nvs_set_blob(my_handle, key, data, size);
+    ESP_ERROR_CHECK( err );
+    return err;
+  }
+
   void SettingsManager::commit() {
+    commits++;
     nvs_commit(my_handle);
   }
 
   esp_err_t SettingsManager::erase(const char* key) {
+    Lock lock(cache_mutex);
+    invalidate(key);
     return nvs_erase_key(my_handle, key);
   }
 
   esp_err_t SettingsManager::wipe() {
+    Lock lock(cache_mutex);
+    for(auto& entry : cache) {
+      entry.type = NVS_TYPE_ANY;
+    }
     return nvs_erase_all(my_handle);
   }
 
@@ -128,4 +254,9 @@ namespace fg {
     return instance;
   }
 
+  SettingsManager& provisioning() {
+    static SettingsManager instance(PROVISIONING_PART, PROVISIONING_NS);
+    return instance;
+  }
+
 }
\ No newline at end of file
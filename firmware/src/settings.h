@@ -1,29 +1,83 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "nvs_flash.h"
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
 namespace fg {
 
+  // One NVS namespace, opened once. Frequently read keys are cached in RAM
+  // after the first lookup; every write or erase through the manager
+  // invalidates the cached entry, so the cache never serves stale values.
   class SettingsManager {
+  public:
+    // strings shorter than this are kept in the cache
+    static constexpr size_t CACHE_VALUE_SIZE = 64;
+
+  private:
+    static constexpr size_t CACHE_ENTRIES = 16;
+
+    struct CacheEntry {
+      char key[NVS_KEY_NAME_MAX_SIZE] = {0};
+      nvs_type_t type = NVS_TYPE_ANY; // NVS_TYPE_ANY marks a free slot
+      bool found = false;
+      size_t length = 0;
+      uint32_t number = 0;
+      char str[CACHE_VALUE_SIZE] = {0};
+    };
+
     nvs_handle my_handle;
+    SemaphoreHandle_t cache_mutex;
+    CacheEntry cache[CACHE_ENTRIES];
+    size_t cache_next = 0;
+
+    uint32_t writes = 0;
+    uint32_t commits = 0;
+    uint32_t cache_hits = 0;
+    uint32_t cache_misses = 0;
+
+    CacheEntry* cached(const char* key, nvs_type_t type);
+    CacheEntry& insert(const char* key, nvs_type_t type);
+    CacheEntry& loadStr(const char* key);
+    void invalidate(const char* key);
+
   public:
     SettingsManager();
     SettingsManager(const char* part, const char* ns, nvs_open_mode mode = NVS_READONLY);
     bool has(const char* key);
-    std::string getStr(const char* key);
     uint8_t getU8(const char* key);
     float getFloat(const char* key);
+
+    // Copies the string into the caller's buffer without allocating.
+    // Returns false and leaves an empty string if the key is missing or
+    // the value does not fit.
+    bool getStr(const char* key, char* value, size_t size);
+    std::string getStr(const char* key);
+
     esp_err_t setStr(const char* key, const char* str);
     esp_err_t setU8(const char* key, uint8_t value);
     esp_err_t setFloat(const char* key, float value);
+    bool getBlob(const char* key, std::vector<uint8_t>& data);
+    esp_err_t setBlob(const char* key, const void* data, size_t size);
 
     void commit();
     esp_err_t erase(const char* key);
     esp_err_t wipe();
+
+    // flash wear statistics since boot
+    uint32_t writeCount() const { return writes; }
+    uint32_t commitCount() const { return commits; }
+    uint32_t cacheHits() const { return cache_hits; }
+    uint32_t cacheMisses() const { return cache_misses; }
   };
 
+  // the "settings" namespace of the default partition
   SettingsManager& settings();
 
-}
\ No newline at end of file
+  // the read only factory provisioning data
+  SettingsManager& provisioning();
+
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+namespace fg {
+
+  // Settings structs describe their fields once in a bind() template,
+  //
+  //   template<class Binder> void bind(Binder& b) {
+  //     b.transient({"mqttcontrol"}, mqttcontrol);
+  //     b.field({"day", "temperature"}, day.temperature, -20.0f, 80.0f);
+  //   }
+  //
+  // and the binders below generate parsing, serialisation and printing from
+  // it. Missing or out of range fields keep the struct default and are
+  // reported, optional() fields (added after configurations without them
+  // were out) are only reported when present but invalid. Transient
+  // fields are read and printed but never written back. A std::vector of
+  // structs with their own bind() maps to a JSON array of objects.
+  typedef std::initializer_list<const char*> SettingsPath;
+
+  // keeps range bounds out of template argument deduction
+  template<class T> struct SettingsBound { typedef T type; };
+
+  class SettingsReader {
+    JsonVariantConst root;
+    unsigned errors = 0;
+
+    JsonVariantConst lookup(SettingsPath path) const {
+      JsonVariantConst node = root;
+      for(auto key : path) {
+        node = node[key];
+      }
+      return node;
+    }
+
+    void error(const char* message, SettingsPath path) {
+      errors++;
+      Serial.print(message);
+      for(auto key : path) {
+        Serial.print(" ");
+        Serial.print(key);
+      }
+      Serial.println();
+    }
+
+    static bool convert(JsonVariantConst node, String& value) {
+      if(!node.is<const char*>()) {
+        return false;
+      }
+      value = node.as<const char*>();
+      return true;
+    }
+
+    static bool convert(JsonVariantConst node, bool& value) {
+      if(!node.is<bool>() && !node.is<float>()) {
+        return false;
+      }
+      value = node.is<bool>() ? node.as<bool>() : node.as<float>() != 0.0f;
+      return true;
+    }
+
+    template<class T>
+    static bool convert(JsonVariantConst node, T& value) {
+      static_assert(std::is_arithmetic<T>::value, "unsupported settings field type");
+      if(!node.is<float>()) {
+        return false;
+      }
+      value = node.as<T>();
+      return true;
+    }
+
+  public:
+    explicit SettingsReader(JsonVariantConst root) : root(root) {}
+
+    template<class T>
+    void field(SettingsPath path, T& value) {
+      auto node = lookup(path);
+      if(node.isNull()) {
+        error("error loading settings field", path);
+      }
+      else if(!convert(node, value)) {
+        error("invalid settings field", path);
+      }
+    }
+
+    template<class T>
+    void field(SettingsPath path, T& value, typename SettingsBound<T>::type min, typename SettingsBound<T>::type max) {
+      T parsed = value;
+      field(path, parsed);
+      if(parsed < min || parsed > max) {
+        error("settings field out of range", path);
+      }
+      else {
+        value = parsed;
+      }
+    }
+
+    template<class T>
+    void field(SettingsPath path, std::vector<T>& values) {
+      auto node = lookup(path);
+      if(!node.is<JsonArrayConst>()) {
+        error("error loading settings field", path);
+        return;
+      }
+      values.clear();
+      for(JsonVariantConst element : node.as<JsonArrayConst>()) {
+        T value;
+        SettingsReader reader(element);
+        value.bind(reader);
+        errors += reader.errors;
+        values.push_back(value);
+      }
+    }
+
+    template<class T>
+    void optional(SettingsPath path, T& value) {
+      if(!lookup(path).isNull()) {
+        field(path, value);
+      }
+    }
+
+    template<class T>
+    void optional(SettingsPath path, T& value, typename SettingsBound<T>::type min, typename SettingsBound<T>::type max) {
+      if(!lookup(path).isNull()) {
+        field(path, value, min, max);
+      }
+    }
+
+    template<class T>
+    void transient(SettingsPath path, T& value) {
+      field(path, value);
+    }
+
+    unsigned errorCount() const { return errors; }
+  };
+
+  class SettingsWriter {
+    JsonObject root;
+
+    JsonObject parent(SettingsPath path) {
+      JsonObject object = root;
+      auto last = path.end() - 1;
+      for(auto key = path.begin(); key != last; key++) {
+        JsonObject child = object[*key].as<JsonObject>();
+        object = child.isNull() ? object.createNestedObject(*key) : child;
+      }
+      return object;
+    }
+
+  public:
+    explicit SettingsWriter(JsonObject root) : root(root) {}
+
+    template<class T>
+    void field(SettingsPath path, const T& value) {
+      parent(path)[*(path.end() - 1)] = value;
+    }
+
+    template<class T>
+    void field(SettingsPath path, const T& value, typename SettingsBound<T>::type, typename SettingsBound<T>::type) {
+      field(path, value);
+    }
+
+    template<class T>
+    void field(SettingsPath path, std::vector<T>& values) {
+      JsonArray array = parent(path).createNestedArray(*(path.end() - 1));
+      for(auto& value : values) {
+        SettingsWriter writer(array.createNestedObject());
+        value.bind(writer);
+      }
+    }
+
+    template<class T>
+    void optional(SettingsPath path, const T& value) {
+      field(path, value);
+    }
+
+    template<class T>
+    void optional(SettingsPath path, const T& value, typename SettingsBound<T>::type, typename SettingsBound<T>::type) {
+      field(path, value);
+    }
+
+    template<class T>
+    void transient(SettingsPath, const T&) {}
+  };
+
+  class SettingsPrinter {
+    String prefix;
+
+    void printPath(SettingsPath path) const {
+      Serial.print(prefix);
+      for(auto key : path) {
+        Serial.print(".");
+        Serial.print(key);
+      }
+      Serial.print(": ");
+    }
+
+    static void print(const String& value) { Serial.println(value); }
+    static void print(bool value) { Serial.println(value ? "YES" : "NO"); }
+    static void print(float value) { Serial.println(value, 2); }
+    static void print(double value) { Serial.println(value, 2); }
+    static void print(uint32_t value) { Serial.println(value); }
+
+  public:
+    explicit SettingsPrinter(const String& prefix = "new_settings") : prefix(prefix) {}
+
+    template<class T>
+    void field(SettingsPath path, const T& value) {
+      printPath(path);
+      print(value);
+    }
+
+    template<class T>
+    void field(SettingsPath path, std::vector<T>& values) {
+      for(size_t i = 0; i < values.size(); i++) {
+        String element = prefix;
+        for(auto key : path) {
+          element += ".";
+          element += key;
+        }
+        element += "[" + String(i) + "]";
+        SettingsPrinter printer(element);
+        values[i].bind(printer);
+      }
+    }
+
+    template<class T>
+    void field(SettingsPath path, const T& value, typename SettingsBound<T>::type, typename SettingsBound<T>::type) {
+      field(path, value);
+    }
+
+    template<class T>
+    void optional(SettingsPath path, const T& value) {
+      field(path, value);
+    }
+
+    template<class T>
+    void optional(SettingsPath path, const T& value, typename SettingsBound<T>::type, typename SettingsBound<T>::type) {
+      field(path, value);
+    }
+
+    template<class T>
+    void transient(SettingsPath path, const T& value) {
+      field(path, value);
+    }
+  };
+
+  // Takes transient fields back to their value-initialised default, which
+  // is what every settings struct declares for them (mqttcontrol = false).
+  class SettingsTransientReset {
+  public:
+    template<class T>
+    void field(SettingsPath, const T&) {}
+
+    template<class T>
+    void field(SettingsPath, const T&, typename SettingsBound<T>::type, typename SettingsBound<T>::type) {}
+
+    template<class T>
+    void optional(SettingsPath, const T&) {}
+
+    template<class T>
+    void optional(SettingsPath, const T&, typename SettingsBound<T>::type, typename SettingsBound<T>::type) {}
+
+    template<class T>
+    void transient(SettingsPath, T& value) {
+      value = T();
+    }
+  };
+
+  template<class Settings>
+  unsigned readSettings(JsonVariantConst json, Settings& settings) {
+    SettingsReader reader(json);
+    settings.bind(reader);
+    return reader.errorCount();
+  }
+
+  template<class Settings>
+  void writeSettings(Settings& settings, JsonObject json) {
+    SettingsWriter writer(json);
+    settings.bind(writer);
+  }
+
+  template<class Settings>
+  void resetTransientSettings(Settings& settings) {
+    SettingsTransientReset reset;
+    settings.bind(reset);
+  }
+
+  template<class Settings>
+  void printSettings(Settings& settings) {
+    SettingsPrinter printer;
+    Serial.printf("#################################################\n\r");
+    settings.bind(printer);
+    Serial.printf("#################################################\n\r");
+  }
+
+}
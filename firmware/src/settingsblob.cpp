@@ -0,0 +1,30 @@
+#include "settingsblob.h"
+#include "esp_rom_crc.h"
+
+namespace fg {
+
+  namespace blob {
+
+    // 16 bit FNV-1a over the path segments, separated by '/'
+    uint16_t tag(SettingsPath path) {
+      uint32_t hash = 2166136261u;
+      bool first = true;
+      for(auto key : path) {
+        if(!first) {
+          hash = (hash ^ '/') * 16777619u;
+        }
+        first = false;
+        for(auto c = key; *c; c++) {
+          hash = (hash ^ (uint8_t)*c) * 16777619u;
+        }
+      }
+      return (hash >> 16) ^ (hash & 0xFFFF);
+    }
+
+    uint32_t crc(const uint8_t* data, size_t size) {
+      return esp_rom_crc32_le(0, data, size);
+    }
+
+  }
+
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include "settings.h"
+#include "settingsbinder.h"
+
+namespace fg {
+
+  // Binary settings storage generated from the same bind() schema as the
+  // JSON binders. Every field is stored as a tagged record
+  //
+  //   tag (u16, hash of the JSON path) | type (u8) | length (u16) | payload
+  //
+  // behind a header with magic, format version, payload size and CRC32.
+  // Fields are looked up by tag, so fields added to a schema keep their
+  // default and removed fields are skipped when an older blob is loaded.
+  namespace blob {
+
+    static constexpr uint32_t MAGIC = 0x53464746; // "FGFS"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr const char* KEY = "config_bin";
+
+    enum Type : uint8_t {
+      BOOL = 1,
+      U32 = 2,
+      FLOAT = 3,
+      STRING = 4,
+      LIST = 5
+    };
+
+    struct Header {
+      uint32_t magic;
+      uint16_t version;
+      uint16_t size;
+      uint32_t crc;
+    };
+
+    static constexpr size_t RECORD_HEADER = 5;
+
+    uint16_t tag(SettingsPath path);
+    uint32_t crc(const uint8_t* data, size_t size);
+
+  }
+
+  class SettingsBlobWriter {
+    std::vector<uint8_t>& out;
+
+    void record(SettingsPath path, blob::Type type, const void* data, size_t size) {
+      auto tag = blob::tag(path);
+      out.push_back(tag & 0xFF);
+      out.push_back(tag >> 8);
+      out.push_back(type);
+      out.push_back(size & 0xFF);
+      out.push_back(size >> 8);
+      auto bytes = static_cast<const uint8_t*>(data);
+      out.insert(out.end(), bytes, bytes + size);
+    }
+
+  public:
+    explicit SettingsBlobWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void field(SettingsPath path, const bool& value) {
+      uint8_t raw = value;
+      record(path, blob::BOOL, &raw, 1);
+    }
+    void field(SettingsPath path, const uint32_t& value) { record(path, blob::U32, &value, 4); }
+    void field(SettingsPath path, const float& value) { record(path, blob::FLOAT, &value, 4); }
+    void field(SettingsPath path, const String& value) { record(path, blob::STRING, value.c_str(), value.length()); }
+
+    template<class T>
+    void field(SettingsPath path, std::vector<T>& values) {
+      std::vector<uint8_t> list;
+      for(auto& value : values) {
+        std::vector<uint8_t> element;
+        SettingsBlobWriter writer(element);
+        value.bind(writer);
+        list.push_back(element.size() & 0xFF);
+        list.push_back(element.size() >> 8);
+        list.insert(list.end(), element.begin(), element.end());
+      }
+      record(path, blob::LIST, list.data(), list.size());
+    }
+
+    template<class T>
+    void field(SettingsPath path, const T& value, typename SettingsBound<T>::type, typename SettingsBound<T>::type) {
+      field(path, value);
+    }
+
+    template<class T>
+    void optional(SettingsPath path, const T& value) {
+      field(path, value);
+    }
+
+    template<class T>
+    void optional(SettingsPath path, const T& value, typename SettingsBound<T>::type, typename SettingsBound<T>::type) {
+      field(path, value);
+    }
+
+    template<class T>
+    void transient(SettingsPath, const T&) {}
+  };
+
+  class SettingsBlobReader {
+    const uint8_t* data;
+    size_t size;
+    size_t cursor = 0;
+
+    // records are usually read back in the order they were written, so
+    // the next record is checked before scanning from the start
+    bool find(SettingsPath path, blob::Type type, const uint8_t*& payload, size_t& length) {
+      auto tag = blob::tag(path);
+      for(int pass = 0; pass < 2; pass++) {
+        size_t position = pass ? 0 : cursor;
+        while(position + blob::RECORD_HEADER <= size) {
+          uint16_t record_tag = data[position] | data[position + 1] << 8;
+          uint8_t record_type = data[position + 2];
+          size_t record_length = data[position + 3] | data[position + 4] << 8;
+          size_t next = position + blob::RECORD_HEADER + record_length;
+          if(next > size) {
+            return false;
+          }
+          if(record_tag == tag && record_type == type) {
+            payload = data + position + blob::RECORD_HEADER;
+            length = record_length;
+            cursor = next;
+            return true;
+          }
+          position = next;
+          if(pass == 0) {
+            break;
+          }
+        }
+      }
+      return false;
+    }
+
+    template<class T>
+    void fixed(SettingsPath path, blob::Type type, T& value) {
+      const uint8_t* payload;
+      size_t length;
+      if(find(path, type, payload, length) && length == sizeof(T)) {
+        memcpy(&value, payload, sizeof(T));
+      }
+    }
+
+  public:
+    SettingsBlobReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    void field(SettingsPath path, bool& value) {
+      uint8_t raw = value;
+      fixed(path, blob::BOOL, raw);
+      value = raw;
+    }
+    void field(SettingsPath path, uint32_t& value) { fixed(path, blob::U32, value); }
+    void field(SettingsPath path, float& value) { fixed(path, blob::FLOAT, value); }
+
+    void field(SettingsPath path, String& value) {
+      const uint8_t* payload;
+      size_t length;
+      if(find(path, blob::STRING, payload, length)) {
+        value = "";
+        value.concat(reinterpret_cast<const char*>(payload), length);
+      }
+    }
+
+    template<class T>
+    void field(SettingsPath path, std::vector<T>& values) {
+      const uint8_t* payload;
+      size_t length;
+      if(!find(path, blob::LIST, payload, length)) {
+        return;
+      }
+      values.clear();
+      size_t position = 0;
+      while(position + 2 <= length) {
+        size_t element_length = payload[position] | payload[position + 1] << 8;
+        position += 2;
+        if(position + element_length > length) {
+          break;
+        }
+        T value;
+        SettingsBlobReader reader(payload + position, element_length);
+        value.bind(reader);
+        values.push_back(value);
+        position += element_length;
+      }
+    }
+
+    template<class T>
+    void field(SettingsPath path, T& value, typename SettingsBound<T>::type min, typename SettingsBound<T>::type max) {
+      T stored = value;
+      field(path, stored);
+      if(!(stored < min || stored > max)) {
+        value = stored;
+      }
+    }
+
+    // missing records keep the default anyway
+    template<class T>
+    void optional(SettingsPath path, T& value) {
+      field(path, value);
+    }
+
+    template<class T>
+    void optional(SettingsPath path, T& value, typename SettingsBound<T>::type min, typename SettingsBound<T>::type max) {
+      field(path, value, min, max);
+    }
+
+    template<class T>
+    void transient(SettingsPath, T&) {}
+  };
+
+  // Loads settings stored with storeSettings(). Returns false and leaves
+  // the struct untouched if the blob is missing, corrupt or was written by
+  // a newer format version.
+  template<class Settings>
+  bool loadStoredSettings(Settings& settings, const char* key = blob::KEY) {
+    std::vector<uint8_t> data;
+    if(!fg::settings().getBlob(key, data) || data.size() < sizeof(blob::Header)) {
+      return false;
+    }
+
+    blob::Header header;
+    memcpy(&header, data.data(), sizeof(header));
+    auto payload = data.data() + sizeof(header);
+    if(header.magic != blob::MAGIC || header.version > blob::VERSION ||
+       header.size != data.size() - sizeof(header) || header.crc != blob::crc(payload, header.size)) {
+      Serial.println("stored settings invalid");
+      return false;
+    }
+
+    SettingsBlobReader reader(payload, header.size);
+    settings.bind(reader);
+    return true;
+  }
+
+  template<class Settings>
+  void storeSettings(Settings& settings, const char* key = blob::KEY) {
+    std::vector<uint8_t> data(sizeof(blob::Header));
+    SettingsBlobWriter writer(data);
+    settings.bind(writer);
+
+    blob::Header header;
+    header.magic = blob::MAGIC;
+    header.version = blob::VERSION;
+    header.size = data.size() - sizeof(header);
+    header.crc = blob::crc(data.data() + sizeof(header), header.size);
+    memcpy(data.data(), &header, sizeof(header));
+
+    fg::settings().setBlob(key, data.data(), data.size());
+    fg::settings().commit();
+  }
+
+}
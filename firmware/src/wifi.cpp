@@ -5,26 +5,26 @@
 
 #include <WiFiClient.h>
 #include <DNSServerAsync.h>
-#include <WebServer.h>
 #include <ESPmDNS.h>
-#include "ESP32HTTPUpdateServer.h"
 #include <Update.h>
 
 #include <ArduinoJson.h>
 #include <EEPROM.h>
 #include <array>
-#include <sstream>
 #include <cctype>
 #include <HTTPClient.h>
 
 #include "fridgecloud.h"
 
-#include "cppcodec/base64_rfc4648.hpp"
-#include "html_compressed/index.html.h"
+#include "portalserver.h"
+#include "wifilink.h"
 
 #define WIFI_SCAN_TIMEOUT 30000
+#define WIFI_CONNECT_TIMEOUT 1000
+#define WIFI_FAST_CONNECT_TIMEOUT 150
 
 static constexpr TickType_t SMART_SOCKET_RESEND_PERIOD = configTICK_RATE_HZ * 60;
+static constexpr size_t SMART_SOCKET_PASSWORD_SIZE = 128;
 
 
 namespace fg {
@@ -36,20 +36,18 @@ namespace fg {
     UserInterface::display.setTextColor(SSD1306_WHITE); // Draw white text
     UserInterface::display.setTextSize(1);
 
-    std::stringstream value_print;
-    value_print << "connect to:";
     UserInterface::display.setCursor(1, 1);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write("connect to:");
 
-    value_print.str(std::string());
-    value_print << "SSID: " << ssid;
+    TextBuffer<48> value_print;
+    value_print.append("SSID: ").append(ssid.c_str());
     UserInterface::display.setCursor(1, 15);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write(value_print.c_str());
 
-    value_print.str(std::string());
-    value_print << "IP:   " << ip;
+    value_print.clear();
+    value_print.append("IP:   ").append(ip.c_str());
     UserInterface::display.setCursor(1, 25);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write(value_print.c_str());
   }
 
   void WifiApDash::prev() {}
@@ -67,25 +65,23 @@ namespace fg {
     UserInterface::display.setTextColor(SSD1306_WHITE); // Draw white text
     UserInterface::display.setTextSize(1);
 
-    std::stringstream value_print;
-    value_print << "current connection:";
     UserInterface::display.setCursor(1, 1);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write("current connection:");
 
-    value_print.str(std::string());
-    value_print << "SSID: " << ssid;
+    TextBuffer<48> value_print;
+    value_print.append("SSID: ").append(ssid.c_str());
     UserInterface::display.setCursor(1, 15);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write(value_print.c_str());
 
-    value_print.str(std::string());
-    value_print << "RSSI: " << rssi;
+    value_print.clear();
+    value_print.append("RSSI: ").fixed(rssi, 0);
     UserInterface::display.setCursor(1, 25);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write(value_print.c_str());
 
-    value_print.str(std::string());
-    value_print << "IP:   " << ip;
+    value_print.clear();
+    value_print.append("IP:   ").append(ip.c_str());
     UserInterface::display.setCursor(1, 35);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write(value_print.c_str());
   }
 
   void WifiStaDash::prev() {}
@@ -116,7 +112,6 @@ std::string secondary_password;
 
 bool loadWifiCredentials();
 void saveWifiCredentials();
-void InitalizeHTTPServer();
 std::vector<std::string> scanWifiNetworks();
 bool isHexSegment(const std::string& value, size_t expected_len);
 bool isSmartSocketSsid(const std::string& value);
@@ -134,16 +129,13 @@ const std::vector<std::string>& getSocketRolesList();
 std::vector<std::string> getSocketRoleOptions();
 boolean createConfigurationAP();
 bool connectToWifi(std::string ssid, std::string password);
+static bool waitForWifi(unsigned int timeout);
 
 
-void handleNotFound();
-void handleRoot();
-void handleGetScan();
 String formatBytes(size_t bytes);
 String toStringIp(IPAddress ip);
 String GetEncryptionType(byte thisType);
 boolean isIp(String str);
-void handleConfig();
 boolean captivePortal();
 
 
@@ -152,8 +144,19 @@ boolean captivePortal();
 const byte DNS_PORT = 53;
 DNSServer dnsServer;
 
-// Web server
-WebServer server(80);
+// Captive portal, the connect job stores the credentials once connected
+fg::PortalServer portal_server([](const std::string& ssid, const std::string& password) {
+  primary_ssid = ssid;
+  primary_password = password;
+  if(!connectToWifi(primary_ssid, primary_password)) {
+    return false;
+  }
+  saveWifiCredentials();
+  return true;
+});
+
+// Station link to the configured network, reconnects on its own
+fg::WifiLink wifi_link;
 
 /* Soft AP network parameters */
 IPAddress apIP(172, 20, 0, 1);
@@ -168,7 +171,6 @@ unsigned long startMillis;
 
 /** Current WLAN status */
 short status = WL_IDLE_STATUS;
-bool server_active = false;
 
 bool wifi_configured = false;
 
@@ -189,10 +191,18 @@ static fg::Fridgecloud* smart_socket_cloud_handle = nullptr;
 
 static void syncSmartSocketRole(const char* role, bool target_on, SmartSocketSyncState& role_state);
 
-bool initializeWifi() {
+bool initializeWifi(fg::Fridgecloud* cloud) {
   WiFi.persistent(false);
   WiFi.disconnect();
 
+  wifi_link.begin([cloud](uint32_t down_ms, bool fast, uint8_t reason) {
+    if(cloud) {
+      char message[64];
+      snprintf(message, sizeof(message), "message-wifi-reconnected:%u:%s:%u", down_ms, fast ? "fast" : "scan", reason);
+      cloud->log(message);
+    }
+  });
+
   //handleRoot();
 
   WiFi.setHostname(DEFAULT_HOSTNAME); // Set the DHCP hostname assigned to ESP station.
@@ -216,25 +226,10 @@ bool initializeWifi() {
 }
 
 void wifiTick() {
-  static TickType_t last_conncheck = xTaskGetTickCount();
-
-  if(server_active) {
-    try {
-      server.handleClient();
-    }
-    catch(...) {
-      Serial.println("EXCEPTION!");
-    }
-  }
+  portal_server.loop();
 
-  if(wifi_configured && xTaskGetTickCount() - last_conncheck > 30000) {
-    last_conncheck = xTaskGetTickCount();
-    if(!wifiIsConnected()) {
-      WiFi.mode(WIFI_OFF);
-      delay(100);
-      WiFi.mode(WIFI_STA);
-      connectToWifi(primary_ssid, primary_password);
-    }
+  if(wifi_configured) {
+    wifi_link.loop(primary_ssid, primary_password);
   }
 
   if(smart_socket_outputs_reported) {
@@ -284,25 +279,28 @@ std::string custom_mqtt_pass;
 std::string custom_mqtt_id;
 uint8_t custom_mqtt_enabled;
 
-bool sendSmartSocketPower(const std::string& role, bool turn_on) {
-  const std::string key = socketRoleKey(role);
-  const std::string socket_ip = sanitizeSettingString(fg::settings().getStr(key.c_str()));
-  if(socket_ip.empty()) {
+// web password of the smart sockets, a custom mqtt password takes precedence
+static bool smartSocketPassword(char* password, size_t size) {
+  if(fg::settings().getStr("mqtt_pass", password, size) && password[0]) {
     return true;
   }
+  return fg::provisioning().getStr("mqtt_password", password, size) && password[0];
+}
 
-  std::string mqtt_password = sanitizeSettingString(fg::settings().getStr("mqtt_pass"));
-  if(mqtt_password.empty()) {
-    fg::SettingsManager provisioning(NVS_PART, "fg_provisioning");
-    mqtt_password = sanitizeSettingString(provisioning.getStr("mqtt_password"));
+bool sendSmartSocketPower(const std::string& role, bool turn_on) {
+  char socket_ip[fg::SettingsManager::CACHE_VALUE_SIZE];
+  if(!fg::settings().getStr(socketRoleKey(role).c_str(), socket_ip, sizeof(socket_ip)) || !socket_ip[0]) {
+    return true;
   }
-  if(mqtt_password.empty()) {
+
+  char mqtt_password[SMART_SOCKET_PASSWORD_SIZE];
+  if(!smartSocketPassword(mqtt_password, sizeof(mqtt_password))) {
     return false;
   }
 
   const std::string auth = "user=admin&password=" + urlEncode(mqtt_password) + "&";
   const std::string command = turn_on ? "Power%20On" : "Power%20Off";
-  return httpGet("http://" + socket_ip + "/cm?" + auth + "cmnd=" + command);
+  return httpGet(std::string("http://") + socket_ip + "/cm?" + auth + "cmnd=" + command);
 }
 
 static void updateSmartSocketSyncStateForRole(const std::string& role) {
@@ -537,13 +535,8 @@ void showSmartSocketsUi(fg::UserInterface* ui, fg::Fridgecloud* cloud) {
         smart_socket_cloud_handle->log(std::string("message-smart-socket-disconnected:") + selected_role, 0);
       }
 
-      std::string mqtt_password = sanitizeSettingString(fg::settings().getStr("mqtt_pass"));
-      if(mqtt_password.empty()) {
-        fg::SettingsManager provisioning(NVS_PART, "fg_provisioning");
-        mqtt_password = sanitizeSettingString(provisioning.getStr("mqtt_password"));
-      }
-
-      if(!socket_ip.empty() && !mqtt_password.empty()) {
+      char mqtt_password[SMART_SOCKET_PASSWORD_SIZE];
+      if(!socket_ip.empty() && smartSocketPassword(mqtt_password, sizeof(mqtt_password))) {
         const std::string auth_query = "user=admin&password=" + urlEncode(mqtt_password) + "&";
         httpGet("http://" + socket_ip + "/cm?" + auth_query + "cmnd=Reset%201");
       }
@@ -572,6 +565,13 @@ void showWifiUi(fg::UserInterface* ui, fg::Fridgecloud* cloud) {
       });
     });
 
+    menu->addOption("static ip", [ui](){
+      ui->push<SelectInput>("static ip", wifi_link.staticIp(), std::vector<std::string>{"off", "on"}, [ui](uint32_t selected) {
+        wifi_link.setStaticIp(selected);
+        ui->pop();
+      });
+    });
+
     menu->addOption("clear saved wifi", [ui](){
       resetCredentials();
       ui_handle->push<TextDisplay>("wifi connection cleared");
@@ -787,20 +787,6 @@ std::string randomSsid() {
   return ssid;
 }
 
-void handleNotFound() {
-  server.sendHeader("Location", "/portal");
-  server.send(302, "text/plain", "redirect to captive portal");
-}
-
-void InitalizeHTTPServer() {
-  server.on("/config", handleConfig);
-  server.on("/portal", handleRoot);
-  server.on("/scan", handleGetScan);
-  server.onNotFound ( handleNotFound );
-
-  server.begin();
-}
-
 boolean createConfigurationAP()
 {
   ip = apIP.toString().c_str();
@@ -817,9 +803,7 @@ boolean createConfigurationAP()
     //WiFi.softAPConfig(apIP, apIP, netMsk);
     dnsServer.start();
     Serial.println(F("successful."));
-    InitalizeHTTPServer();
-    server_active = true;
-    return true;
+    return portal_server.begin();
   }
   else {
     Serial.println(F("Soft AP Error."));
@@ -830,7 +814,6 @@ boolean createConfigurationAP()
 bool connectToWifi(std::string ssid, std::string password) {
   Serial.print(F("Connecting to wifi network "));
   Serial.println(ssid.c_str());
-  delay(1000);
 
   if(wifiIsConnected()) {
     WiFi.disconnect();
@@ -841,20 +824,45 @@ bool connectToWifi(std::string ssid, std::string password) {
       Serial.println(status);
     }
   }
-  //WiFi.scanDelete();
 
-  if(password != "") {
-    WiFi.begin(ssid.c_str(), password.c_str());
+  // the known access point first, scanning takes seconds
+  bool connected = false;
+  if(wifi_link.beginFast(ssid, password)) {
+    connected = waitForWifi(WIFI_FAST_CONNECT_TIMEOUT);
+    if(!connected) {
+      Serial.println(F("Fast connect failed, scanning."));
+      WiFi.disconnect();
+    }
   }
-  else {
-    WiFi.begin(ssid.c_str());
+  if(!connected) {
+    wifi_link.beginFull(ssid, password);
+    connected = waitForWifi(WIFI_CONNECT_TIMEOUT);
   }
+  wifi_link.settle();
+
+  if(!connected) {
+    WiFi.disconnect();
+    WiFi.setAutoConnect(false);
+    return false;
+  }
+
+  Serial.println(F("Connection successful."));
+  Serial.println("IP address: ");
+  Serial.print(WiFi.localIP());
+  Serial.print(" / ");
+  Serial.println(WiFi.macAddress());
+  WiFi.setAutoConnect(true);
 
-  Serial.println(F("Status:"));
-  Serial.println(status);
+  if(ssid == primary_ssid) {
+    wifi_link.remember(ssid);
+  }
+  return true;
+}
 
+// timeout in 20 ms steps
+static bool waitForWifi(unsigned int timeout) {
   wl_status_t status = WL_IDLE_STATUS;
-  unsigned int timeout = 0;
+  unsigned int waited = 0;
 
   do {
     delay(10);
@@ -872,30 +880,28 @@ bool connectToWifi(std::string ssid, std::string password) {
       default:
         Serial.println(F("Connection failed."));
         Serial.println(status);
-        WiFi.disconnect();
-        WiFi.setAutoConnect(false);
         return false;
     }
 
-    if(timeout++ > 1000) {
+    if(waited++ > timeout) {
       Serial.println(F("Connection timeout."));
-      WiFi.disconnect();
-      WiFi.setAutoConnect(false);
       return false;
     }
     delay(10);
     esp_task_wdt_reset();
   } while(status != WL_CONNECTED);
 
-  Serial.println(F("Connection successful."));
-  Serial.println("IP address: ");
-  Serial.print(WiFi.localIP());
-  Serial.print(" / ");
-  Serial.println(WiFi.macAddress());
-  WiFi.setAutoConnect(true);
   return true;
 }
 
+bool wifiPortalActive() {
+  return portal_server.active();
+}
+
+const fg::WifiLink::Stats& wifiLinkStats() {
+  return wifi_link.stats();
+}
+
 bool wifiIsConnected() {
   auto wifi_status = WiFi.status();
   switch(wifi_status) {
@@ -948,92 +954,6 @@ void resetCredentials() {
   fg::settings().commit();
 }
 
-#define CHUNK_LEN 2048
-
-void handleRoot() {
-  using base64 = cppcodec::base64_rfc4648;
-
-  auto len = strlen(INDEX_HTML_COMPRESSED);
-  auto pos = 0;
-  char chunk[CHUNK_LEN + 1];
-
-  // HTML Header
-  server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-  server.sendHeader("Pragma", "no-cache");
-  server.sendHeader("Expires", "-1");
-  server.setContentLength(INDEX_HTML_SIZE);
-  server.send ( 200, "text/html", "" );
-
-  try {
-    // HTML Content
-    while(pos < len) {
-      strncpy_P(chunk, INDEX_HTML_COMPRESSED + pos, CHUNK_LEN);
-      chunk[CHUNK_LEN] = '\0';
-      std::vector<uint8_t> decoded = base64::decode(chunk);
-      decoded.push_back('\0');
-      Serial.println((int)decoded.size());
-      const char* html = reinterpret_cast<const char*>(decoded.data());
-      server.sendContent(html);
-      pos += CHUNK_LEN;
-    }
-
-    server.client().stop();
-  }
-  catch(...) {
-    Serial.println("exceptioN!!!");
-  }
-
-}
-
-/** Wifi config page handler */
-void handleConfig() {
-  String body = server.arg("plain");
-  Serial.println(body);
-
-  StaticJsonDocument<200> config_data;
-  if(auto error = deserializeJson(config_data, body)) {
-    Serial.print(F("deserializeJson() failed: "));
-    Serial.println(error.f_str());
-    return;
-  }
-
-  primary_ssid = config_data["primary"]["ssid"].as<std::string>();
-  primary_password = config_data["primary"]["password"].as<std::string>();
-
-  bool connected = connectToWifi(primary_ssid, primary_password);
-
-  if(connected) {
-    saveWifiCredentials();
-    server.send ( 200, "text/html", "ok" );
-    server.client().stop();
-    delay(10000);
-    ESP.restart();
-  }
-  else {
-    server.send ( 200, "text/html", "error" );
-    server.client().stop();
-  }
-}
-
-void handleGetScan() {
-  auto ssids = scanWifiNetworks();
-  StaticJsonDocument<1024> response;
-
-  server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-  server.sendHeader("Pragma", "no-cache");
-  server.sendHeader("Expires", "-1");
-
-  for(auto ssid : ssids) {
-    response.add(ssid);
-  }
-
-  std::stringstream stream;
-  serializeJson(response, stream);
-
-  server.send (200, "application/json", stream.str().c_str());
-}
-
-
 /** Is this an IP? */
 boolean isIp(String str) {
   for (int i = 0; i < str.length(); i++) {
@@ -1172,7 +1092,8 @@ void delayWithWatchdog(uint32_t delay_ms) {
 
 bool isSocketRoleConnected(const std::string& role) {
   std::string socket_key = socketRoleKey(role);
-  return fg::settings().has(socket_key.c_str()) && !fg::settings().getStr(socket_key.c_str()).empty();
+  char socket_ip[fg::SettingsManager::CACHE_VALUE_SIZE];
+  return fg::settings().getStr(socket_key.c_str(), socket_ip, sizeof(socket_ip)) && socket_ip[0];
 }
 
 std::string socketRoleKey(const std::string& role) {
@@ -1255,13 +1176,8 @@ bool provisionSmartSocket(const std::string& socket_role, const std::string& hom
     return false;
   };
 
-  std::string mqtt_password = sanitizeSettingString(fg::settings().getStr("mqtt_pass"));
-  if(mqtt_password.empty()) {
-    fg::SettingsManager provisioning(NVS_PART, "fg_provisioning");
-    mqtt_password = sanitizeSettingString(provisioning.getStr("mqtt_password"));
-  }
-
-  if(mqtt_password.empty()) {
+  char mqtt_password[SMART_SOCKET_PASSWORD_SIZE];
+  if(!smartSocketPassword(mqtt_password, sizeof(mqtt_password))) {
     return fail_with_reconnect("mqtt pass miss");
   }
 
@@ -1271,7 +1187,7 @@ bool provisionSmartSocket(const std::string& socket_role, const std::string& hom
                          + urlEncode("DeviceName " + socket_name + "; ")
                          + urlEncode("Hostname " + socket_name + "; ")
                          + urlEncode("WiFiTest2 " + home_ssid_clean + "+" + home_password_clean + "; ")
-                         + urlEncode("WebPassword " + mqtt_password);
+                         + urlEncode(std::string("WebPassword ") + mqtt_password);
 
   if(!httpGet(config_url)) {
     return fail_with_reconnect("config fail");
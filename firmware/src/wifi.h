@@ -2,6 +2,7 @@
 
 #include "fghmi.h"
 #include "fridgecloud.h"
+#include "wifilink.h"
 
 namespace fg {
   class WifiApDash: public MenuItem {
@@ -48,10 +49,14 @@ struct SmartSocketOutputStates {
   bool co2_on = false;
 };
 
-bool initializeWifi();
+// reconnects are logged to the cloud if one is given
+bool initializeWifi(fg::Fridgecloud* cloud = nullptr);
 void resetCredentials();
 void wifiTick();
 bool wifiIsConnected();
+// the captive portal holds port 80 until the restart after its connect
+bool wifiPortalActive();
+const fg::WifiLink::Stats& wifiLinkStats();
 void showWifiUi(fg::UserInterface* ui, fg::Fridgecloud* cloud);
 void showSmartSocketsUi(fg::UserInterface* ui, fg::Fridgecloud* cloud);
 bool sendSmartSocketPower(const std::string& role, bool turn_on);
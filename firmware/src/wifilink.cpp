@@ -0,0 +1,208 @@
+#include "wifilink.h"
+
+#include <string.h>
+#include <stddef.h>
+#include <vector>
+#include <algorithm>
+#include <esp_attr.h>
+
+#include "settings.h"
+
+namespace fg {
+
+  namespace {
+    constexpr uint32_t CACHE_MAGIC = 0x574c4e4b;
+    constexpr const char* CACHE_KEY = "wifi_link";
+
+    // survives restarts and watchdog resets, not a power cycle
+    RTC_NOINIT_ATTR WifiLink::Cache rtc_cache;
+
+    uint32_t checksum(const WifiLink::Cache& cache) {
+      // FNV-1a over everything but the checksum itself
+      auto bytes = reinterpret_cast<const uint8_t*>(&cache);
+      uint32_t hash = 2166136261u;
+      for(size_t i = 0; i < offsetof(WifiLink::Cache, checksum); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+      }
+      return hash;
+    }
+
+    bool valid(const WifiLink::Cache& cache) {
+      return cache.magic == CACHE_MAGIC && cache.checksum == checksum(cache);
+    }
+
+    const char* passphrase(const std::string& password) {
+      return password.empty() ? NULL : password.c_str();
+    }
+  }
+
+  void WifiLink::begin(ReconnectHandler handler) {
+    on_reconnect = handler;
+    static_ip = settings().getU8("wifi_static");
+
+    if(valid(rtc_cache)) {
+      cache = rtc_cache;
+      cache_valid = true;
+    }
+    else {
+      std::vector<uint8_t> stored;
+      if(settings().getBlob(CACHE_KEY, stored) && stored.size() == sizeof(Cache)) {
+        memcpy(&cache, stored.data(), sizeof(Cache));
+        cache_valid = valid(cache);
+        if(cache_valid) {
+          rtc_cache = cache;
+        }
+      }
+    }
+
+    // reconnects are done by loop(), not by the driver
+    WiFi.setAutoReconnect(false);
+
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info) {
+      connected = true;
+    }, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+
+    WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info) {
+      reason = info.wifi_sta_disconnected.reason;
+      if(connected.exchange(false)) {
+        lost_at = xTaskGetTickCount();
+      }
+    }, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  }
+
+  bool WifiLink::cached(const std::string& ssid) const {
+    return cache_valid && ssid == cache.ssid;
+  }
+
+  void WifiLink::setStaticIp(bool enabled) {
+    static_ip = enabled;
+    settings().setU8("wifi_static", enabled);
+    settings().commit();
+  }
+
+  bool WifiLink::beginFast(const std::string& ssid, const std::string& password) {
+    if(!cached(ssid)) {
+      return false;
+    }
+    if(static_ip && cache.ip) {
+      WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway), IPAddress(cache.netmask), IPAddress(cache.dns));
+    }
+    WiFi.begin(ssid.c_str(), passphrase(password), cache.channel, cache.bssid);
+    return true;
+  }
+
+  void WifiLink::beginFull(const std::string& ssid, const std::string& password) {
+    if(static_ip) {
+      // the cached lease may be the reason the fast connect failed
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+    WiFi.begin(ssid.c_str(), passphrase(password));
+  }
+
+  void WifiLink::remember(const std::string& ssid) {
+    auto bssid = WiFi.BSSID();
+    if(!bssid || ssid.size() >= sizeof(cache.ssid)) {
+      return;
+    }
+
+    Cache current;
+    memset(&current, 0, sizeof(current));
+    current.magic = CACHE_MAGIC;
+    current.ip = WiFi.localIP();
+    current.gateway = WiFi.gatewayIP();
+    current.netmask = WiFi.subnetMask();
+    current.dns = WiFi.dnsIP();
+    memcpy(current.bssid, bssid, sizeof(current.bssid));
+    current.channel = WiFi.channel();
+    strcpy(current.ssid, ssid.c_str());
+    current.checksum = checksum(current);
+
+    rtc_cache = current;
+    if(cache_valid && !memcmp(&current, &cache, sizeof(Cache))) {
+      return;
+    }
+    cache = current;
+    cache_valid = true;
+    settings().setBlob(CACHE_KEY, &cache, sizeof(Cache));
+    settings().commit();
+  }
+
+  void WifiLink::settle() {
+    reconnecting = false;
+    connected = WiFi.status() == WL_CONNECTED;
+    lost_at = 0;
+  }
+
+  void WifiLink::startStep(Step next, const std::string& ssid, const std::string& password) {
+    step = next;
+    step_started = xTaskGetTickCount();
+    fast_attempt = false;
+
+    // drop whatever the previous attempt left behind
+    WiFi.disconnect();
+
+    if(step == Step::FAST) {
+      if(beginFast(ssid, password)) {
+        fast_attempt = true;
+        return;
+      }
+      // nothing cached for this network, scan right away
+      step = Step::FULL;
+    }
+    if(step == Step::FULL) {
+      beginFull(ssid, password);
+    }
+  }
+
+  void WifiLink::loop(const std::string& ssid, const std::string& password) {
+    auto now = xTaskGetTickCount();
+
+    if(connected) {
+      if(reconnecting) {
+        reconnecting = false;
+        uint32_t down_ms = (now - outage_start) * portTICK_PERIOD_MS;
+        link_stats.reconnects++;
+        link_stats.fast_reconnects += fast_attempt;
+        link_stats.last_ms = down_ms;
+        link_stats.longest_ms = std::max(link_stats.longest_ms, down_ms);
+        Serial.printf("wifi reconnected after %u ms (%s)\n\r", down_ms, fast_attempt ? "fast" : "scan");
+
+        remember(ssid);
+        if(on_reconnect) {
+          on_reconnect(down_ms, fast_attempt, link_stats.last_reason);
+        }
+      }
+      return;
+    }
+
+    if(!reconnecting) {
+      reconnecting = true;
+      auto lost = lost_at.exchange(0);
+      outage_start = lost ? lost : now;
+      link_stats.last_reason = reason;
+      Serial.printf("wifi link lost, reason %u\n\r", link_stats.last_reason);
+      startStep(Step::FAST, ssid, password);
+      return;
+    }
+
+    // fast connect, then a scan, then a pause before the next round
+    switch(step) {
+      case Step::FAST:
+        if(now - step_started > FAST_TIMEOUT) {
+          startStep(Step::FULL, ssid, password);
+        }
+        break;
+      case Step::FULL:
+        if(now - step_started > FULL_TIMEOUT) {
+          startStep(Step::PAUSE, ssid, password);
+        }
+        break;
+      case Step::PAUSE:
+        if(now - step_started > RETRY_PAUSE) {
+          startStep(Step::FAST, ssid, password);
+        }
+        break;
+    }
+  }
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <functional>
+#include "Arduino.h"
+#include <WiFi.h>
+
+namespace fg {
+
+  // Keeps the station connected to the configured network. The access
+  // point (bssid and channel) and the DHCP lease of the last connection
+  // are cached in RTC memory and NVS, so a reconnect can skip the scan and
+  // go straight to the known access point. Link loss is taken from the
+  // Wi-Fi events, the reconnect starts right away instead of on the next
+  // poll.
+  //
+  // With the "wifi_static" setting (Wi-Fi menu, "static ip") the cached
+  // lease is also configured as static address on fast connects, which
+  // saves the DHCP round trip. Only safe if the router keeps the address
+  // reserved for the device.
+  class WifiLink {
+  public:
+    struct Stats {
+      uint32_t reconnects = 0;
+      uint32_t fast_reconnects = 0;
+      uint32_t last_ms = 0;
+      uint32_t longest_ms = 0;
+      uint8_t last_reason = 0;
+    };
+
+    // called from loop() once the link is back, with the time it was down
+    using ReconnectHandler = std::function<void(uint32_t down_ms, bool fast, uint8_t reason)>;
+
+    // stored as is in RTC memory and NVS, has no padding
+    struct Cache {
+      uint32_t magic;
+      uint32_t ip;
+      uint32_t gateway;
+      uint32_t netmask;
+      uint32_t dns;
+      uint8_t bssid[6];
+      uint8_t channel;
+      char ssid[33];
+      uint32_t checksum;
+    };
+
+  private:
+    enum class Step : uint8_t {
+      FAST, FULL, PAUSE
+    };
+
+    static constexpr TickType_t FAST_TIMEOUT = configTICK_RATE_HZ * 3;
+    static constexpr TickType_t FULL_TIMEOUT = configTICK_RATE_HZ * 15;
+    static constexpr TickType_t RETRY_PAUSE = configTICK_RATE_HZ * 10;
+
+    Cache cache;
+    bool cache_valid = false;
+    bool static_ip = false;
+    ReconnectHandler on_reconnect;
+
+    // written by the Wi-Fi event task
+    std::atomic<bool> connected{false};
+    std::atomic<TickType_t> lost_at{0};
+    std::atomic<uint8_t> reason{0};
+
+    // only touched by loop()
+    bool reconnecting = false;
+    bool fast_attempt = false;
+    Step step = Step::FAST;
+    TickType_t outage_start = 0;
+    TickType_t step_started = 0;
+    Stats link_stats;
+
+    bool cached(const std::string& ssid) const;
+    void startStep(Step next, const std::string& ssid, const std::string& password);
+
+  public:
+    void begin(ReconnectHandler handler);
+
+    // Starts a connection to the cached access point without scanning.
+    // Returns false if there is no cache entry for this network.
+    bool beginFast(const std::string& ssid, const std::string& password);
+
+    // Starts a connection that scans for the network, clears a static
+    // address a fast connect may have configured.
+    void beginFull(const std::string& ssid, const std::string& password);
+
+    // Stores access point and lease of the current connection, flash is
+    // only written if they changed.
+    void remember(const std::string& ssid);
+
+    // a blocking connect finished, its own disconnects are not a link loss
+    void settle();
+
+    // persists the "wifi_static" setting, used from the next fast connect
+    void setStaticIp(bool enabled);
+    inline bool staticIp() const { return static_ip; }
+
+    // called from the loop while a network is configured
+    void loop(const std::string& ssid, const std::string& password);
+
+    inline const Stats& stats() const { return link_stats; }
+  };
+
+}
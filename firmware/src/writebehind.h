@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include "Arduino.h"
+
+namespace fg {
+
+  // Defers an expensive flush (NVS commit, cloud upload) until changes have
+  // stopped for the quiet period, so a burst of edits from the encoder ends
+  // up as a single flush. markDirty() may be called from the UI task,
+  // poll() is called periodically from the control loop.
+  class WriteBehind {
+    const TickType_t quiet_period;
+    std::function<void()> handler;
+
+    std::atomic<bool> dirty{false};
+    std::atomic<TickType_t> last_change{0};
+    std::atomic<uint32_t> changes{0};
+    uint32_t flushes = 0;
+
+  public:
+    WriteBehind(TickType_t quiet_period, std::function<void()> handler) :
+      quiet_period(quiet_period),
+      handler(handler) {}
+
+    void markDirty() {
+      last_change = xTaskGetTickCount();
+      changes++;
+      dirty = true;
+    }
+
+    // returns true if a flush was performed
+    bool poll() {
+      if(!dirty || xTaskGetTickCount() - last_change < quiet_period) {
+        return false;
+      }
+      return flush();
+    }
+
+    bool flush() {
+      if(!dirty.exchange(false)) {
+        return false;
+      }
+      flushes++;
+      handler();
+      return true;
+    }
+
+    // drops pending changes, e.g. when they were superseded by the cloud
+    void discard() { dirty = false; }
+
+    inline bool isDirty() const { return dirty; }
+    inline uint32_t changeCount() const { return changes; }
+    inline uint32_t flushCount() const { return flushes; }
+  };
+
+}
@@ -17,24 +17,6 @@ namespace fg {
 
   }
 
-  template<class T> inline void loadIfAvaliable(T& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<T>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
-  template<> inline void loadIfAvaliable(String& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<const char*>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
   void CameraController::loadSettings(const String& settings_json) {
   }
 
@@ -1,6 +1,7 @@
 #include "controller.h"
 #include "dashboard.h"
 #include "wifi.h"
+#include "i2cbus.h"
 #include <MCP7940.h>
 #include <sstream>
 
@@ -13,21 +14,6 @@ const uint8_t  SPRINTF_BUFFER_SIZE{32};
 MCP7940_Class MCP7940;
 char          inputBuffer[32];
 
-static double ntcToTemp(uint16_t adc_val) {
-  double R1 = 100000.0;   // voltage divider resistor value
-  double Beta = 4250.0;  // Beta value
-  double To = 298.15;    // Temperature in Kelvin for 25 degree Celsius
-  double Ro = 100000.0;   // Resistance of Thermistor at 25 degree Celsius
-
-  double adc_max = 4095.0;
-
-  auto Rt = R1 * (double)adc_val / (adc_max - (double)adc_val);
-
-  auto T = 1/(1/To + log(Rt/Ro)/Beta);    // Temperature in Kelvin
-  auto Tc = T - 273.15;                   // Celsius
-  return Tc;
-}
-
 namespace fg {
 
   std::unique_ptr<AutomationController> createController(Fridgecloud& cloud) {
@@ -43,10 +29,12 @@ namespace fg {
     static unsigned sensor_fails = 0;
     static TickType_t last_co2_sample;
 
-    Wire.end();
-    Wire.begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
-
-    if(state.sensor_type == SENSOR_TYPE_SHT) {
+    I2cTransaction transaction(i2cBus(1), I2cPriority::SENSOR);
+    if(!transaction) {
+      Serial.println("sensor bus busy!");
+      sensor_fails++;
+    }
+    else if(state.sensor_type == SENSOR_TYPE_SHT) {
       Serial.println("SENSOR IS SHT");
       uint8_t tries = 0;
       for(; tries < 2; tries++) {
@@ -105,15 +93,11 @@ namespace fg {
     }
     else {
       Serial.println("NO SENSOR!");
-      Wire.end();
       if(initSensor()) {
         sensor_fails = 0;
       }
     }
 
-    Wire.end();
-    Wire.begin(PIN_SDA, PIN_SCL);
-
     if(sensor_fails < 10) {
       sensors_valid = true;
     }
@@ -392,24 +376,6 @@ namespace fg {
 
   }
 
-  template<class T> inline void loadIfAvaliable(T& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<T>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
-  template<> inline void loadIfAvaliable(String& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<const char*>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
   void ControllerController::loadSettings(const String& settings_json) {
     ControllerControllerSettings new_settings;
     DynamicJsonDocument doc(2048);
@@ -422,44 +388,10 @@ namespace fg {
     }
     else {
       Serial.println(settings_json);
-
-      loadIfAvaliable(new_settings.mqttcontrol, doc["mqttcontrol"]);
-      loadIfAvaliable(new_settings.workmode, doc["workmode"]);
-      loadIfAvaliable(new_settings.daynight.day, doc["daynight"]["day"]);
-      loadIfAvaliable(new_settings.daynight.night, doc["daynight"]["night"]);
-	  loadIfAvaliable(new_settings.daynight.maxDehumidifySeconds, doc["daynight"]["maxDehumidifySeconds"]);
-      loadIfAvaliable(new_settings.daynight.targetHumidityDiff, doc["daynight"]["targetHumidityDiff"]);
-      loadIfAvaliable(new_settings.daynight.useLongHumidityAvg, doc["daynight"]["useLongHumidityAvg"]);
-      loadIfAvaliable(new_settings.co2.target, doc["co2"]["target"]);
-      loadIfAvaliable(new_settings.day.temperature, doc["day"]["temperature"]);
-      loadIfAvaliable(new_settings.day.humidity, doc["day"]["humidity"]);
-      loadIfAvaliable(new_settings.night.temperature, doc["night"]["temperature"]);
-      loadIfAvaliable(new_settings.night.humidity, doc["night"]["humidity"]);
-      loadIfAvaliable(new_settings.lights.sunrise, doc["lights"]["sunrise"]);
-      loadIfAvaliable(new_settings.lights.sunset, doc["lights"]["sunset"]);
-      loadIfAvaliable(new_settings.lights.limit, doc["lights"]["limit"]);
-      loadIfAvaliable(new_settings.fans.external, doc["fans"]["external"]);
-      loadIfAvaliable(new_settings.fans.internal, doc["fans"]["internal"]);
+      readSettings(doc.as<JsonVariantConst>(), new_settings);
     }
 
-    Serial.printf("#################################################\n\r");
-    Serial.printf("new_settings.workmode: %s\n\r", new_settings.workmode);
-    Serial.printf("new_settings.daynight.day: %lu\n\r", new_settings.daynight.day);
-    Serial.printf("new_settings.daynight.night: %lu\n\r", new_settings.daynight.night);
-	Serial.printf("new_settings.daynight.maxDehumidifySeconds: %lu\n\r", new_settings.daynight.maxDehumidifySeconds);
-    Serial.printf("new_settings.daynight.targetHumidityDiff: %f\n\r", new_settings.daynight.targetHumidityDiff);
-    Serial.printf("new_settings.daynight.useLongHumidityAvg: %f\n\r", new_settings.daynight.useLongHumidityAvg);
-    Serial.printf("new_settings.co2.target: %.0f\n\r", new_settings.co2.target);
-    Serial.printf("new_settings.day.temperature: %.2f\n\r", new_settings.day.temperature);
-    Serial.printf("new_settings.day.humidity: %.0f\n\r", new_settings.day.humidity);
-    Serial.printf("new_settings.night.temperature: %.2f\n\r", new_settings.night.temperature);
-    Serial.printf("new_settings.night.humidity: %.0f\n\r", new_settings.night.humidity);
-    Serial.printf("new_settings.lights.sunrise: %f\n\r", new_settings.lights.sunrise);
-    Serial.printf("new_settings.lights.sunset: %f\n\r", new_settings.lights.sunset);
-    Serial.printf("new_settings.lights.limit: %f\n\r", new_settings.lights.limit);
-    Serial.printf("new_settings.fans.external: %f\n\r", new_settings.fans.external);
-    Serial.printf("new_settings.fans.internal: %f\n\r", new_settings.fans.internal);
-    Serial.printf("#################################################\n\r");
+    printSettings(new_settings);
 
     settings = new_settings;
 	if(!hasCo2Sensor())
@@ -469,33 +401,24 @@ namespace fg {
   }
 
   void ControllerController::saveAndUploadSettings() {
-    DynamicJsonDocument doc(2048);
-
-    doc["workmode"] = settings.workmode;
-    doc["daynight"]["day"] = settings.daynight.day;
-    doc["daynight"]["night"] = settings.daynight.night;
-	doc["daynight"]["maxDehumidifySeconds"] = settings.daynight.maxDehumidifySeconds;
-    doc["daynight"]["targetHumidityDiff"] = settings.daynight.targetHumidityDiff;
-    doc["daynight"]["useLongHumidityAvg"] = settings.daynight.useLongHumidityAvg;
-    doc["co2"]["target"] = settings.co2.target;
-    doc["day"]["temperature"] = settings.day.temperature;
-    doc["day"]["humidity"] = settings.day.humidity;
-    doc["night"]["temperature"] = settings.night.temperature;
-    doc["night"]["humidity"] = settings.night.humidity;
-    doc["lights"]["sunrise"] = settings.lights.sunrise;
-    doc["lights"]["sunset"] = settings.lights.sunset;
-    doc["lights"]["limit"] = settings.lights.limit;
-    doc["fans"]["external"] = settings.fans.external;
-    doc["fans"]["internal"] = settings.fans.internal;
+    saved_settings = settings;
+    resetTransientSettings(saved_settings);
+    settings_writer.markDirty();
+  }
 
+  void ControllerController::persistSettings() {
+    DynamicJsonDocument doc(2048);
+    writeSettings(saved_settings, doc.to<JsonObject>());
 
     std::stringstream stream;
     serializeJson(doc, stream);
 
     Serial.println(stream.str().c_str());
-    fg::settings().setStr("config", stream.str().c_str());
-    fg::settings().commit();
+    storeSettings(saved_settings);
     cloud.updateConfig(stream.str().c_str());
+
+    Serial.printf("settings flushed, %u changes in %u flushes, %u nvs commits\n\r",
+      settings_writer.changeCount(), settings_writer.flushCount(), fg::settings().commitCount());
   }
 
   void ControllerController::init() {
@@ -507,8 +430,16 @@ namespace fg {
     pinMode(15, INPUT);
     pinMode(4, INPUT);
 
-    auto saved_settings = fg::settings().getStr("config");
-    loadSettings(saved_settings.c_str());
+    if(!loadStoredSettings(saved_settings)) {
+      // settings of older firmware were stored as JSON, migrate them once
+      loadSettings(fg::settings().getStr("config").c_str());
+      saved_settings = settings;
+      storeSettings(saved_settings);
+    }
+    settings = saved_settings;
+    if(!hasCo2Sensor()) {
+      settings.co2.target = 0;
+    }
 
     cloud.onConfig([&](const String & payload) {
       Serial.println("received new configuration");
@@ -518,8 +449,9 @@ namespace fg {
         directmode_timer = xTaskGetTickCount() + DIRECTMODE_TIMEOUT;
       }
       else {
-        fg::settings().setStr("config", payload.c_str());
-        fg::settings().commit();
+        saved_settings = settings;
+        settings_writer.discard();
+        storeSettings(saved_settings);
       }
 
       loop();
@@ -612,7 +544,8 @@ namespace fg {
       }
     });
 
-    Wire.begin(PIN_SDA, PIN_SCL);
+    i2cBus(0).begin(PIN_SDA, PIN_SCL);
+    i2cBus(1).begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
 
     sntp_setoperatingmode(SNTP_OPMODE_POLL);
     sntp_setservername(0, "pool.ntp.org");
@@ -658,9 +591,7 @@ namespace fg {
     timeval epoch = {(time_t)now.unixtime(), 0};
     settimeofday((const timeval*)&epoch, 0);
 
-     Wire.end();
     initSensor();
-    Wire.begin(PIN_SDA, PIN_SCL);
 
     Serial.println("Waiting for first measurement... (5 sec)");
 
@@ -669,12 +600,12 @@ namespace fg {
   }
 
   bool ControllerController::initSensor() {
-    Wire.begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
+    I2cTransaction transaction(i2cBus(1), I2cPriority::SENSOR);
     bool found_sensor = false;
 
     auto time = xTaskGetTickCount();
 
-    if (sht21.init(Wire)) {
+    if (sht21.init(Wire1)) {
       Serial.print("init(): success\n");
       state.sensor_type = SENSOR_TYPE_SHT;
       sht21.setAccuracy(SHTSensor::SHT_ACCURACY_MEDIUM); // only supported by SHT3x
@@ -687,10 +618,9 @@ namespace fg {
     time = xTaskGetTickCount();
 
     if(!found_sensor) {
-      //Wire.flush();
-      scd4x.begin(Wire);
-      Wire.beginTransmission(SCD4X_I2C_ADDRESS);
-      if (Wire.endTransmission() == 0) {
+      scd4x.begin(Wire1);
+      Wire1.beginTransmission(SCD4X_I2C_ADDRESS);
+      if (Wire1.endTransmission() == 0) {
         unsigned  error = scd4x.stopPeriodicMeasurement();
         found_sensor = true;
 
@@ -723,7 +653,6 @@ namespace fg {
     Serial.println(xTaskGetTickCount() - time);
     time = xTaskGetTickCount();
 
-    Wire.end();
     return found_sensor;
   }
 
@@ -747,6 +676,7 @@ namespace fg {
   }
 
   void ControllerController::loop() {
+    settings_writer.poll();
     updateSensors();
     checkDayCycle();
 
@@ -768,8 +698,10 @@ namespace fg {
 
       if(directmode_timer < xTaskGetTickCount()) {
         Serial.println("DIRECTMODE TIMEOUT! REVERTING!");
-        auto saved_settings = fg::settings().getStr("config");
-        loadSettings(saved_settings.c_str());
+        settings = saved_settings;
+        if(!hasCo2Sensor()) {
+          settings.co2.target = 0;
+        }
       }
     }
     else if(sensors_valid == false) {
@@ -5,6 +5,8 @@
 #include "SHTSensor.h"
 #include "output.h"
 #include "automation.h"
+#include "settingsblob.h"
+#include "writebehind.h"
 
 #include "fghmi.h"
 #include "pid.h"
@@ -60,6 +62,26 @@ namespace fg {
       float internal = 100.0;
     } fans;
 
+    template<class Binder> void bind(Binder& b) {
+      b.transient({"mqttcontrol"}, mqttcontrol);
+      b.field({"workmode"}, workmode);
+      b.field({"daynight", "day"}, daynight.day, 0, 86400);
+      b.field({"daynight", "night"}, daynight.night, 0, 86400);
+      b.field({"daynight", "maxDehumidifySeconds"}, daynight.maxDehumidifySeconds, 0, 86400);
+      b.field({"daynight", "targetHumidityDiff"}, daynight.targetHumidityDiff, 0, 100);
+      b.field({"daynight", "useLongHumidityAvg"}, daynight.useLongHumidityAvg);
+      b.field({"co2", "target"}, co2.target, 0, 10000);
+      b.field({"day", "temperature"}, day.temperature, -40, 100);
+      b.field({"day", "humidity"}, day.humidity, 0, 100);
+      b.field({"night", "temperature"}, night.temperature, -40, 100);
+      b.field({"night", "humidity"}, night.humidity, 0, 100);
+      b.field({"lights", "sunrise"}, lights.sunrise, 0, 1440);
+      b.field({"lights", "sunset"}, lights.sunset, 0, 1440);
+      b.field({"lights", "limit"}, lights.limit, 0, 100);
+      b.field({"fans", "external"}, fans.external, 0, 100);
+      b.field({"fans", "internal"}, fans.internal, 0, 100);
+    }
+
     void print() const;
 
   };
@@ -113,6 +135,7 @@ namespace fg {
     static constexpr float MAX_SENSOR_DEVIATION = 15.0;
 
     static constexpr TickType_t DIRECTMODE_TIMEOUT = configTICK_RATE_HZ * 60;
+    static constexpr TickType_t SETTINGS_QUIET_PERIOD = configTICK_RATE_HZ * 5;
 
     static constexpr unsigned int TESTMODE_MAX_DURATION = 10; // times 10sec
     unsigned int testmode_duration = 0;
@@ -144,12 +167,14 @@ namespace fg {
 
     TickType_t directmode_timer = 0;
 
-    Avg<100> humidity_avg_short;
-    Avg<240> humidity_avg_long;
+    Avg<100, Fixed16<100>> humidity_avg_short;
+    Avg<240, Fixed16<100>> humidity_avg_long;
     Avg<20> co2_avg;
     Avg<10> heater_avg;
 
     ControllerControllerSettings settings;
+    ControllerControllerSettings saved_settings; // persisted copy, restored when direct mode times out
+    WriteBehind settings_writer{SETTINGS_QUIET_PERIOD, [this]() { persistSettings(); }};
 
     bool is_legacy_board = false;
     bool sensors_valid = false;
@@ -193,6 +218,7 @@ namespace fg {
 	bool initSensor();
 	bool hasCo2Sensor();
 	void checkLimits(uint8_t output);
+    void persistSettings();
 
   public:
     ControllerController(Fridgecloud& cloud);
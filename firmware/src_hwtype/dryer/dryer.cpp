@@ -1,6 +1,7 @@
 #include "dryer.h"
 #include "dashboard.h"
 #include "wifi.h"
+#include "i2cbus.h"
 #include <MCP7940.h>
 #include <sstream>
 
@@ -11,21 +12,6 @@ const uint8_t  SPRINTF_BUFFER_SIZE{32};
 MCP7940_Class MCP7940;
 char          inputBuffer[32];
 
-static double ntcToTemp(uint16_t adc_val) {
-  double R1 = 100000.0;   // voltage divider resistor value
-  double Beta = 4250.0;  // Beta value
-  double To = 298.15;    // Temperature in Kelvin for 25 degree Celsius
-  double Ro = 100000.0;   // Resistance of Thermistor at 25 degree Celsius
-
-  double adc_max = 4095.0;
-
-  auto Rt = R1 * (double)adc_val / (adc_max - (double)adc_val);
-
-  auto T = 1/(1/To + log(Rt/Ro)/Beta);    // Temperature in Kelvin
-  auto Tc = T - 273.15;                   // Celsius
-  return Tc;
-}
-
 namespace fg {
 
   std::unique_ptr<AutomationController> createController(Fridgecloud& cloud) {
@@ -54,7 +40,8 @@ namespace fg {
     bool sht_valid = false;
     static unsigned sht_fails = 0;
 
-    Wire.flush();
+    I2cTransaction sensor_bus(i2cBus(1), I2cPriority::SENSOR);
+    I2cTransaction main_bus(i2cBus(0), I2cPriority::SENSOR);
 
     uint8_t tries = 0;
     for(; tries < 2; tries++) {
@@ -76,21 +63,13 @@ namespace fg {
     }
 
 
-    Wire.flush();
-
-
-    auto ntc1 = analogRead(PIN_NTC1);
-    auto ntc2 = analogRead(PIN_NTC2);
-    auto ntc3 = analogRead(PIN_NTC3);
-    auto ntc4 = analogRead(PIN_NTC4);
 
-    Serial.printf("NTCS: %2f %2f %2f %2f\n\r", ntcToTemp(ntc1), ntcToTemp(ntc2), ntcToTemp(ntc3), ntcToTemp(ntc4));
-    Serial.printf("RAW: %u %u %u %u\n\r", ntc1, ntc2, ntc3, ntc4);
+    Serial.printf("NTCS: %2f %2f %2f %2f\n\r", ntc_monitor.temperature(0), ntc_monitor.temperature(1), ntc_monitor.temperature(2), ntc_monitor.temperature(3));
+    if(ntc_monitor.isTripped()) {
+      Serial.printf("HEATER OVERTEMPERATURE TRIP! (%u trips)\n\r", ntc_monitor.tripCount());
+    }
 
-    heater_temp = ntcToTemp(ntc1);
-    heater_temp = ntcToTemp(ntc2) > heater_temp ? ntcToTemp(ntc2) : heater_temp;
-    heater_temp = ntcToTemp(ntc3) > heater_temp ? ntcToTemp(ntc3) : heater_temp;
-    heater_temp = ntcToTemp(ntc4) > heater_temp ? ntcToTemp(ntc4) : heater_temp;
+    heater_temp = ntc_monitor.maxTemperature();
 
     if(sht_valid) {
       state.humidity = humidity_sht;
@@ -164,7 +143,7 @@ namespace fg {
     state.out_heater = heater_night_pid.tick(state.temperature, settings.temperature);
     heater_turn_off = (float)xTaskGetTickCount() + (float)configTICK_RATE_HZ * state.out_heater;
 
-    if(heater_temp < HEATER_MAX_TEMPERATURE) {
+    if(heater_temp < HEATER_MAX_TEMPERATURE && !ntc_monitor.isTripped()) {
       out_heater.set(1);
     }
     else {
@@ -188,6 +167,7 @@ namespace fg {
     out_fan_internal(PIN_FAN_INTERNAL, 1, 0, 30000),
     out_fan_external(PIN_FAN_EXTERNAL, 2, 0, 30000),
     out_fan_backwall(PIN_FAN_BACKWALL, 3, 0, 30000),
+    ntc_monitor(out_heater, PIN_NTC1, PIN_NTC2, PIN_NTC3, PIN_NTC4, HEATER_MAX_TEMPERATURE),
     heater_day_pid(HEATER_PID_P, HEATER_PID_I, HEATER_PID_D),
     heater_night_pid(HEATER_PID_P, HEATER_PID_I, HEATER_PID_D),
     sht21(SHTSensor::SHTSensorType::SHT4X)
@@ -195,24 +175,6 @@ namespace fg {
 
   }
 
-  template<class T> inline void loadIfAvaliable(T& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<T>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
-  template<> inline void loadIfAvaliable(String& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<const char*>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
   void DryerController::loadSettings(const String& settings_json) {
     DryerControllerSettings new_settings;
     DynamicJsonDocument doc(2048);
@@ -225,43 +187,33 @@ namespace fg {
     }
     else {
       Serial.println(settings_json);
-
-      loadIfAvaliable(new_settings.mqttcontrol, doc["mqttcontrol"]);
-      loadIfAvaliable(new_settings.workmode, doc["workmode"]);
-      loadIfAvaliable(new_settings.temperature, doc["temperature"]);
-      loadIfAvaliable(new_settings.humidity, doc["humidity"]);
-      loadIfAvaliable(new_settings.fans.external, doc["fans"]["external"]);
-      loadIfAvaliable(new_settings.fans.internal, doc["fans"]["internal"]);
+      readSettings(doc.as<JsonVariantConst>(), new_settings);
     }
 
-    Serial.printf("#################################################\n\r");
-    Serial.printf("new_settings.workmode: %s\n\r", new_settings.workmode);
-    Serial.printf("new_settings.temperature: %.2f\n\r", new_settings.temperature);
-    Serial.printf("new_settings.humidity: %.0f\n\r", new_settings.humidity);
-    Serial.printf("new_settings.fans.external: %f\n\r", new_settings.fans.external);
-    Serial.printf("new_settings.fans.internal: %f\n\r", new_settings.fans.internal);
-    Serial.printf("#################################################\n\r");
+    printSettings(new_settings);
 
     settings = new_settings;
   }
 
   void DryerController::saveAndUploadSettings() {
-    DynamicJsonDocument doc(2048);
-
-    doc["workmode"] = settings.workmode;
-    doc["temperature"] = settings.temperature;
-    doc["humidity"] = settings.humidity;
-    doc["fans"]["external"] = settings.fans.external;
-    doc["fans"]["internal"] = settings.fans.internal;
+    saved_settings = settings;
+    resetTransientSettings(saved_settings);
+    settings_writer.markDirty();
+  }
 
+  void DryerController::persistSettings() {
+    DynamicJsonDocument doc(2048);
+    writeSettings(saved_settings, doc.to<JsonObject>());
 
     std::stringstream stream;
     serializeJson(doc, stream);
 
     Serial.println(stream.str().c_str());
-    fg::settings().setStr("config", stream.str().c_str());
-    fg::settings().commit();
+    storeSettings(saved_settings);
     cloud.updateConfig(stream.str().c_str());
+
+    Serial.printf("settings flushed, %u changes in %u flushes, %u nvs commits\n\r",
+      settings_writer.changeCount(), settings_writer.flushCount(), fg::settings().commitCount());
   }
 
   void DryerController::init() {
@@ -273,13 +225,15 @@ namespace fg {
     pinMode(15, INPUT);
     pinMode(26, INPUT);
 
-    pinMode(PIN_NTC1, INPUT);
-    pinMode(PIN_NTC2, INPUT);
-    pinMode(PIN_NTC3, INPUT);
-    pinMode(PIN_NTC4, INPUT);
+    ntc_monitor.begin();
 
-    auto saved_settings = fg::settings().getStr("config");
-    loadSettings(saved_settings.c_str());
+    if(!loadStoredSettings(saved_settings)) {
+      // settings of older firmware were stored as JSON, migrate them once
+      loadSettings(fg::settings().getStr("config").c_str());
+      saved_settings = settings;
+      storeSettings(saved_settings);
+    }
+    settings = saved_settings;
 
     cloud.onConfig([&](const String & payload) {
       Serial.println("received new configuration");
@@ -289,8 +243,9 @@ namespace fg {
         directmode_timer = xTaskGetTickCount() + DIRECTMODE_TIMEOUT;
       }
       else {
-        fg::settings().setStr("config", payload.c_str());
-        fg::settings().commit();
+        saved_settings = settings;
+        settings_writer.discard();
+        storeSettings(saved_settings);
       }
 
       loop();
@@ -335,7 +290,7 @@ namespace fg {
       }
     });
 
-    Wire.begin(PIN_SDA, PIN_SCL);
+    i2cBus(0).begin(PIN_SDA, PIN_SCL);
 
     sntp_setoperatingmode(SNTP_OPMODE_POLL);
     sntp_setservername(0, "pool.ntp.org");
@@ -381,7 +336,7 @@ namespace fg {
     timeval epoch = {(time_t)now.unixtime(), 0};
     settimeofday((const timeval*)&epoch, 0);
 
-    Wire1.begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
+    i2cBus(1).begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
 
     if (sht21.init(Wire1)) {
       Serial.print("init(): success\n");
@@ -403,12 +358,13 @@ namespace fg {
   }
 
   void DryerController::loop() {
+    settings_writer.poll();
     checkDayCycle();
     updateSensors();
 
     if(settings.mqttcontrol) {
       Serial.println("Direct control mode active");;
-      if(heater_temp < HEATER_MAX_TEMPERATURE) {
+      if(heater_temp < HEATER_MAX_TEMPERATURE && !ntc_monitor.isTripped()) {
         heater_turn_off = (float)xTaskGetTickCount() + (float)configTICK_RATE_HZ * testmode_heater_power;
         out_heater.set(1);
       }
@@ -419,8 +375,7 @@ namespace fg {
 
       if(directmode_timer < xTaskGetTickCount()) {
         Serial.println("DIRECTMODE TIMEOUT! REVERTING!");
-        auto saved_settings = fg::settings().getStr("config");
-        loadSettings(saved_settings.c_str());
+        settings = saved_settings;
       }
       heater_avg.push(heater_temp);
       auto fanramp = (heater_avg.avg() - HEATER_FANRAMP_START_TEMP) / (HEATER_FANRAMP_END_TEMP - HEATER_FANRAMP_START_TEMP);
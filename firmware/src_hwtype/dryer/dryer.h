@@ -3,7 +3,10 @@
 #include "fridgecloud.h"
 #include "SHTSensor.h"
 #include "output.h"
+#include "ntcmonitor.h"
 #include "automation.h"
+#include "settingsblob.h"
+#include "writebehind.h"
 
 #include "fghmi.h"
 #include "pid.h"
@@ -27,6 +30,15 @@ namespace fg {
       float internal = 100.0;
     } fans;
 
+    template<class Binder> void bind(Binder& b) {
+      b.transient({"mqttcontrol"}, mqttcontrol);
+      b.field({"workmode"}, workmode);
+      b.field({"temperature"}, temperature, -40, 100);
+      b.field({"humidity"}, humidity, 0, 100);
+      b.field({"fans", "external"}, fans.external, 0, 100);
+      b.field({"fans", "internal"}, fans.internal, 0, 100);
+    }
+
     void print() const;
   };
 
@@ -69,6 +81,7 @@ namespace fg {
     static constexpr float MAX_SENSOR_DEVIATION = 15.0;
 
     static constexpr TickType_t DIRECTMODE_TIMEOUT = configTICK_RATE_HZ * 60;
+    static constexpr TickType_t SETTINGS_QUIET_PERIOD = configTICK_RATE_HZ * 5;
 
     static constexpr unsigned int TESTMODE_MAX_DURATION = 10; // times 10sec
     unsigned int testmode_duration = 0;
@@ -85,13 +98,17 @@ namespace fg {
     PwmOutput out_fan_external;
     PwmOutput out_fan_backwall;
 
+    NtcMonitor ntc_monitor;
+
     TickType_t directmode_timer = 0;
 
-    Avg<100> humidity_avg;
+    Avg<100, Fixed16<100>> humidity_avg;
     Avg<20> co2_avg;
     Avg<10> heater_avg;
 
     DryerControllerSettings settings;
+    DryerControllerSettings saved_settings; // persisted copy, restored when direct mode times out
+    WriteBehind settings_writer{SETTINGS_QUIET_PERIOD, [this]() { persistSettings(); }};
 
     bool is_legacy_board = false;
     bool sensors_valid = false;
@@ -124,6 +141,7 @@ namespace fg {
     void controlDehumidifierExperimental();
     void controlCooling();
     void controlHeater();
+    void persistSettings();
 
   public:
     DryerController(Fridgecloud& cloud);
@@ -1,6 +1,7 @@
 #include "fan.h"
 #include "dashboard.h"
 #include "wifi.h"
+#include "i2cbus.h"
 #include "time.h"
 #include "esp_sntp.h"
 
@@ -8,15 +9,6 @@
 namespace fg {
 
 
-  template<class T> inline void loadIfAvaliable(T& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<T>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
   static uint32_t rpm = 0;
 
   static void IRAM_ATTR rpm_counter() {
@@ -33,6 +25,8 @@ namespace fg {
 
     float temperature, humidity;
 
+    I2cTransaction transaction(i2cBus(1), I2cPriority::SENSOR);
+
     try {
       uint8_t tries = 0;
       for(; tries < 10; tries++) {
@@ -164,6 +158,7 @@ void FanController::fastloop() {
 void FanController::loop() {
 
   try {
+    settings_writer.poll();
     updateSensors();
     checkDayCycle();
 
@@ -172,8 +167,7 @@ void FanController::loop() {
 
       if(directmode_timer < xTaskGetTickCount()) {
         Serial.println("DIRECTMODE TIMEOUT! REVERTING!");
-        auto saved_settings = fg::settings().getStr("config");
-        loadSettings(saved_settings.c_str());
+        settings = saved_settings;
       }
     }
     else {
@@ -208,33 +202,18 @@ void FanController::loop() {
 }
 
 void FanController::saveAnduploadSettings() {
-  Serial.print("this: ");
-  Serial.println(reinterpret_cast<uint32_t>(this));
+  saved_settings = settings;
+  resetTransientSettings(saved_settings);
+  settings_writer.markDirty();
+}
+
+void FanController::persistSettings() {
   try {
-    fg::settings().setFloat("d_t", settings.day.temperature);
-    fg::settings().setFloat("d_h", settings.day.humidity);
-    fg::settings().setFloat("d_fs", settings.day.fixed_speed);
-    fg::settings().setFloat("d_ms", settings.day.max_speed);
-    fg::settings().setFloat("n_t", settings.night.temperature);
-    fg::settings().setFloat("n_h", settings.night.humidity);
-    fg::settings().setFloat("n_fs", settings.night.fixed_speed);
-    fg::settings().setFloat("n_ms", settings.night.max_speed);
-    fg::settings().setU8("m", settings.mode);
-    fg::settings().setU8("ms", settings.min_speed);
-    fg::settings().commit();
+    FanStoredSettings stored{saved_settings};
+    storeSettings(stored);
 
     StaticJsonDocument<512> config;
-    config["day"]["temperature"] = settings.day.temperature;
-    config["day"]["humidity"] = settings.day.humidity;
-
-    config["day"]["fixed_speed"] = settings.day.fixed_speed;
-    config["day"]["max_speed"] = settings.day.max_speed;
-    config["night"]["temperature"] = settings.night.temperature;
-    config["night"]["humidity"] = settings.night.humidity;
-    config["night"]["fixed_speed"] = settings.night.fixed_speed;
-    config["night"]["max_speed"] = settings.night.max_speed;
-    config["mode"] = settings.mode;
-    config["min_speed"] = settings.min_speed;
+    writeSettings(saved_settings, config.to<JsonObject>());
 
     std::stringstream stream;
     serializeJson(config, stream);
@@ -242,6 +221,9 @@ void FanController::saveAnduploadSettings() {
     Serial.println(stream.str().c_str());
 
     cloud.updateConfig(stream.str().c_str());
+
+    Serial.printf("settings flushed, %u changes in %u flushes, %u nvs commits\n\r",
+      settings_writer.changeCount(), settings_writer.flushCount(), fg::settings().commitCount());
   }
   catch(...) {
     Serial.println("EXCEPTION saving settings!");
@@ -349,8 +331,8 @@ void FanController::saveAnduploadSettings() {
   }
 
   void FanController::init() {
-    Wire.begin(PIN_SDA, PIN_SCL);
-    Wire1.begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
+    i2cBus(0).begin(PIN_SDA, PIN_SCL);
+    i2cBus(1).begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
     delay(100);
 
     sntp_setoperatingmode(SNTP_OPMODE_POLL);
@@ -368,8 +350,14 @@ void FanController::saveAnduploadSettings() {
     pinMode(PIN_RPM, INPUT_PULLUP);
     attachInterrupt(PIN_RPM, rpm_counter, FALLING);
 
-    auto saved_settings = fg::settings().getStr("config");
-    loadSettings(saved_settings.c_str());
+    FanStoredSettings stored{saved_settings};
+    if(!loadStoredSettings(stored)) {
+      // settings of older firmware were stored as JSON, migrate them once
+      loadSettings(fg::settings().getStr("config").c_str());
+      saved_settings = settings;
+      storeSettings(stored);
+    }
+    settings = saved_settings;
 
     cloud.onConfig([&](const String& payload) {
       Serial.println("received settings from cloud");
@@ -380,8 +368,10 @@ void FanController::saveAnduploadSettings() {
         directmode_timer = xTaskGetTickCount() + DIRECTMODE_TIMEOUT;
       }
       else {
-        fg::settings().setStr("config", payload.c_str());
-        fg::settings().commit();
+        saved_settings = settings;
+        settings_writer.discard();
+        FanStoredSettings stored{saved_settings};
+        storeSettings(stored);
       }
 
       loop();
@@ -419,48 +409,19 @@ void FanController::saveAnduploadSettings() {
       settings = new_settings;
     }
     else {
-      loadIfAvaliable(new_settings.mqttcontrol, doc["mqttcontrol"]);
-      loadIfAvaliable(new_settings.mode, doc["mode"]);
-      loadIfAvaliable(new_settings.min_speed, doc["min_speed"]);
-      loadIfAvaliable(new_settings.day.temperature, doc["day"]["temperature"]);
-      loadIfAvaliable(new_settings.day.humidity, doc["day"]["humidity"]);
-      loadIfAvaliable(new_settings.day.fixed_speed, doc["day"]["fixed_speed"]);
-      loadIfAvaliable(new_settings.day.max_speed, doc["day"]["max_speed"]);
-      loadIfAvaliable(new_settings.night.temperature, doc["night"]["temperature"]);
-      loadIfAvaliable(new_settings.night.humidity, doc["night"]["humidity"]);
-      loadIfAvaliable(new_settings.night.fixed_speed, doc["night"]["fixed_speed"]);
-      loadIfAvaliable(new_settings.night.max_speed, doc["night"]["max_speed"]);
+      readSettings(doc.as<JsonVariantConst>(), new_settings);
       if(!doc["co2inject"]["device_id"].isNull()) {
         new_settings.co2inject.enabled = true;
-        loadIfAvaliable(new_settings.co2inject.speed, doc["co2inject"]["speed"]);
-        loadIfAvaliable(new_settings.co2inject.usedaynight, doc["co2inject"]["usedaynight"]);
-        loadIfAvaliable(new_settings.co2inject.day, doc["co2inject"]["day"]);
-        loadIfAvaliable(new_settings.co2inject.night, doc["co2inject"]["night"]);
-        loadIfAvaliable(new_settings.co2inject.period, doc["co2inject"]["period"]);
-        loadIfAvaliable(new_settings.co2inject.duration, doc["co2inject"]["duration"]);
+        SettingsReader reader(doc.as<JsonVariantConst>());
+        new_settings.bindCo2Inject(reader);
       }
     }
 
-    Serial.printf("#################################################\n\r");
-    Serial.printf("new_settings.mode:                %d\n\r", new_settings.mode);
-    Serial.printf("new_settings.min_speed:           %.0f\n\r", new_settings.min_speed);
-    Serial.printf("new_settings.day.temperature:     %.2f\n\r", new_settings.day.temperature);
-    Serial.printf("new_settings.day.humidity:        %.0f\n\r", new_settings.day.humidity);
-    Serial.printf("new_settings.day.fixed_speed:     %.0f\n\r", new_settings.day.fixed_speed);
-    Serial.printf("new_settings.day.max_speed:       %.0f\n\r", new_settings.day.max_speed);
-    Serial.printf("new_settings.night.temperature:   %.2f\n\r", new_settings.night.temperature);
-    Serial.printf("new_settings.night.humidity:      %.0f\n\r", new_settings.night.humidity);
-    Serial.printf("new_settings.night.fixed_speed:   %.0f\n\r", new_settings.night.fixed_speed);
-    Serial.printf("new_settings.night.max_speed:     %.0f\n\r", new_settings.night.max_speed);
+    printSettings(new_settings);
     if(new_settings.co2inject.enabled) {
-      Serial.printf("new_settings.co2inject.speed:     %.0f\n\r", new_settings.co2inject.speed);
-      Serial.printf("new_settings.co2inject.usedaynight:     %u\n\r", new_settings.co2inject.usedaynight);
-      Serial.printf("new_settings.co2inject.day:     %lu\n\r", new_settings.co2inject.day);
-      Serial.printf("new_settings.co2inject.night:     %lu\n\r", new_settings.co2inject.night);
-      Serial.printf("new_settings.co2inject.period:     %lu\n\r", new_settings.co2inject.period);
-      Serial.printf("new_settings.co2inject.duration:     %lu\n\r", new_settings.co2inject.duration);
+      SettingsPrinter printer;
+      new_settings.bindCo2Inject(printer);
     }
-    Serial.printf("#################################################\n\r");
 
     settings = new_settings;
   }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "automation.h"
+#include "settingsblob.h"
+#include "writebehind.h"
 #include "output.h"
 #include "SHTSensor.h"
 
@@ -40,8 +42,43 @@ namespace fg {
     } co2inject;
 
     float min_speed = 100;
+
+    template<class Binder> void bind(Binder& b) {
+      b.transient({"mqttcontrol"}, mqttcontrol);
+      b.field({"day", "temperature"}, day.temperature, -40, 100);
+      b.field({"day", "humidity"}, day.humidity, 0, 100);
+      b.field({"day", "fixed_speed"}, day.fixed_speed, 0, 100);
+      b.field({"day", "max_speed"}, day.max_speed, 0, 100);
+      b.field({"night", "temperature"}, night.temperature, -40, 100);
+      b.field({"night", "humidity"}, night.humidity, 0, 100);
+      b.field({"night", "fixed_speed"}, night.fixed_speed, 0, 100);
+      b.field({"night", "max_speed"}, night.max_speed, 0, 100);
+      b.field({"mode"}, mode, MODE_FIXED, MODE_BOTH);
+      b.field({"min_speed"}, min_speed, 0, 100);
+    }
+
+    // only present when a co2 injection device is paired
+    template<class Binder> void bindCo2Inject(Binder& b) {
+      b.field({"co2inject", "speed"}, co2inject.speed, 0, 100);
+      b.field({"co2inject", "usedaynight"}, co2inject.usedaynight);
+      b.field({"co2inject", "day"}, co2inject.day, 0, 86400);
+      b.field({"co2inject", "night"}, co2inject.night, 0, 86400);
+      b.field({"co2inject", "period"}, co2inject.period);
+      b.field({"co2inject", "duration"}, co2inject.duration);
+    }
+  };
+  // stored form of the fan settings, also keeps the optional co2inject block
+  struct FanStoredSettings {
+    FanControllerSettings& settings;
+
+    template<class Binder> void bind(Binder& b) {
+      settings.bind(b);
+      b.field({"co2inject", "enabled"}, settings.co2inject.enabled);
+      settings.bindCo2Inject(b);
+    }
   };
 
+
   class FanController  : public AutomationController {
     static constexpr uint8_t PIN_FAN = 21;
     static constexpr uint8_t PIN_LIGHTSENSOR = 33;
@@ -55,7 +92,7 @@ namespace fg {
 
     static constexpr uint32_t THRESHHOLD_DAYLIGHT = 128;
 
-    static constexpr TickType_t SETTING_UPLOAD_DELAY = 1000;
+    static constexpr TickType_t SETTINGS_QUIET_PERIOD = configTICK_RATE_HZ * 5;
 
     static constexpr float HALF_HYST_TEMPERATURE = 1.0f;
     static constexpr float HALF_HYST_HUMIDITY = 5.0f;
@@ -68,6 +105,8 @@ namespace fg {
     TickType_t directmode_timer = 0;
 
     FanControllerSettings settings;
+    FanControllerSettings saved_settings; // persisted copy, restored when direct mode times out
+    WriteBehind settings_writer{SETTINGS_QUIET_PERIOD, [this]() { persistSettings(); }};
     struct {
       bool is_day;
       uint32_t timeofday;
@@ -91,8 +130,6 @@ namespace fg {
     fg::MenuItem* max_speed_day;
     fg::MenuItem* max_speed_night;
 
-    TickType_t last_menu_update = 0;
-
     unsigned int testmode_duration = 0;
     Fridgecloud& cloud;
     SHTSensor sht;
@@ -104,6 +141,7 @@ namespace fg {
     void controlFan();
     void saveAnduploadSettings();
     void loadSettings(const String& settings);
+    void persistSettings();
 
   public:
     FanController(Fridgecloud& cloud);
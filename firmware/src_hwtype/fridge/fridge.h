@@ -4,7 +4,10 @@
 #include <SensirionI2CScd4x.h>
 #include "SHTSensor.h"
 #include "output.h"
+#include "ntcmonitor.h"
 #include "automation.h"
+#include "settingsblob.h"
+#include "writebehind.h"
 
 #include "fghmi.h"
 #include "pid.h"
@@ -62,6 +65,29 @@ namespace fg {
       float internal = 100.0;
     } fans;
 
+    template<class Binder> void bind(Binder& b) {
+      b.transient({"mqttcontrol"}, mqttcontrol);
+      b.field({"workmode"}, workmode);
+      b.field({"daynight", "day"}, daynight.day, 0, 86400);
+      b.field({"daynight", "night"}, daynight.night, 0, 86400);
+      b.field({"daynight", "maxDehumidifySeconds"}, daynight.maxDehumidifySeconds, 0, 86400);
+      b.field({"daynight", "targetHumidityDiff"}, daynight.targetHumidityDiff, 0, 100);
+      b.field({"daynight", "useLongHumidityAvg"}, daynight.useLongHumidityAvg);
+      b.field({"daynight", "linearChange"}, daynight.linearChange);
+      b.field({"co2", "target"}, co2.target, 0, 10000);
+      b.field({"co2", "sunsetOff"}, co2.sunsetOff);
+      b.field({"day", "temperature"}, day.temperature, -40, 100);
+      b.field({"day", "humidity"}, day.humidity, 0, 100);
+      b.field({"night", "temperature"}, night.temperature, -40, 100);
+      b.field({"night", "humidity"}, night.humidity, 0, 100);
+      b.field({"lights", "sunrise"}, lights.sunrise, 0, 1440);
+      b.field({"lights", "sunset"}, lights.sunset, 0, 1440);
+      b.field({"lights", "limit"}, lights.limit, 0, 100);
+      b.field({"lights", "maintenanceOn"}, lights.maintenanceOn);
+      b.field({"fans", "external"}, fans.external, 0, 100);
+      b.field({"fans", "internal"}, fans.internal, 0, 100);
+    }
+
     void print() const;
 
   };
@@ -115,6 +141,7 @@ namespace fg {
     static constexpr float MAX_SENSOR_DEVIATION = 15.0;
 
     static constexpr TickType_t DIRECTMODE_TIMEOUT = configTICK_RATE_HZ * 60;
+    static constexpr TickType_t SETTINGS_QUIET_PERIOD = configTICK_RATE_HZ * 5;
 
     static constexpr unsigned int TESTMODE_MAX_DURATION = 10; // times 10sec
     unsigned int testmode_duration = 0;
@@ -133,6 +160,8 @@ namespace fg {
     PwmOutput out_fan_external;
     PwmOutput out_fan_backwall;
 
+    NtcMonitor ntc_monitor;
+
     float co2_turnoff_value = 0.0f;
     uint32_t co2_turnoff_time = 0;
     uint32_t stuck_count = 0;
@@ -146,12 +175,14 @@ namespace fg {
 
     TickType_t directmode_timer = 0;
 
-    Avg<100> humidity_avg_short;
-    Avg<240> humidity_avg_long;
+    Avg<100, Fixed16<100>> humidity_avg_short;
+    Avg<240, Fixed16<100>> humidity_avg_long;
     Avg<20> co2_avg;
     Avg<10> heater_avg;
 
     FridgeControllerSettings settings;
+    FridgeControllerSettings saved_settings; // persisted copy, restored when direct mode times out
+    WriteBehind settings_writer{SETTINGS_QUIET_PERIOD, [this]() { persistSettings(); }};
 
     bool is_legacy_board = false;
     bool sensors_valid = false;
@@ -194,6 +225,7 @@ namespace fg {
     void controlDehumidifierExperimental();
     void controlCooling();
     void controlHeater();
+    void persistSettings();
 
   public:
     FridgeController(Fridgecloud& cloud);
@@ -1,8 +1,7 @@
 #include "dashboard.h"
 #include "icons.h"
 
-#include <sstream>
-#include <iomanip>
+#include "textbuffer.h"
 #include <wifi.h>
 
 
@@ -15,23 +14,23 @@ namespace fg {
     UserInterface::display.setTextColor(SSD1306_WHITE); // Draw white text
     UserInterface::display.setTextSize(1);
 
-    std::stringstream value_print;
+    TextBuffer<16> value_print;
     UserInterface::display.drawBitmap(1, 1, ICON_TEMPERATURE, 16, 16, SSD1306_WHITE);
-    value_print << std::fixed << std::setprecision(1) << *temperature << "C";
+    value_print.fixed(*temperature, 1).append("C");
     UserInterface::display.setCursor(18, 4);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write(value_print.c_str());
 
-    value_print.str(std::string());
+    value_print.clear();
     UserInterface::display.drawBitmap(60, 1, ICON_HUMIDITY, 16, 16, SSD1306_WHITE);
-    value_print << std::fixed << std::setprecision(1) << *humidity << "%";
+    value_print.fixed(*humidity, 1).append("%");
     UserInterface::display.setCursor(78, 4);
-    UserInterface::display.write(value_print.str().c_str());
+    UserInterface::display.write(value_print.c_str());
 
     UserInterface::display.setCursor(50, 40);
     UserInterface::display.setTextSize(2);
-    value_print.str(std::string());
-    value_print << std::fixed << std::setprecision(0) << (*light) << "%";
-    UserInterface::display.write(value_print.str().c_str());
+    value_print.clear();
+    value_print.fixed(*light, 0).append("%");
+    UserInterface::display.write(value_print.c_str());
 
     auto rssi = WiFi.RSSI();
 
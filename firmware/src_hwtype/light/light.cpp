@@ -1,6 +1,7 @@
 #include "light.h"
 #include "dashboard.h"
 #include "wifi.h"
+#include "i2cbus.h"
 #include <MCP7940.h>
 
 #include <sstream>
@@ -28,6 +29,8 @@ namespace fg {
 
     float temperature, humidity;
 
+    I2cTransaction transaction(i2cBus(1), I2cPriority::SENSOR);
+
     try {
       uint8_t tries = 0;
       for(; tries < 10; tries++) {
@@ -80,6 +83,7 @@ namespace fg {
   void LightController::loop() {
 
   try {
+    settings_writer.poll();
     updateSensors();
     checkDayCycle();
 
@@ -88,8 +92,7 @@ namespace fg {
 
       if(directmode_timer < xTaskGetTickCount()) {
         Serial.println("DIRECTMODE TIMEOUT! REVERTING!");
-        auto saved_settings = fg::settings().getStr("config");
-        loadSettings(saved_settings.c_str());
+        settings = saved_settings;
       }
     }
     else {
@@ -122,22 +125,24 @@ namespace fg {
 }
 
 void LightController::saveAndUploadSettings() {
-    DynamicJsonDocument doc(2048);
+  saved_settings = settings;
+  resetTransientSettings(saved_settings);
+  settings_writer.markDirty();
+}
 
-    doc["day"] = settings.day;
-    doc["night"] = settings.night;
-    doc["max_temperature"] = settings.max_temperature;
-    doc["sunrise"] = settings.sunrise;
-    doc["sunset"] = settings.sunset;
-    doc["limit"] = settings.limit;
+void LightController::persistSettings() {
+    DynamicJsonDocument doc(2048);
+    writeSettings(saved_settings, doc.to<JsonObject>());
 
     std::stringstream stream;
     serializeJson(doc, stream);
 
     Serial.println(stream.str().c_str());
-    fg::settings().setStr("config", stream.str().c_str());
-    fg::settings().commit();
+    storeSettings(saved_settings);
     cloud.updateConfig(stream.str().c_str());
+
+    Serial.printf("settings flushed, %u changes in %u flushes, %u nvs commits\n\r",
+      settings_writer.changeCount(), settings_writer.flushCount(), fg::settings().commitCount());
 }
 
   void LightController::controlLight() {
@@ -268,8 +273,8 @@ void LightController::saveAndUploadSettings() {
   }
 
   void LightController::init() {
-    Wire.begin(PIN_SDA, PIN_SCL);
-    Wire1.begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
+    i2cBus(0).begin(PIN_SDA, PIN_SCL);
+    i2cBus(1).begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
     delay(100);
 
     while (!MCP7940.begin()) {  // Initialize RTC communications
@@ -323,8 +328,13 @@ void LightController::saveAndUploadSettings() {
     }
     sht.setAccuracy(SHTSensor::SHT_ACCURACY_MEDIUM); // only supported by SHT3x
 
-    auto saved_settings = fg::settings().getStr("config");
-    loadSettings(saved_settings.c_str());
+    if(!loadStoredSettings(saved_settings)) {
+      // settings of older firmware were stored as JSON, migrate them once
+      loadSettings(fg::settings().getStr("config").c_str());
+      saved_settings = settings;
+      storeSettings(saved_settings);
+    }
+    settings = saved_settings;
 
     cloud.onConfig([&](const String & payload) {
 
@@ -336,8 +346,9 @@ void LightController::saveAndUploadSettings() {
         directmode_timer = xTaskGetTickCount() + DIRECTMODE_TIMEOUT;
       }
       else {
-        fg::settings().setStr("config", payload.c_str());
-        fg::settings().commit();
+        saved_settings = settings;
+        settings_writer.discard();
+        storeSettings(saved_settings);
       }
 
       loop();
@@ -363,24 +374,6 @@ void LightController::saveAndUploadSettings() {
     });
   }
 
-  template<class T> inline void loadIfAvaliable(T& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<T>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
-  template<> inline void loadIfAvaliable(String& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<const char*>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
   void LightController::loadSettings(const String& settings_json) {
     LightControllerSettings new_settings;
     DynamicJsonDocument doc(2048);
@@ -393,25 +386,10 @@ void LightController::saveAndUploadSettings() {
     }
     else {
       Serial.println(settings_json);
-
-      loadIfAvaliable(new_settings.mqttcontrol, doc["mqttcontrol"]);
-      loadIfAvaliable(new_settings.day, doc["day"]);
-      loadIfAvaliable(new_settings.night, doc["night"]);
-      loadIfAvaliable(new_settings.max_temperature, doc["max_temperature"]);
-      loadIfAvaliable(new_settings.limit, doc["limit"]);
-      loadIfAvaliable(new_settings.sunrise, doc["sunrise"]);
-      loadIfAvaliable(new_settings.sunset, doc["sunset"]);
-
+      readSettings(doc.as<JsonVariantConst>(), new_settings);
     }
 
-    Serial.printf("#################################################\n\r");
-    Serial.printf("new_settings.day:             %d\n\r", new_settings.day);
-    Serial.printf("new_settings.night:           %d\n\r", new_settings.night);
-    Serial.printf("new_settings.max_temperature: %.2f\n\r", new_settings.max_temperature);
-    Serial.printf("new_settings.limit:           %.0f\n\r", new_settings.limit);
-    Serial.printf("new_settings.sunrise:         %.0f\n\r", new_settings.sunrise);
-    Serial.printf("new_settings.sunset:          %.0f\n\r", new_settings.sunset);
-    Serial.printf("#################################################\n\r");
+    printSettings(new_settings);
 
     settings = new_settings;
   }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "automation.h"
+#include "settingsblob.h"
+#include "writebehind.h"
 #include "output.h"
 #include "SHTSensor.h"
 
@@ -18,6 +20,16 @@ namespace fg {
       float limit = 100;
       float sunrise = 0;
       float sunset = 0;
+
+      template<class Binder> void bind(Binder& b) {
+        b.transient({"mqttcontrol"}, mqttcontrol);
+        b.field({"day"}, day, 0, 86400);
+        b.field({"night"}, night, 0, 86400);
+        b.field({"max_temperature"}, max_temperature, -40, 100);
+        b.field({"limit"}, limit, 0, 100);
+        b.field({"sunrise"}, sunrise, 0, 1440);
+        b.field({"sunset"}, sunset, 0, 1440);
+      }
   };
 
   class LightController  : public AutomationController {
@@ -30,7 +42,7 @@ namespace fg {
     static constexpr uint8_t PIN_SENSOR_I2CSDA = 15;
     static constexpr uint32_t SENSOR_I2C_FRQ = 10000;
 
-    static constexpr TickType_t SETTING_UPLOAD_DELAY = 1000;
+    static constexpr TickType_t SETTINGS_QUIET_PERIOD = configTICK_RATE_HZ * 5;
 
     static constexpr float LIGHT_TEMP_HYST = 1.0f;
     static constexpr float LIGHT_CONTROL_SPEED = 0.01f;
@@ -48,9 +60,8 @@ namespace fg {
     } state;
 
     LightControllerSettings settings;
-
-
-    TickType_t last_menu_update = 0;
+    LightControllerSettings saved_settings; // persisted copy, restored when direct mode times out
+    WriteBehind settings_writer{SETTINGS_QUIET_PERIOD, [this]() { persistSettings(); }};
 
     unsigned int testmode_duration = 0;
     Fridgecloud& cloud;
@@ -63,6 +74,7 @@ namespace fg {
     void controlLight();
     void saveAndUploadSettings();
     void loadSettings(const String& settings);
+    void persistSettings();
 
   public:
     LightController(Fridgecloud& cloud);
@@ -1,26 +1,23 @@
 #include <memory>
 #include "daisychain.h"
+#include "i2cbus.h"
 #include "Arduino.h"
 
 fg::DaisyMaster* master = nullptr;
 
-void onRequest() {
-  master->send();
-}
-
 void onReceive(int len) {
-  Wire1.flush();
+  master->receive(len);
 }
 
 namespace fg {
 
-  uint8_t DaisyPayload::calculateCrc() const {
-    const uint8_t* ptr = (const uint8_t*)this;
-    uint8_t crc = 0;
-    for(auto i = 0; i < sizeof(DaisyPayload); i++) {
-      crc = crc ^ ptr[i];
-    }
-    return crc;
+  namespace {
+    class Lock {
+      SemaphoreHandle_t mutex;
+    public:
+      explicit Lock(SemaphoreHandle_t mutex) : mutex(mutex) { xSemaphoreTake(mutex, portMAX_DELAY); }
+      ~Lock() { xSemaphoreGive(mutex); }
+    };
   }
 
   DaisyMaster::DaisyMaster(const float& temperature, const float& humidity, const float& co2, const uint8_t& sensor_type) :
@@ -31,11 +28,17 @@ namespace fg {
     }
   }
 
-  void DaisyMaster::init(int sdaPin, int sclPin, uint32_t frequency) {
-    Serial.println("SLAVE I2C INIT NOW!");
+  void DaisyMaster::init(uint8_t node, int sdaPin, int sclPin, uint32_t frequency) {
+    if(node >= DAISY_MAX_NODES) {
+      Serial.printf("invalid daisy node %u, using 0\n", node);
+      node = 0;
+    }
+    this->node = node;
+    mutex = xSemaphoreCreateMutex();
+
+    Serial.printf("SLAVE I2C INIT NOW! node %u at 0x%02x, %u Hz\n", node, DAISY_BASE_ADDR + node, frequency);
     Wire1.onReceive(onReceive);
-    Wire1.onRequest(onRequest);
-    if(Wire1.begin(SLAVE_I2C_ADDR, sdaPin, sclPin, frequency)) {
+    if(i2cBus(1).beginSlave(DAISY_BASE_ADDR + node, sdaPin, sclPin, frequency)) {
       Serial.println("SLAVE I2C INIT SUCCESS");
     }
     else {
@@ -45,52 +48,142 @@ namespace fg {
     Serial.println("SLAVE I2C INIT END");
   }
 
-  void DaisyMaster::send() {
-    DaisyPayload payload;
-    payload.temperture = temperature;
-    payload.humidity = humidity;
-    payload.co2 = co2;
-    payload.sensor_type = sensor_type;
-    payload.crc = payload.calculateCrc();
+  void DaisyMaster::sample() {
+    if(!mutex) {
+      return;
+    }
+    Lock lock(mutex);
+    memmove(samples + 1, samples, sizeof(DaisySample) * (DAISY_MAX_SAMPLES - 1));
+    samples[0] = {temperature, humidity, co2, millis()};
+    if(sample_count < DAISY_MAX_SAMPLES) {
+      sample_count++;
+    }
+  }
 
-    Wire1.write((const uint8_t*)&payload, sizeof(DaisyPayload));
+  void DaisyMaster::setHops(uint8_t hops) {
+    if(!mutex) {
+      return;
+    }
+    Lock lock(mutex);
+    this->hops = hops;
+  }
+
+  void DaisyMaster::receive(int len) {
+    uint8_t command[2] = {0, 0};
+    for(int i = 0; i < len; i++) {
+      uint8_t data = Wire1.read();
+      if(i < static_cast<int>(sizeof(command))) {
+        command[i] = data;
+      }
+    }
+    if(len != static_cast<int>(sizeof(command)) || command[0] != DAISY_CMD_READ || !mutex) {
+      return;
+    }
+
+    uint8_t slots = constrain(command[1], 1, DAISY_MAX_SAMPLES);
+    uint8_t buffer[daisyFrameSize(DAISY_MAX_SAMPLES)];
+    size_t size;
+    {
+      Lock lock(mutex);
+      DaisyFrame frame;
+      frame.node = node;
+      frame.hops = hops;
+      frame.sensor_type = sensor_type;
+      frame.count = sample_count;
+      frame.now = millis();
+      memcpy(frame.samples, samples, sizeof(samples));
+      size = encodeDaisyFrame(frame, slots, buffer, sizeof(buffer));
+    }
+    Wire1.slaveWrite(buffer, size);
   }
 
   bool DaisySlave::init(TwoWire& my_wire) {
     daisy_wire = &my_wire;
+    daisy_wire->setTimeOut(10);
+    daisy_wire->setTimeout(10);
     return true;
   }
 
-  bool DaisySlave::read() {
-    Wire.flush();
-    Wire.setTimeOut(10);
-    Wire.setTimeout(10);
-    auto time = xTaskGetTickCount();
-    Wire.beginTransmission(DaisyMaster::SLAVE_I2C_ADDR);
-    if (Wire.endTransmission() == 0) {
-      uint8_t bytesReceived = Wire.requestFrom(DaisyMaster::SLAVE_I2C_ADDR, sizeof(DaisyPayload));
-      DaisyPayload payload;
-      auto delay = xTaskGetTickCount() - time;
-      Serial.print("DELAY: ");
-      Serial.println(delay);
-
-      if (bytesReceived == sizeof(DaisyPayload)) {  //If received more than zero bytes
-        Wire.readBytes((uint8_t*)&payload, bytesReceived);
-
-        if(payload.calculateCrc() != 0xff) {
-          Serial.println("CHECKSUM FAILED!!");
-          return false;
-        }
-
-        temperature = payload.temperture;
-        humidity = payload.humidity;
-        co2 = payload.co2;
-        sensor_type = payload.sensor_type;
-
+  bool DaisySlave::scan() {
+    for(uint8_t i = 0; i < DAISY_MAX_NODES; i++) {
+      if(readNode(i)) {
+        node = i;
+        Serial.printf("found daisy node %u, %u hops upstream\n", i, hops);
         return true;
       }
     }
+    node = -1;
     return false;
   }
 
-}
\ No newline at end of file
+  bool DaisySlave::read() {
+    if(node < 0) {
+      return scan();
+    }
+    return readNode(node);
+  }
+
+  bool DaisySlave::readNode(uint8_t node_to_read) {
+    uint8_t address = DAISY_BASE_ADDR + node_to_read;
+    daisy_wire->beginTransmission(address);
+    daisy_wire->write(DAISY_CMD_READ);
+    daisy_wire->write(BATCH_SLOTS);
+    if(daisy_wire->endTransmission() != 0) {
+      return false;
+    }
+    vTaskDelay(RESPONSE_DELAY);
+
+    constexpr size_t size = daisyFrameSize(BATCH_SLOTS);
+    uint8_t buffer[size];
+    if(daisy_wire->requestFrom(static_cast<uint16_t>(address), size) != size) {
+      Serial.printf("short daisy frame from node %u\n", node_to_read);
+      return false;
+    }
+    daisy_wire->readBytes(buffer, size);
+
+    DaisyFrame frame;
+    DaisyError error = decodeDaisyFrame(buffer, size, frame);
+    if(error != DaisyError::NONE) {
+      Serial.printf("daisy frame from node %u rejected: %s\n", node_to_read, daisyErrorName(error));
+      return false;
+    }
+    if(frame.node != node_to_read) {
+      Serial.printf("daisy frame from node %u claims node %u\n", node_to_read, frame.node);
+      return false;
+    }
+    if(frame.count == 0 || frame.now - frame.samples[0].time > MAX_AGE) {
+      Serial.printf("no recent samples on daisy node %u\n", node_to_read);
+      return false;
+    }
+
+    // average what arrived since the last read, the newest sample alone if
+    // nothing did or the upstream plug restarted
+    float sum_temperature = 0, sum_humidity = 0, sum_co2 = 0;
+    uint8_t fresh = 0;
+    for(uint8_t i = 0; i < frame.count; i++) {
+      auto& sample = frame.samples[i];
+      if(frame.now - sample.time > MAX_AGE || static_cast<int32_t>(sample.time - last_sample) <= 0) {
+        break;
+      }
+      sum_temperature += sample.temperature;
+      sum_humidity += sample.humidity;
+      sum_co2 += sample.co2;
+      fresh++;
+    }
+    if(fresh == 0) {
+      sum_temperature = frame.samples[0].temperature;
+      sum_humidity = frame.samples[0].humidity;
+      sum_co2 = frame.samples[0].co2;
+      fresh = 1;
+    }
+
+    temperature = sum_temperature / fresh;
+    humidity = sum_humidity / fresh;
+    co2 = sum_co2 / fresh;
+    sensor_type = frame.sensor_type;
+    hops = frame.hops;
+    last_sample = frame.samples[0].time;
+    return true;
+  }
+
+}
@@ -1,49 +1,75 @@
 #pragma once
 
 #include "Wire.h"
+#include "daisyframe.h"
 
 namespace fg {
 
-  struct DaisyPayload {
-    float temperture;
-    float humidity;
-    float co2;
-    uint8_t sensor_type;
-    uint8_t crc;
+  // Plugs are chained over I2C. Every plug serves its own measurements as
+  // an I2C slave on Wire1 at DAISY_BASE_ADDR + node, a plug without a sensor
+  // reads them from the next plug upstream on its sensor bus and serves
+  // them again under its own node address.
+  //
+  // A read is a command write [DAISY_CMD_READ, slots] followed by a read of
+  // daisyFrameSize(slots) bytes. The ESP32 cannot stretch the clock as a
+  // slave, so the frame is queued when the command arrives instead of in
+  // the request callback.
 
-    uint8_t calculateCrc() const;
-  };
+  static constexpr uint8_t DAISY_BASE_ADDR = 0x11;
+  static constexpr uint8_t DAISY_CMD_READ = 0x01;
 
   class DaisySlave {
+    static constexpr uint8_t BATCH_SLOTS = 4;
+    static constexpr uint32_t MAX_AGE = 30000; // ms, older samples are not used
+    static constexpr TickType_t RESPONSE_DELAY = pdMS_TO_TICKS(2);
+
     TwoWire* daisy_wire;
+    int8_t node = -1; // of the upstream plug, -1 until one answered
     float temperature;
     float humidity;
     float co2;
     uint8_t sensor_type;
+    uint8_t hops = 0;
+    uint32_t last_sample = 0; // time of the newest sample used, upstream clock
+
+    bool readNode(uint8_t node_to_read);
 
   public:
     bool init(TwoWire& my_wire);
+    // looks for the upstream plug on every node address
+    bool scan();
     bool read();
     inline float getTemperature() const { return temperature; }
     inline float getHumidity() const { return humidity; }
     inline float getCo2() const { return co2; }
     inline uint8_t getSensorType() const { return sensor_type; }
+    inline uint8_t getHops() const { return hops; }
+    inline int8_t getNode() const { return node; }
   };
 
 
   class DaisyMaster {
-    friend class DaisySlave;
-    static constexpr int SLAVE_I2C_ADDR = 0x11;
     const float& temperature;
     const float& humidity;
     const float& co2;
     const uint8_t& sensor_type;
 
+    SemaphoreHandle_t mutex = NULL;
+    uint8_t node = 0;
+    uint8_t hops = 0;
+    // newest first
+    DaisySample samples[DAISY_MAX_SAMPLES];
+    uint8_t sample_count = 0;
+
   public:
     DaisyMaster(const float& temperature, const float& humidity, const float& co2, const uint8_t& sensor_type);
-    void init(int sdaPin, int sclPin, uint32_t frequency);
-    void send();
+    void init(uint8_t node, int sdaPin, int sclPin, uint32_t frequency);
+    // remembers the current values, called after every sensor update
+    void sample();
+    // 0 if the values come from our own sensor
+    void setHops(uint8_t hops);
+    void receive(int len);
   };
 
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,129 @@
+#include "daisyframe.h"
+
+#include <string.h>
+#include <math.h>
+
+namespace fg {
+
+  namespace {
+    void put16(uint8_t* p, uint16_t value) {
+      p[0] = value & 0xff;
+      p[1] = value >> 8;
+    }
+
+    void put32(uint8_t* p, uint32_t value) {
+      put16(p, value & 0xffff);
+      put16(p + 2, value >> 16);
+    }
+
+    uint16_t get16(const uint8_t* p) {
+      return p[0] | (p[1] << 8);
+    }
+
+    uint32_t get32(const uint8_t* p) {
+      return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16);
+    }
+
+    // fixed point, saturated to the range of the field
+    int32_t scale(float value, float factor, int32_t min, int32_t max) {
+      if(isnan(value)) {
+        return 0;
+      }
+      float scaled = roundf(value * factor);
+      if(scaled < min) {
+        return min;
+      }
+      if(scaled > max) {
+        return max;
+      }
+      return scaled;
+    }
+  }
+
+  uint16_t daisyCrc(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xffff;
+    for(size_t i = 0; i < len; i++) {
+      crc ^= static_cast<uint16_t>(data[i]) << 8;
+      for(uint8_t bit = 0; bit < 8; bit++) {
+        crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+      }
+    }
+    return crc;
+  }
+
+  size_t encodeDaisyFrame(const DaisyFrame& frame, uint8_t slots, uint8_t* buffer, size_t size) {
+    size_t len = daisyFrameSize(slots);
+    if(slots < 1 || slots > DAISY_MAX_SAMPLES || size < len) {
+      return 0;
+    }
+    uint8_t count = frame.count < slots ? frame.count : slots;
+
+    memset(buffer, 0, len);
+    buffer[0] = DAISY_MAGIC;
+    buffer[1] = DAISY_VERSION;
+    buffer[2] = frame.node;
+    buffer[3] = frame.hops;
+    buffer[4] = frame.sensor_type;
+    buffer[5] = count;
+    put32(buffer + 6, frame.now);
+
+    for(uint8_t i = 0; i < count; i++) {
+      auto& sample = frame.samples[i];
+      uint8_t* p = buffer + DAISY_HEADER_SIZE + i * DAISY_SAMPLE_SIZE;
+      put16(p, static_cast<int16_t>(scale(sample.temperature, 100, INT16_MIN, INT16_MAX)));
+      put16(p + 2, scale(sample.humidity, 100, 0, UINT16_MAX));
+      put16(p + 4, scale(sample.co2, 1, 0, UINT16_MAX));
+      put32(p + 6, sample.time);
+    }
+
+    put16(buffer + len - DAISY_CRC_SIZE, daisyCrc(buffer, len - DAISY_CRC_SIZE));
+    return len;
+  }
+
+  DaisyError decodeDaisyFrame(const uint8_t* buffer, size_t len, DaisyFrame& frame) {
+    if(len < daisyFrameSize(1) || (len - daisyFrameSize(0)) % DAISY_SAMPLE_SIZE) {
+      return DaisyError::SIZE;
+    }
+    if(buffer[0] != DAISY_MAGIC) {
+      return DaisyError::MAGIC;
+    }
+    if(buffer[1] != DAISY_VERSION) {
+      return DaisyError::VERSION;
+    }
+    if(get16(buffer + len - DAISY_CRC_SIZE) != daisyCrc(buffer, len - DAISY_CRC_SIZE)) {
+      return DaisyError::CRC;
+    }
+    size_t slots = (len - daisyFrameSize(0)) / DAISY_SAMPLE_SIZE;
+    if(buffer[5] > slots || buffer[5] > DAISY_MAX_SAMPLES || buffer[2] >= DAISY_MAX_NODES) {
+      return DaisyError::COUNT;
+    }
+
+    frame.node = buffer[2];
+    frame.hops = buffer[3];
+    frame.sensor_type = buffer[4];
+    frame.count = buffer[5];
+    frame.now = get32(buffer + 6);
+    for(uint8_t i = 0; i < frame.count; i++) {
+      auto& sample = frame.samples[i];
+      const uint8_t* p = buffer + DAISY_HEADER_SIZE + i * DAISY_SAMPLE_SIZE;
+      sample.temperature = static_cast<int16_t>(get16(p)) / 100.0f;
+      sample.humidity = get16(p + 2) / 100.0f;
+      sample.co2 = get16(p + 4);
+      sample.time = get32(p + 6);
+    }
+    return DaisyError::NONE;
+  }
+
+  const char* daisyErrorName(DaisyError error) {
+    switch(error) {
+      case DaisyError::NONE: return "none";
+      case DaisyError::SIZE: return "size";
+      case DaisyError::MAGIC: return "magic";
+      case DaisyError::VERSION: return "version";
+      case DaisyError::CRC: return "crc";
+      case DaisyError::COUNT: return "count";
+    }
+    return "unknown";
+  }
+
+}
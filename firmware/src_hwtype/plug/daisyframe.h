@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace fg {
+
+  // Wire format of the daisy chain, independent of the compiler's struct
+  // layout. Little endian, sent by a node when the reader asks for it:
+  //   0  magic        DAISY_MAGIC
+  //   1  version      DAISY_VERSION
+  //   2  node         address of the sending node, 0 to DAISY_MAX_NODES - 1
+  //   3  hops         0 if the sender has the sensor, +1 per forwarding plug
+  //   4  sensor_type  of the sender
+  //   5  count        valid samples, newest first
+  //   6  now          ms, clock of the sender at sending time
+  //  10  samples      one slot per requested sample, see DaisySample
+  //   n  crc          CRC-16/CCITT-FALSE over everything before it
+  // The frame always has the requested number of slots, so the reader
+  // knows its length up front. Unused slots are zero.
+
+  static constexpr uint8_t DAISY_MAGIC = 0xd5;
+  static constexpr uint8_t DAISY_VERSION = 1;
+  static constexpr uint8_t DAISY_MAX_NODES = 8;
+  static constexpr uint8_t DAISY_MAX_SAMPLES = 8; // a full frame stays below the 128 byte Wire buffer
+  static constexpr size_t DAISY_HEADER_SIZE = 10;
+  static constexpr size_t DAISY_SAMPLE_SIZE = 10;
+  static constexpr size_t DAISY_CRC_SIZE = 2;
+
+  struct DaisySample {
+    float temperature; // sent in 0.01 °C
+    float humidity;    // sent in 0.01 %
+    float co2;         // sent in ppm
+    uint32_t time;     // ms, clock of the sender when it was taken
+  };
+
+  struct DaisyFrame {
+    uint8_t node = 0;
+    uint8_t hops = 0;
+    uint8_t sensor_type = 0;
+    uint8_t count = 0;
+    uint32_t now = 0;
+    DaisySample samples[DAISY_MAX_SAMPLES];
+  };
+
+  enum class DaisyError {
+    NONE,
+    SIZE,
+    MAGIC,
+    VERSION,
+    CRC,
+    COUNT,
+  };
+
+  constexpr size_t daisyFrameSize(uint8_t slots) {
+    return DAISY_HEADER_SIZE + slots * DAISY_SAMPLE_SIZE + DAISY_CRC_SIZE;
+  }
+
+  uint16_t daisyCrc(const uint8_t* data, size_t len);
+
+  // Writes a frame of daisyFrameSize(slots) bytes, 0 if it does not fit
+  // into the buffer or slots is out of range. Samples beyond slots are left out.
+  size_t encodeDaisyFrame(const DaisyFrame& frame, uint8_t slots, uint8_t* buffer, size_t size);
+
+  // len has to be the size of the whole frame
+  DaisyError decodeDaisyFrame(const uint8_t* buffer, size_t len, DaisyFrame& frame);
+
+  const char* daisyErrorName(DaisyError error);
+
+}
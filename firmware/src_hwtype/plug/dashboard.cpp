@@ -1,8 +1,7 @@
 #include "dashboard.h"
 #include "icons.h"
 
-#include <sstream>
-#include <iomanip>
+#include "textbuffer.h"
 #include <wifi.h>
 
 
@@ -36,24 +35,24 @@ namespace fg {
       UserInterface::display.write("NO SENSOR");
     }
     else {
-      std::stringstream value_print;
+      TextBuffer<16> value_print;
       UserInterface::display.drawBitmap(1, 1, ICON_TEMPERATURE, 16, 16, SSD1306_WHITE);
-      value_print << std::fixed << std::setprecision(1) << *temperature << "C";
+      value_print.fixed(*temperature, 1).append("C");
       UserInterface::display.setCursor(18, 4);
-      UserInterface::display.write(value_print.str().c_str());
+      UserInterface::display.write(value_print.c_str());
 
-      value_print.str(std::string());
+      value_print.clear();
       UserInterface::display.drawBitmap(60, 1, ICON_HUMIDITY, 16, 16, SSD1306_WHITE);
-      value_print << std::fixed << std::setprecision(1) << *humidity << "%";
+      value_print.fixed(*humidity, 1).append("%");
       UserInterface::display.setCursor(78, 4);
-      UserInterface::display.write(value_print.str().c_str());
+      UserInterface::display.write(value_print.c_str());
 
       if(*co2 != 0) {
-        value_print.str(std::string());
+        value_print.clear();
         UserInterface::display.drawBitmap(1, 21, ICON_HUMIDITY, 16, 16, SSD1306_WHITE);
-        value_print << std::fixed << std::setprecision(0) << *co2 << "ppm";
+        value_print.fixed(*co2, 0).append("ppm");
         UserInterface::display.setCursor(18, 25);
-        UserInterface::display.write(value_print.str().c_str());
+        UserInterface::display.write(value_print.c_str());
       }
     }
 
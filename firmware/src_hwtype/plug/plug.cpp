@@ -1,6 +1,7 @@
 #include "plug.h"
 #include "dashboard.h"
 #include "wifi.h"
+#include "i2cbus.h"
 #include <MCP7940.h>
 #include <sstream>
 
@@ -13,21 +14,6 @@ const uint8_t  SPRINTF_BUFFER_SIZE{32};
 MCP7940_Class MCP7940;
 char          inputBuffer[32];
 
-static double ntcToTemp(uint16_t adc_val) {
-  double R1 = 100000.0;   // voltage divider resistor value
-  double Beta = 4250.0;  // Beta value
-  double To = 298.15;    // Temperature in Kelvin for 25 degree Celsius
-  double Ro = 100000.0;   // Resistance of Thermistor at 25 degree Celsius
-
-  double adc_max = 4095.0;
-
-  auto Rt = R1 * (double)adc_val / (adc_max - (double)adc_val);
-
-  auto T = 1/(1/To + log(Rt/Ro)/Beta);    // Temperature in Kelvin
-  auto Tc = T - 273.15;                   // Celsius
-  return Tc;
-}
-
 
 namespace fg {
 
@@ -46,19 +32,25 @@ namespace fg {
     static unsigned sensor_fails = 0;
     static TickType_t last_co2_sample;
 
-    Wire.end();
-    Wire.begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
-
-    if(state.sensor_type == SENSOR_TYPE_SLAVE) {
+    uint8_t read_type = state.sensor_type;
+    uint32_t frequency = read_type == SENSOR_TYPE_SLAVE ? daisy_frequency : SENSOR_I2C_FRQ;
+    I2cTransaction transaction(i2cBus(0), I2cPriority::SENSOR, PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, frequency);
+    if(!transaction) {
+      Serial.println("sensor bus busy!");
+      sensor_fails++;
+    }
+    else if(state.sensor_type == SENSOR_TYPE_SLAVE) {
       Serial.println("SENSOR IS SLAVE");
       if(daisyslave.read()) {
         state.co2 = daisyslave.getCo2();
         state.temperature = daisyslave.getTemperature();
         state.humidity = daisyslave.getHumidity();
         Serial.printf("TEMP: %f, HUM: %f, CO2: %f\n", daisyslave.getTemperature(), daisyslave.getHumidity(), daisyslave.getCo2());
+        daisymaster.setHops(daisyslave.getHops() + 1);
         sensor_fails = 0;
       }
       else {
+        transaction.fail();
         sensor_fails++;
       }
     }
@@ -118,15 +110,11 @@ namespace fg {
     }
     else {
       Serial.println("NO SENSOR!");
-      Wire.end();
       if(initSensor()) {
         sensor_fails = 0;
       }
     }
 
-    Wire.end();
-    Wire.begin(PIN_SDA, PIN_SCL);
-
     if(sensor_fails < 10) {
       sensors_valid = true;
     }
@@ -134,6 +122,14 @@ namespace fg {
       sensors_valid = false;
       state.sensor_type = SENSOR_TYPE_NONE;
     }
+
+    // plugs downstream only get values that were just read
+    if(read_type != SENSOR_TYPE_NONE && sensor_fails == 0) {
+      if(read_type != SENSOR_TYPE_SLAVE) {
+        daisymaster.setHops(0);
+      }
+      daisymaster.sample();
+    }
   }
 
   void PlugController::checkDayCycle() {
@@ -369,26 +365,10 @@ namespace fg {
 
   }
 
-  template<class T> inline void loadIfAvaliable(T& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<T>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
-  template<> inline void loadIfAvaliable(String& val, DynamicJsonDocument doc) {
-    if(!doc.isNull()) {
-      val = doc.as<const char*>();
-    }
-    else {
-      Serial.println("error loading settings field");
-    }
-  }
-
   void PlugController::loadSettings(const String& settings_json) {
     PlugControllerSettings new_settings;
+    // wiring of this plug, kept if the configuration does not carry it
+    new_settings.daisy = settings.daisy;
     DynamicJsonDocument doc(2048);
     DeserializationError error = deserializeJson(doc, settings_json);
 
@@ -399,152 +379,25 @@ namespace fg {
     }
     else {
       Serial.println(settings_json);
-
-      loadIfAvaliable(new_settings.mqttcontrol, doc["mqttcontrol"]);
-      loadIfAvaliable(new_settings.workmode, doc["workmode"]);
-      loadIfAvaliable(new_settings.usedaynight, doc["usedaynight"]);
-      loadIfAvaliable(new_settings.daynight.day, doc["daynight"]["day"]);
-      loadIfAvaliable(new_settings.daynight.night, doc["daynight"]["night"]);
-
-      for(auto timeframe : doc["timer"]["timeframes"].as<JsonArray>()) {
-        new_settings.timer.timeframes.push_back({timeframe["ontime"], timeframe["duration"]});
-      }
-
-      loadIfAvaliable(new_settings.heater.day.on, doc["heater"]["day"]["on"]);
-      loadIfAvaliable(new_settings.heater.day.off, doc["heater"]["day"]["off"]);
-      loadIfAvaliable(new_settings.heater.night.on, doc["heater"]["night"]["on"]);
-      loadIfAvaliable(new_settings.heater.night.off, doc["heater"]["night"]["off"]);
-
-      loadIfAvaliable(new_settings.cooler.day.on, doc["cooler"]["day"]["on"]);
-      loadIfAvaliable(new_settings.cooler.day.off, doc["cooler"]["day"]["off"]);
-      loadIfAvaliable(new_settings.cooler.night.on, doc["cooler"]["night"]["on"]);
-      loadIfAvaliable(new_settings.cooler.night.off, doc["cooler"]["night"]["off"]);
-
-      loadIfAvaliable(new_settings.humidify.day.on, doc["humidify"]["day"]["on"]);
-      loadIfAvaliable(new_settings.humidify.day.off, doc["humidify"]["day"]["off"]);
-      loadIfAvaliable(new_settings.humidify.night.on, doc["humidify"]["night"]["on"]);
-      loadIfAvaliable(new_settings.humidify.night.off, doc["humidify"]["night"]["off"]);
-
-      loadIfAvaliable(new_settings.dehumidify.day.on, doc["dehumidify"]["day"]["on"]);
-      loadIfAvaliable(new_settings.dehumidify.day.off, doc["dehumidify"]["day"]["off"]);
-      loadIfAvaliable(new_settings.dehumidify.night.on, doc["dehumidify"]["night"]["on"]);
-      loadIfAvaliable(new_settings.dehumidify.night.off, doc["dehumidify"]["night"]["off"]);
-
-      loadIfAvaliable(new_settings.co2.mode, doc["co2"]["mode"]);
-      loadIfAvaliable(new_settings.co2.period, doc["co2"]["period"]);
-      loadIfAvaliable(new_settings.co2.duration, doc["co2"]["duration"]);
-      loadIfAvaliable(new_settings.co2.on, doc["co2"]["on"]);
-      loadIfAvaliable(new_settings.co2.off, doc["co2"]["off"]);
-
-      loadIfAvaliable(new_settings.limits.overtemperature.enabled, doc["limits"]["overtemperature"]["enabled"]);
-      loadIfAvaliable(new_settings.limits.overtemperature.limit, doc["limits"]["overtemperature"]["limit"]);
-      loadIfAvaliable(new_settings.limits.overtemperature.hysteresis, doc["limits"]["overtemperature"]["hysteresis"]);
-      loadIfAvaliable(new_settings.limits.undertemperature.enabled, doc["limits"]["undertemperature"]["enabled"]);
-      loadIfAvaliable(new_settings.limits.undertemperature.limit, doc["limits"]["undertemperature"]["limit"]);
-      loadIfAvaliable(new_settings.limits.undertemperature.hysteresis, doc["limits"]["undertemperature"]["hysteresis"]);
-      loadIfAvaliable(new_settings.limits.time.enabled, doc["limits"]["time"]["enabled"]);
-      loadIfAvaliable(new_settings.limits.time.min_off, doc["limits"]["time"]["min_off"]);
-      loadIfAvaliable(new_settings.limits.time.min_on, doc["limits"]["time"]["min_on"]);
-
-      loadIfAvaliable(new_settings.fan, doc["fan"]);
+      readSettings(doc.as<JsonVariantConst>(), new_settings);
     }
 
-    Serial.printf("#################################################\n\r");
-    Serial.printf("new_settings.workmode: %s\n\r", new_settings.workmode);
-    Serial.printf("new_settings.usedaynight: %s\n\r", new_settings.usedaynight ? "YES" : "NO");
-    Serial.printf("new_settings.daynight.day: %lu\n\r", new_settings.daynight.day);
-    Serial.printf("new_settings.daynight.night: %lu\n\r", new_settings.daynight.night);
-    for(auto timeframe : new_settings.timer.timeframes) {
-      Serial.printf("on-time: %lu\n\r", timeframe.ontime);
-      Serial.printf("duration: %lu\n\r", timeframe.duration);
-    }
-    Serial.printf("new_settings.heater.day.on: %.0f\n\r", new_settings.heater.day.on);
-    Serial.printf("new_settings.heater.day.off: %.0f\n\r", new_settings.heater.day.off);
-    Serial.printf("new_settings.heater.night.on: %.0f\n\r", new_settings.heater.night.on);
-    Serial.printf("new_settings.heater.night.off: %.0f\n\r", new_settings.heater.night.off);
-    Serial.printf("new_settings.cooler.day.on: %.0f\n\r", new_settings.cooler.day.on);
-    Serial.printf("new_settings.cooler.day.off: %.0f\n\r", new_settings.cooler.day.off);
-    Serial.printf("new_settings.cooler.night.on: %.0f\n\r", new_settings.cooler.night.on);
-    Serial.printf("new_settings.cooler.night.off: %.0f\n\r", new_settings.cooler.night.off);
-    Serial.printf("new_settings.humidify.day.on: %.0f\n\r", new_settings.humidify.day.on);
-    Serial.printf("new_settings.humidify.day.off: %.0f\n\r", new_settings.humidify.day.off);
-    Serial.printf("new_settings.humidify.night.on: %.0f\n\r", new_settings.humidify.night.on);
-    Serial.printf("new_settings.humidify.night.off: %.0f\n\r", new_settings.humidify.night.off);
-    Serial.printf("new_settings.dehumidify.day.on: %.0f\n\r", new_settings.dehumidify.day.on);
-    Serial.printf("new_settings.dehumidify.day.off: %.0f\n\r", new_settings.dehumidify.day.off);
-    Serial.printf("new_settings.dehumidify.night.on: %.0f\n\r", new_settings.dehumidify.night.on);
-    Serial.printf("new_settings.dehumidify.night.off: %.0f\n\r", new_settings.dehumidify.night.off);
-    Serial.printf("new_settings.co2.mode:  %s\n\r", new_settings.co2.mode);
-    Serial.printf("new_settings.co2.period: %lu\n\r", new_settings.co2.period);
-    Serial.printf("new_settings.co2.duration: %lu\n\r", new_settings.co2.duration);
-    Serial.printf("new_settings.co2.on: %.0f\n\r", new_settings.co2.on);
-    Serial.printf("new_settings.co2.off: %.0f\n\r", new_settings.co2.off);
-    Serial.printf("new_settings.limits.overtemperature.enabled: %s\n\r", new_settings.limits.overtemperature.enabled ? "YES" : "NO");
-    Serial.printf("new_settings.limits.overtemperature.limit: %.0f\n\r", new_settings.limits.overtemperature.limit);
-    Serial.printf("new_settings.limits.overtemperature.hysteresis: %.0f\n\r", new_settings.limits.overtemperature.hysteresis);
-    Serial.printf("new_settings.limits.undertemperature.enabled: %s\n\r", new_settings.limits.undertemperature.enabled ? "YES" : "NO");
-    Serial.printf("new_settings.limits.undertemperature.limit: %.0f\n\r", new_settings.limits.undertemperature.limit);
-    Serial.printf("new_settings.limits.undertemperature.hysteresis: %.0f\n\r", new_settings.limits.undertemperature.hysteresis);
-    Serial.printf("new_settings.limits.time.enabled: %s\n\r", new_settings.limits.time.enabled ? "YES" : "NO");
-    Serial.printf("new_settings.limits.time.min_off: %.0f\n\r", new_settings.limits.time.min_off);
-    Serial.printf("new_settings.limits.time.min_on: %.0f\n\r", new_settings.limits.time.min_on);
-    Serial.printf("#################################################\n\r");
+    printSettings(new_settings);
 
     settings = new_settings;
   }
 
   void PlugController::saveAndUploadSettings() {
-    DynamicJsonDocument doc(2048);
-
-    DynamicJsonDocument array_doc(1024);
-    doc["timer"]["timeframes"] = array_doc.to<JsonArray>();
-    for(auto timeframe : settings.timer.timeframes) {
-      DynamicJsonDocument timeframe_doc(256);
-      timeframe_doc["ontime"] = timeframe.ontime;
-      timeframe_doc["duration"] = timeframe.duration;
-      doc["timer"]["timeframes"].add(timeframe_doc);
-    }
+    saved_settings = settings;
+    resetTransientSettings(saved_settings);
+    settings_writer.markDirty();
+  }
 
-    doc["workmode"] = settings.workmode;
-    doc["usedaynight"] = settings.usedaynight;
-    doc["daynight"]["day"] = settings.daynight.day;
-    doc["daynight"]["night"] = settings.daynight.night;
-    doc["heater"]["day"]["on"] = settings.heater.day.on;
-    doc["heater"]["day"]["off"] = settings.heater.day.off;
-    doc["heater"]["night"]["on"] = settings.heater.night.on;
-    doc["heater"]["night"]["off"] = settings.heater.night.off;
-    doc["cooler"]["day"]["on"] = settings.cooler.day.on;
-    doc["cooler"]["day"]["off"] = settings.cooler.day.off;
-    doc["cooler"]["night"]["on"] = settings.cooler.night.on;
-    doc["cooler"]["night"]["off"] = settings.cooler.night.off;
-    doc["humidify"]["day"]["on"] = settings.humidify.day.on;
-    doc["humidify"]["day"]["off"] = settings.humidify.day.off;
-    doc["humidify"]["night"]["on"] = settings.humidify.night.on;
-    doc["humidify"]["night"]["off"] = settings.humidify.night.off;
-    doc["dehumidify"]["day"]["on"] = settings.dehumidify.day.on;
-    doc["dehumidify"]["day"]["off"] = settings.dehumidify.day.off;
-    doc["dehumidify"]["night"]["on"] = settings.dehumidify.night.on;
-    doc["dehumidify"]["night"]["off"] = settings.dehumidify.night.off;
-    doc["co2"]["mode"] = settings.co2.mode;
-    doc["co2"]["period"] = settings.co2.period;
-    doc["co2"]["duration"] = settings.co2.duration;
-    doc["co2"]["on"] = settings.co2.on;
-    doc["co2"]["off"] = settings.co2.off;
-
-    doc["limits"]["overtemperature"]["enabled"] = settings.limits.overtemperature.enabled;
-    doc["limits"]["overtemperature"]["limit"] = settings.limits.overtemperature.limit;
-    doc["limits"]["overtemperature"]["hysteresis"] = settings.limits.overtemperature.hysteresis;
-    doc["limits"]["undertemperature"]["enabled"] = settings.limits.undertemperature.enabled;
-    doc["limits"]["undertemperature"]["limit"] = settings.limits.undertemperature.limit;
-    doc["limits"]["undertemperature"]["hysteresis"] = settings.limits.undertemperature.hysteresis;
-    doc["limits"]["time"]["enabled"] = settings.limits.time.enabled;
-    doc["limits"]["time"]["min_off"] = settings.limits.time.min_off;
-    doc["limits"]["time"]["min_on"] = settings.limits.time.min_on;
+  void PlugController::persistSettings() {
+    DynamicJsonDocument doc(2048);
+    writeSettings(saved_settings, doc.to<JsonObject>());
 
-    if(settings.workmode == PlugControllerSettings::MODE_CO2) {
-      doc["fan"] = settings.fan;
-    }
-    else {
+    if(saved_settings.workmode != PlugControllerSettings::MODE_CO2) {
       doc["fan"] = "";
     }
 
@@ -552,9 +405,11 @@ namespace fg {
     serializeJson(doc, stream);
 
     Serial.println(stream.str().c_str());
-    fg::settings().setStr("config", stream.str().c_str());
-    fg::settings().commit();
+    storeSettings(saved_settings);
     cloud.updateConfig(stream.str().c_str());
+
+    Serial.printf("settings flushed, %u changes in %u flushes, %u nvs commits\n\r",
+      settings_writer.changeCount(), settings_writer.flushCount(), fg::settings().commitCount());
   }
 
   void PlugController::init() {
@@ -563,8 +418,14 @@ namespace fg {
 
     out_relais.set(0);
 
-    auto saved_settings = fg::settings().getStr("config");
-    loadSettings(saved_settings.c_str());
+    if(!loadStoredSettings(saved_settings)) {
+      // settings of older firmware were stored as JSON, migrate them once
+      loadSettings(fg::settings().getStr("config").c_str());
+      saved_settings = settings;
+      storeSettings(saved_settings);
+    }
+    settings = saved_settings;
+    daisy_frequency = settings.daisy.fast ? DAISY_I2C_FRQ_FAST : DAISY_I2C_FRQ;
 
     cloud.onConfig([&](const String & payload) {
       Serial.println("received new configuration");
@@ -574,8 +435,9 @@ namespace fg {
         directmode_timer = xTaskGetTickCount() + DIRECTMODE_TIMEOUT;
       }
       else {
-        fg::settings().setStr("config", payload.c_str());
-        fg::settings().commit();
+        saved_settings = settings;
+        settings_writer.discard();
+        storeSettings(saved_settings);
       }
 
       loop();
@@ -595,7 +457,7 @@ namespace fg {
       }
     });
 
-    Wire.begin(PIN_SDA, PIN_SCL);
+    i2cBus(0).begin(PIN_SDA, PIN_SCL);
 
     sntp_setoperatingmode(SNTP_OPMODE_POLL);
     sntp_setservername(0, "pool.ntp.org");
@@ -641,19 +503,17 @@ namespace fg {
     timeval epoch = {(time_t)now.unixtime(), 0};
     settimeofday((const timeval*)&epoch, 0);
 
-    Wire.end();
     initSensor();
-    Wire.begin(PIN_SDA, PIN_SCL);
 
     Serial.println("Waiting for first measurement... (5 sec)");
 
     co2_inject_start = xTaskGetTickCount() + CO2_INJECT_DELAY;
 
-    daisymaster.init(PIN_SLAVE_I2CSDA, PIN_SLAVE_I2CSCL, SLAVE_I2C_FRQ);
+    daisymaster.init(settings.daisy.node, PIN_SLAVE_I2CSDA, PIN_SLAVE_I2CSCL, daisy_frequency);
   }
 
   bool PlugController::initSensor() {
-    Wire.begin(PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
+    I2cTransaction transaction(i2cBus(0), I2cPriority::SENSOR, PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, SENSOR_I2C_FRQ);
     bool found_sensor = false;
 
     auto time = xTaskGetTickCount();
@@ -708,8 +568,9 @@ namespace fg {
     time = xTaskGetTickCount();
 
     if(!found_sensor) {
+      I2cTransaction daisy_transaction(i2cBus(0), I2cPriority::SENSOR, PIN_SENSOR_I2CSDA, PIN_SENSOR_I2CSCL, daisy_frequency);
       daisyslave.init(Wire);
-      if(daisyslave.read()) {
+      if(daisyslave.scan()) {
         state.sensor_type = SENSOR_TYPE_SLAVE;
         found_sensor = true;
         Serial.println("FOUND I2C MASTER SENSOR");
@@ -720,7 +581,6 @@ namespace fg {
     Serial.println(xTaskGetTickCount() - time);
     time = xTaskGetTickCount();
 
-    Wire.end();
     return found_sensor;
   }
 
@@ -736,6 +596,7 @@ namespace fg {
   }
 
   void PlugController::loop() {
+    settings_writer.poll();
     updateSensors();
     checkDayCycle();
 
@@ -748,8 +609,7 @@ namespace fg {
 
       if(directmode_timer < xTaskGetTickCount()) {
         Serial.println("DIRECTMODE TIMEOUT! REVERTING!");
-        auto saved_settings = fg::settings().getStr("config");
-        loadSettings(saved_settings.c_str());
+        settings = saved_settings;
       }
     }
     else if(sensors_valid == false) {
@@ -820,6 +680,7 @@ namespace fg {
       time_t now;
       struct tm timeinfo;
       time(&now);
+      I2cTransaction transaction(i2cBus(0), I2cPriority::SENSOR);
       MCP7940.adjust(now);
     }
   }
@@ -840,6 +701,54 @@ namespace fg {
     PlugControllerSettings::CO2MODE_PERIODIC,
   };
 
+  namespace {
+    // the on/off thresholds share one handler, the action id says which
+    // of the four values an entry edits
+    constexpr uint16_t THRESHOLD_OFF = 1;
+    constexpr uint16_t THRESHOLD_DAY = 2;
+
+    constexpr MenuDescriptor TEMPERATURE_DAYNIGHT_MENU[] = {
+      {"ON Day", ICON_TEMPERATURE, THRESHOLD_DAY},
+      {"OFF Day", ICON_TEMPERATURE, THRESHOLD_DAY | THRESHOLD_OFF},
+      {"ON Night", ICON_TEMPERATURE, 0},
+      {"OFF Night", ICON_TEMPERATURE, THRESHOLD_OFF},
+    };
+
+    constexpr MenuDescriptor TEMPERATURE_MENU[] = {
+      {"ON", ICON_TEMPERATURE, 0},
+      {"OFF", ICON_TEMPERATURE, THRESHOLD_OFF},
+    };
+
+    constexpr MenuDescriptor HUMIDITY_DAYNIGHT_MENU[] = {
+      {"ON Day", ICON_HUMIDITY, THRESHOLD_DAY},
+      {"OFF Day", ICON_HUMIDITY, THRESHOLD_DAY | THRESHOLD_OFF},
+      {"ON Night", ICON_HUMIDITY, 0},
+      {"OFF Night", ICON_HUMIDITY, THRESHOLD_OFF},
+    };
+
+    constexpr MenuDescriptor HUMIDITY_MENU[] = {
+      {"ON", ICON_HUMIDITY, 0},
+      {"OFF", ICON_HUMIDITY, THRESHOLD_OFF},
+    };
+
+    // without day/night only the night values are used
+    PlugControllerSettings::Thresholds* thresholdsForMode(PlugControllerSettings& settings) {
+      if(settings.workmode == PlugControllerSettings::MODE_HEAT) {
+        return &settings.heater;
+      }
+      if(settings.workmode == PlugControllerSettings::MODE_COOL) {
+        return &settings.cooler;
+      }
+      if(settings.workmode == PlugControllerSettings::MODE_HUMIDIFY) {
+        return &settings.humidify;
+      }
+      if(settings.workmode == PlugControllerSettings::MODE_DEHUMIDIFY) {
+        return &settings.dehumidify;
+      }
+      return nullptr;
+    }
+  }
+
   void PlugController::initSettingsMenu(UserInterface* ui) {
 
 
@@ -891,6 +800,7 @@ namespace fg {
             int hours = value / 3600;
             int minutes = (value - hours * 3600) / 60;
             DateTime now(2000, 1, 1, hours, minutes);
+            I2cTransaction transaction(i2cBus(0), I2cPriority::SENSOR);
             MCP7940.adjust(now);
             ui->pop();
           });
@@ -914,223 +824,31 @@ namespace fg {
       }
     }
 
-    if(settings.workmode == PlugControllerSettings::MODE_HEAT) {
-
-      if(settings.usedaynight) {
-        menu->addOption("ON Day", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("ON Day", settings.heater.day.on, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.heater.day.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF Day", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("OFF Day", settings.heater.day.off, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.heater.day.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("ON Night", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("ON Night", settings.heater.night.on, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.heater.night.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF Night", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("OFF Night", settings.heater.night.off, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.heater.night.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-      }
-      else {
-        menu->addOption("ON", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("ON", settings.heater.night.on, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.heater.night.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("OFF", settings.heater.night.off, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.heater.night.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-      }
-
-    }
-
-    if(settings.workmode == PlugControllerSettings::MODE_COOL) {
-
-      if(settings.usedaynight) {
-        menu->addOption("ON Day", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("ON Day", settings.cooler.day.on, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.cooler.day.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF Day", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("OFF Day", settings.cooler.day.off, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.cooler.day.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("ON Night", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("ON Night", settings.cooler.night.on, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.cooler.night.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF Night", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("OFF Night", settings.cooler.night.off, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.cooler.night.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
+    auto thresholds = thresholdsForMode(settings);
+    if(thresholds) {
+      bool humidity = settings.workmode == PlugControllerSettings::MODE_HUMIDIFY || settings.workmode == PlugControllerSettings::MODE_DEHUMIDIFY;
+      if(humidity && settings.usedaynight) {
+        menu->addOptions(HUMIDITY_DAYNIGHT_MENU);
       }
-      else {
-        menu->addOption("ON", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("ON", settings.cooler.night.on, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.cooler.night.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF", ICON_TEMPERATURE, [ui, this](){
-          ui->push<FloatInput>("OFF", settings.cooler.night.off, "C", 0, 40, 1, 0, [ui, this](float value) {
-            settings.cooler.night.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
+      else if(humidity) {
+        menu->addOptions(HUMIDITY_MENU);
       }
-
-    }
-
-    if(settings.workmode == PlugControllerSettings::MODE_HUMIDIFY) {
-
-      if(settings.usedaynight) {
-        menu->addOption("ON Day", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("ON Day", settings.humidify.day.on, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.humidify.day.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF Day", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("OFF Day", settings.humidify.day.off, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.humidify.day.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("ON Night", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("ON Night", settings.humidify.night.on, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.humidify.night.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF Night", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("OFF Night", settings.humidify.night.off, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.humidify.night.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
+      else if(settings.usedaynight) {
+        menu->addOptions(TEMPERATURE_DAYNIGHT_MENU);
       }
       else {
-        menu->addOption("ON", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("ON", settings.humidify.night.on, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.humidify.night.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("OFF", settings.humidify.night.off, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.humidify.night.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-      }
-
-    }
-
-    if(settings.workmode == PlugControllerSettings::MODE_DEHUMIDIFY) {
-
-      if(settings.usedaynight) {
-        menu->addOption("ON Day", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("ON Day", settings.dehumidify.day.on, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.dehumidify.day.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF Day", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("OFF Day", settings.dehumidify.day.off, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.dehumidify.day.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("ON Night", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("ON Night", settings.dehumidify.night.on, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.dehumidify.night.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
-
-        menu->addOption("OFF Night", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("OFF Night", settings.dehumidify.night.off, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.dehumidify.night.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
+        menu->addOptions(TEMPERATURE_MENU);
       }
-      else {
-        menu->addOption("ON", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("ON", settings.dehumidify.night.on, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.dehumidify.night.on = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
-        });
 
-        menu->addOption("OFF", ICON_HUMIDITY, [ui, this](){
-          ui->push<FloatInput>("OFF", settings.dehumidify.night.off, "%", 0, 100, 1, 0, [ui, this](float value) {
-            settings.dehumidify.night.off = value;
-            saveAndUploadSettings();
-            ui->pop();
-          });
+      menu->onAction([ui, this, thresholds, humidity](const MenuDescriptor& entry) {
+        auto& threshold = (entry.action & THRESHOLD_DAY) ? thresholds->day : thresholds->night;
+        float& value = (entry.action & THRESHOLD_OFF) ? threshold.off : threshold.on;
+        ui->push<FloatInput>(entry.name, value, humidity ? "%" : "C", 0, humidity ? 100 : 40, 1, 0, [ui, this, &value](float input) {
+          value = input;
+          saveAndUploadSettings();
+          ui->pop();
         });
-      }
+      });
     }
 
     if(settings.workmode == PlugControllerSettings::MODE_CO2) {
@@ -1198,6 +916,7 @@ namespace fg {
             int hours = value / 3600;
             int minutes = (value - hours * 3600) / 60;
             DateTime now(2000, 1, 1, hours, minutes);
+            I2cTransaction transaction(i2cBus(0), I2cPriority::SENSOR);
             MCP7940.adjust(now);
             ui->pop();
           });
@@ -1402,6 +1121,35 @@ namespace fg {
     });
 
 
+    menu->addOption("Daisy Chain", ICON_SETTINGS, [ui, this](){
+      auto menu = ui->push<SelectMenu>();
+
+      menu->addOption("back...", ICON_SETTINGS, [ui, this](){
+        ui->pop();
+      });
+
+      // the slave address and bus speed are set up once at start
+      menu->addOption("Node", ICON_SETTINGS, [ui, this](){
+        std::vector<std::string> nodes;
+        for(uint8_t node = 0; node < DAISY_MAX_NODES; node++) {
+          nodes.push_back(std::to_string(node));
+        }
+        ui->push<SelectInput>("Node (restart)", settings.daisy.node, nodes, [ui, this](uint32_t node) {
+          settings.daisy.node = node;
+          saveAndUploadSettings();
+          ui->pop();
+        });
+      });
+
+      menu->addOption("Bus Speed", ICON_SETTINGS, [ui, this](){
+        ui->push<SelectInput>("Bus Speed (restart)", settings.daisy.fast ? 1 : 0, std::vector<std::string>{"100 kHz", "400 kHz"}, [ui, this](uint32_t speed) {
+          settings.daisy.fast = speed == 1;
+          saveAndUploadSettings();
+          ui->pop();
+        });
+      });
+    });
+
     menu->addOption("WiFi Connection", ICON_WIFI_FULL, [ui, this](){
       showWifiUi(ui, &cloud);
     });
@@ -5,6 +5,8 @@
 #include "SHTSensor.h"
 #include "output.h"
 #include "automation.h"
+#include "settingsblob.h"
+#include "writebehind.h"
 #include "daisychain.h"
 
 #include "fghmi.h"
@@ -18,6 +20,11 @@ namespace fg {
     struct Timerslot {
       uint32_t ontime;
       uint32_t duration;
+
+      template<class Binder> void bind(Binder& b) {
+        b.field({"ontime"}, ontime);
+        b.field({"duration"}, duration);
+      }
     };
 
     static constexpr const char* MODE_TIMER = "timer";
@@ -34,6 +41,16 @@ namespace fg {
 
     bool mqttcontrol = false;
 
+    struct Threshold {
+      float on = 25.0;
+      float off = 30.0;
+    };
+
+    struct Thresholds {
+      Threshold day;
+      Threshold night;
+    };
+
     bool usedaynight = false;
     struct {
       uint32_t day = 21600;
@@ -44,49 +61,13 @@ namespace fg {
       std::vector<Timerslot> timeframes;
     } timer;
 
-    struct {
-      struct {
-        float on = 25.0;
-        float off = 30.0;
-      } day;
-      struct {
-        float on = 25.0;
-        float off = 30.0;
-      } night;
-    } heater;
+    Thresholds heater;
 
-    struct {
-      struct {
-        float on = 25.0;
-        float off = 30.0;
-      } day;
-      struct {
-        float on = 25.0;
-        float off = 30.0;
-      } night;
-    } cooler;
+    Thresholds cooler;
 
-    struct {
-      struct {
-        float on = 25.0;
-        float off = 30.0;
-      } day;
-      struct {
-        float on = 25.0;
-        float off = 30.0;
-      } night;
-    } humidify;
+    Thresholds humidify;
 
-    struct {
-      struct {
-        float on = 25.0;
-        float off = 30.0;
-      } day;
-      struct {
-        float on = 25.0;
-        float off = 30.0;
-      } night;
-    } dehumidify;
+    Thresholds dehumidify;
     struct {
       String mode = CO2MODE_CONST;
       uint32_t period = 60;
@@ -115,9 +96,57 @@ namespace fg {
       } time;
     } limits;
 
+    // position in the plug chain and bus speed, used from the next start
+    struct {
+      uint32_t node = 0;
+      bool fast = false; // needs short wires between the plugs
+    } daisy;
+
     String workmode = MODE_OFF;
     String fan = "";
 
+    template<class Binder> void bind(Binder& b) {
+      b.transient({"mqttcontrol"}, mqttcontrol);
+      b.field({"workmode"}, workmode);
+      b.field({"usedaynight"}, usedaynight);
+      b.field({"daynight", "day"}, daynight.day, 0, 86400);
+      b.field({"daynight", "night"}, daynight.night, 0, 86400);
+      b.field({"timer", "timeframes"}, timer.timeframes);
+      b.field({"heater", "day", "on"}, heater.day.on);
+      b.field({"heater", "day", "off"}, heater.day.off);
+      b.field({"heater", "night", "on"}, heater.night.on);
+      b.field({"heater", "night", "off"}, heater.night.off);
+      b.field({"cooler", "day", "on"}, cooler.day.on);
+      b.field({"cooler", "day", "off"}, cooler.day.off);
+      b.field({"cooler", "night", "on"}, cooler.night.on);
+      b.field({"cooler", "night", "off"}, cooler.night.off);
+      b.field({"humidify", "day", "on"}, humidify.day.on);
+      b.field({"humidify", "day", "off"}, humidify.day.off);
+      b.field({"humidify", "night", "on"}, humidify.night.on);
+      b.field({"humidify", "night", "off"}, humidify.night.off);
+      b.field({"dehumidify", "day", "on"}, dehumidify.day.on);
+      b.field({"dehumidify", "day", "off"}, dehumidify.day.off);
+      b.field({"dehumidify", "night", "on"}, dehumidify.night.on);
+      b.field({"dehumidify", "night", "off"}, dehumidify.night.off);
+      b.field({"co2", "mode"}, co2.mode);
+      b.field({"co2", "period"}, co2.period);
+      b.field({"co2", "duration"}, co2.duration);
+      b.field({"co2", "on"}, co2.on);
+      b.field({"co2", "off"}, co2.off);
+      b.field({"limits", "overtemperature", "enabled"}, limits.overtemperature.enabled);
+      b.field({"limits", "overtemperature", "limit"}, limits.overtemperature.limit);
+      b.field({"limits", "overtemperature", "hysteresis"}, limits.overtemperature.hysteresis);
+      b.field({"limits", "undertemperature", "enabled"}, limits.undertemperature.enabled);
+      b.field({"limits", "undertemperature", "limit"}, limits.undertemperature.limit);
+      b.field({"limits", "undertemperature", "hysteresis"}, limits.undertemperature.hysteresis);
+      b.field({"limits", "time", "enabled"}, limits.time.enabled);
+      b.field({"limits", "time", "min_off"}, limits.time.min_off);
+      b.field({"limits", "time", "min_on"}, limits.time.min_on);
+      b.field({"fan"}, fan);
+      b.optional({"daisy", "node"}, daisy.node, 0, DAISY_MAX_NODES - 1);
+      b.optional({"daisy", "fast"}, daisy.fast);
+    }
+
     void print() const;
   };
 
@@ -134,7 +163,8 @@ namespace fg {
 
     static constexpr uint8_t PIN_SLAVE_I2CSCL = 12;
     static constexpr uint8_t PIN_SLAVE_I2CSDA = 13;
-    static constexpr uint32_t SLAVE_I2C_FRQ = 10000;
+    static constexpr uint32_t DAISY_I2C_FRQ = 100000;
+    static constexpr uint32_t DAISY_I2C_FRQ_FAST = 400000; // settings daisy.fast
 
     static constexpr double HEATER_MAX_TEMPERATURE = 80.0;
     static constexpr double HEATER_PID_P = 0.5;
@@ -156,6 +186,7 @@ namespace fg {
     float testmode_heater_power = 0;
 
     static constexpr TickType_t DIRECTMODE_TIMEOUT = configTICK_RATE_HZ * 60;
+    static constexpr TickType_t SETTINGS_QUIET_PERIOD = configTICK_RATE_HZ * 5;
     TickType_t directmode_timer = 0;
 
 
@@ -165,6 +196,7 @@ namespace fg {
 
     DaisyMaster daisymaster;
     DaisySlave daisyslave;
+    uint32_t daisy_frequency = DAISY_I2C_FRQ;
 
     // PinOutput out_heater;
     // PinOutput out_dehumidifier;
@@ -182,10 +214,12 @@ namespace fg {
 
     TickType_t co2_inject_start = 0;
 
-    Avg<300> humidity_avg;
+    Avg<300, Fixed16<100>> humidity_avg;
     // Avg<300> co2_avg;
 
     PlugControllerSettings settings;
+    PlugControllerSettings saved_settings; // persisted copy, restored when direct mode times out
+    WriteBehind settings_writer{SETTINGS_QUIET_PERIOD, [this]() { persistSettings(); }};
 
     bool is_legacy_board = false;
     bool sensors_valid = false;
@@ -225,6 +259,7 @@ namespace fg {
     bool initSensor();
 
     void checkLimits(uint8_t output);
+    void persistSettings();
 
   public:
     PlugController(Fridgecloud& cloud);
@@ -0,0 +1,121 @@
+#include "brokerlist.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+using fg::BrokerList;
+
+static const uint16_t PORT = 1883;
+static const TickType_t FAILOVER = BrokerList::FAILOVER_TIMEOUT;
+static const TickType_t PROBE = BrokerList::PROBE_INTERVAL;
+
+int test_parse() {
+    IT("parses hosts with and without a port");
+    BrokerList list;
+    list.parse("a.example, b.example:8883 ,c.example:", PORT);
+    IS_EQUAL(list.size(), 3u);
+    IS_TRUE(list[0].host == "a.example");
+    IS_EQUAL(list[0].port, PORT);
+    IS_TRUE(list[1].host == "b.example");
+    IS_EQUAL(list[1].port, 8883);
+    // an invalid port stays part of the host
+    IS_TRUE(list[2].host == "c.example:");
+    IS_EQUAL(list[2].port, PORT);
+    IS_EQUAL(list.activeIndex(), 0u);
+    END_IT
+}
+
+int test_parse_skips_empty() {
+    IT("skips empty entries");
+    BrokerList list;
+    list.parse(" ,a.example,, ", PORT);
+    IS_EQUAL(list.size(), 1u);
+    IS_TRUE(list.active().host == "a.example");
+    list.parse("", PORT);
+    IS_EQUAL(list.size(), 0u);
+    END_IT
+}
+
+int test_single_broker_stays() {
+    IT("never fails over with a single broker");
+    BrokerList list;
+    list.parse("a.example", PORT);
+    IS_FALSE(list.update(false, 0));
+    IS_FALSE(list.update(false, FAILOVER * 10));
+    IS_EQUAL(list.activeIndex(), 0u);
+    END_IT
+}
+
+int test_failover_after_timeout() {
+    IT("fails over once the active broker stayed unreachable");
+    BrokerList list;
+    list.parse("a.example,b.example,c.example", PORT);
+    list.update(false, 0);
+    IS_FALSE(list.update(false, FAILOVER - 1));
+    IS_TRUE(list.update(false, FAILOVER));
+    IS_EQUAL(list.activeIndex(), 1u);
+    // the next one gets the full timeout too
+    IS_FALSE(list.update(false, 2 * FAILOVER - 1));
+    IS_TRUE(list.update(false, 2 * FAILOVER));
+    IS_EQUAL(list.activeIndex(), 2u);
+    IS_TRUE(list.update(false, 3 * FAILOVER));
+    IS_EQUAL(list.activeIndex(), 0u);
+    END_IT
+}
+
+int test_lost_connection_gets_timeout() {
+    IT("gives a lost broker the full timeout to come back");
+    BrokerList list;
+    list.parse("a.example,b.example", PORT);
+    list.update(true, 0);
+    list.update(true, 5 * FAILOVER);
+    IS_FALSE(list.update(false, 5 * FAILOVER + 1));
+    IS_FALSE(list.update(false, 6 * FAILOVER));
+    IS_TRUE(list.update(false, 6 * FAILOVER + 1));
+    IS_EQUAL(list.activeIndex(), 1u);
+    END_IT
+}
+
+int test_probe_only_on_fallback() {
+    IT("probes the preferred brokers only while connected to a fallback");
+    BrokerList list;
+    list.parse("a.example,b.example", PORT);
+    list.update(true, 0);
+    IS_FALSE(list.probeDue(PROBE * 2));
+
+    list.select(1, 0);
+    IS_FALSE(list.probeDue(PROBE));
+    list.update(true, 1);
+    IS_FALSE(list.probeDue(PROBE - 1));
+    IS_TRUE(list.probeDue(PROBE));
+    IS_FALSE(list.probeDue(PROBE + 1));
+    IS_TRUE(list.probeDue(2 * PROBE));
+
+    list.update(false, 2 * PROBE);
+    IS_FALSE(list.probeDue(4 * PROBE));
+    END_IT
+}
+
+int test_select() {
+    IT("selects a broker and falls back to the first on a bad index");
+    BrokerList list;
+    list.parse("a.example,b.example", PORT);
+    list.select(1, 0);
+    IS_EQUAL(list.activeIndex(), 1u);
+    list.select(5, 0);
+    IS_EQUAL(list.activeIndex(), 0u);
+    END_IT
+}
+
+int main()
+{
+    SUITE("BrokerList");
+    test_parse();
+    test_parse_skips_empty();
+    test_single_broker_stays();
+    test_failover_after_timeout();
+    test_lost_connection_gets_timeout();
+    test_probe_only_on_fallback();
+    test_select();
+
+    FINISH
+}
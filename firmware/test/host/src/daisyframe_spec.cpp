@@ -0,0 +1,192 @@
+#include "daisyframe.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <math.h>
+#include <string.h>
+
+using namespace fg;
+
+static DaisyFrame sampleFrame() {
+    DaisyFrame frame;
+    frame.node = 3;
+    frame.hops = 2;
+    frame.sensor_type = 2;
+    frame.count = 3;
+    frame.now = 0xfffffff0u;
+    frame.samples[0] = {23.45f, 55.5f, 812, 0xffffffe0u};
+    frame.samples[1] = {-5.01f, 0.0f, 70000, 0xffff0000u};
+    frame.samples[2] = {NAN, 120.0f, -4, 1};
+    return frame;
+}
+
+// recomputes the crc after a header field was changed
+static void reseal(uint8_t* buffer, size_t len) {
+    uint16_t crc = daisyCrc(buffer, len - DAISY_CRC_SIZE);
+    buffer[len - 2] = crc & 0xff;
+    buffer[len - 1] = crc >> 8;
+}
+
+int test_crc_check_value() {
+    IT("computes the CRC-16/CCITT-FALSE check value");
+    IS_EQUAL(daisyCrc((const uint8_t*)"123456789", 9), 0x29b1);
+    END_IT
+}
+
+int test_round_trip() {
+    IT("decodes what it encoded");
+    DaisyFrame frame = sampleFrame();
+    uint8_t buffer[daisyFrameSize(DAISY_MAX_SAMPLES)];
+    size_t len = encodeDaisyFrame(frame, 4, buffer, sizeof(buffer));
+    IS_EQUAL(len, daisyFrameSize(4));
+
+    DaisyFrame decoded;
+    IS_TRUE(decodeDaisyFrame(buffer, len, decoded) == DaisyError::NONE);
+    IS_EQUAL(decoded.node, 3);
+    IS_EQUAL(decoded.hops, 2);
+    IS_EQUAL(decoded.sensor_type, 2);
+    IS_EQUAL(decoded.count, 3);
+    IS_EQUAL(decoded.now, 0xfffffff0u);
+    IS_TRUE(fabsf(decoded.samples[0].temperature - 23.45f) < 0.006f);
+    IS_TRUE(fabsf(decoded.samples[0].humidity - 55.5f) < 0.006f);
+    IS_EQUAL(decoded.samples[0].co2, 812);
+    IS_EQUAL(decoded.samples[0].time, 0xffffffe0u);
+    IS_TRUE(fabsf(decoded.samples[1].temperature + 5.01f) < 0.006f);
+    END_IT
+}
+
+int test_saturates() {
+    IT("saturates values outside a field and sends NaN as 0");
+    DaisyFrame frame = sampleFrame();
+    uint8_t buffer[daisyFrameSize(DAISY_MAX_SAMPLES)];
+    size_t len = encodeDaisyFrame(frame, 4, buffer, sizeof(buffer));
+
+    DaisyFrame decoded;
+    IS_TRUE(decodeDaisyFrame(buffer, len, decoded) == DaisyError::NONE);
+    IS_EQUAL(decoded.samples[1].co2, 65535);
+    IS_EQUAL(decoded.samples[2].co2, 0);
+    IS_EQUAL(decoded.samples[2].temperature, 0);
+    IS_EQUAL(decoded.samples[2].humidity, 120.0f);
+    END_IT
+}
+
+int test_bit_flips() {
+    IT("detects every single bit flip and 16 bit burst");
+    DaisyFrame frame = sampleFrame();
+    uint8_t buffer[daisyFrameSize(DAISY_MAX_SAMPLES)];
+    size_t len = encodeDaisyFrame(frame, 4, buffer, sizeof(buffer));
+
+    DaisyFrame decoded;
+    int undetected = 0;
+    for (size_t bit = 0; bit < len * 8; bit++) {
+        uint8_t corrupt[sizeof(buffer)];
+        memcpy(corrupt, buffer, len);
+        corrupt[bit / 8] ^= 1 << (bit % 8);
+        if (decodeDaisyFrame(corrupt, len, decoded) == DaisyError::NONE) {
+            undetected++;
+        }
+    }
+    for (size_t i = 0; i + 2 <= len; i++) {
+        uint8_t corrupt[sizeof(buffer)];
+        memcpy(corrupt, buffer, len);
+        corrupt[i] ^= 0xa5;
+        corrupt[i + 1] ^= 0x3c;
+        if (decodeDaisyFrame(corrupt, len, decoded) == DaisyError::NONE) {
+            undetected++;
+        }
+    }
+    IS_EQUAL(undetected, 0);
+    END_IT
+}
+
+int test_header_errors() {
+    IT("names the broken part of a frame");
+    DaisyFrame frame = sampleFrame();
+    uint8_t buffer[daisyFrameSize(DAISY_MAX_SAMPLES)];
+    size_t len = encodeDaisyFrame(frame, 4, buffer, sizeof(buffer));
+
+    DaisyFrame decoded;
+    uint8_t corrupt[sizeof(buffer)];
+    memcpy(corrupt, buffer, len);
+    corrupt[0] ^= 1;
+    IS_TRUE(decodeDaisyFrame(corrupt, len, decoded) == DaisyError::MAGIC);
+
+    memcpy(corrupt, buffer, len);
+    corrupt[1] = DAISY_VERSION + 1;
+    IS_TRUE(decodeDaisyFrame(corrupt, len, decoded) == DaisyError::VERSION);
+
+    memcpy(corrupt, buffer, len);
+    corrupt[20] ^= 0x10;
+    IS_TRUE(decodeDaisyFrame(corrupt, len, decoded) == DaisyError::CRC);
+
+    // more valid samples than slots, or a node out of range
+    memcpy(corrupt, buffer, len);
+    corrupt[5] = 5;
+    reseal(corrupt, len);
+    IS_TRUE(decodeDaisyFrame(corrupt, len, decoded) == DaisyError::COUNT);
+
+    memcpy(corrupt, buffer, len);
+    corrupt[2] = DAISY_MAX_NODES;
+    reseal(corrupt, len);
+    IS_TRUE(decodeDaisyFrame(corrupt, len, decoded) == DaisyError::COUNT);
+    END_IT
+}
+
+int test_size_errors() {
+    IT("rejects frames that are not a whole number of slots");
+    DaisyFrame frame = sampleFrame();
+    uint8_t buffer[daisyFrameSize(DAISY_MAX_SAMPLES)];
+    size_t len = encodeDaisyFrame(frame, 4, buffer, sizeof(buffer));
+
+    DaisyFrame decoded;
+    IS_TRUE(decodeDaisyFrame(buffer, len - 1, decoded) == DaisyError::SIZE);
+    IS_TRUE(decodeDaisyFrame(buffer, 5, decoded) == DaisyError::SIZE);
+    IS_TRUE(decodeDaisyFrame(buffer, daisyFrameSize(0), decoded) == DaisyError::SIZE);
+    END_IT
+}
+
+int test_slots() {
+    IT("cuts the samples to the requested slots");
+    DaisyFrame frame = sampleFrame();
+    frame.count = DAISY_MAX_SAMPLES;
+    uint8_t buffer[daisyFrameSize(DAISY_MAX_SAMPLES)];
+
+    size_t len = encodeDaisyFrame(frame, 2, buffer, sizeof(buffer));
+    IS_EQUAL(len, daisyFrameSize(2));
+    DaisyFrame decoded;
+    IS_TRUE(decodeDaisyFrame(buffer, len, decoded) == DaisyError::NONE);
+    IS_EQUAL(decoded.count, 2);
+
+    IS_EQUAL(encodeDaisyFrame(frame, DAISY_MAX_SAMPLES, buffer, sizeof(buffer)), daisyFrameSize(DAISY_MAX_SAMPLES));
+    IS_EQUAL(encodeDaisyFrame(frame, 0, buffer, sizeof(buffer)), 0u);
+    IS_EQUAL(encodeDaisyFrame(frame, DAISY_MAX_SAMPLES + 1, buffer, sizeof(buffer)), 0u);
+    IS_EQUAL(encodeDaisyFrame(frame, DAISY_MAX_SAMPLES, buffer, daisyFrameSize(DAISY_MAX_SAMPLES) - 1), 0u);
+    END_IT
+}
+
+int test_empty() {
+    IT("sends a frame without samples");
+    DaisyFrame frame = sampleFrame();
+    frame.count = 0;
+    uint8_t buffer[daisyFrameSize(1)];
+    size_t len = encodeDaisyFrame(frame, 1, buffer, sizeof(buffer));
+
+    DaisyFrame decoded;
+    IS_TRUE(decodeDaisyFrame(buffer, len, decoded) == DaisyError::NONE);
+    IS_EQUAL(decoded.count, 0);
+    END_IT
+}
+
+int main()
+{
+    SUITE("DaisyFrame");
+    test_crc_check_value();
+    test_round_trip();
+    test_saturates();
+    test_bit_flips();
+    test_header_errors();
+    test_size_errors();
+    test_slots();
+    test_empty();
+
+    FINISH
+}
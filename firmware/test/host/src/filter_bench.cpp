@@ -0,0 +1,109 @@
+#include "filter.h"
+#include "bench.h"
+#include <algorithm>
+
+// Avg as it was before the running sum, summing the window on every avg()
+template<int size>
+class SummingAvg {
+    float samples[size];
+    unsigned position = 0;
+    unsigned filled = 0;
+public:
+    void push(float value) {
+        samples[position++] = value;
+        position = position == size ? 0 : position;
+        filled = filled < size ? filled + 1 : filled;
+    }
+
+    float avg() {
+        float sum = 0;
+        for (unsigned i = 0; i < filled; i++) {
+            sum += samples[i];
+        }
+        return filled ? sum / (float)filled : 0.0f;
+    }
+};
+
+// window kept as a ring buffer, min/max scanned and median selected per query
+template<int size>
+class ScanningWindow {
+    float samples[size];
+    unsigned position = 0;
+    unsigned filled = 0;
+public:
+    void push(float value) {
+        samples[position++] = value;
+        position = position == size ? 0 : position;
+        filled = filled < size ? filled + 1 : filled;
+    }
+
+    float min() const { return filled ? *std::min_element(samples, samples + filled) : 0.0f; }
+    float max() const { return filled ? *std::max_element(samples, samples + filled) : 0.0f; }
+
+    float median() const {
+        float copy[size];
+        std::copy(samples, samples + filled, copy);
+        std::nth_element(copy, copy + filled / 2, copy + filled);
+        return filled ? copy[filled / 2] : 0.0f;
+    }
+};
+
+// one control tick of the fridge: push the sample, read the mean three
+// times like controlCo2 and the humidity control do
+template<typename Filter>
+void benchTick(const char* name, Filter& filter) {
+    bench(name, 1000000, [&](unsigned long i) {
+        filter.push(50.0f + (i % 100) / 10.0f);
+        return filter.avg() + filter.avg() + filter.avg();
+    });
+}
+
+int main()
+{
+    printf("push + 3x avg per tick\n");
+    SummingAvg<300> summing;
+    fg::Avg<300> running;
+    fg::Avg<300, fg::Fixed16<100>> fixed;
+    benchTick("summing Avg<300>", summing);
+    benchTick("running Avg<300>", running);
+    benchTick("running Avg<300, Fixed16<100>>", fixed);
+
+    printf("push + min + max per tick\n");
+    ScanningWindow<300> scanning;
+    fg::WindowMinMax<300> minmax;
+    bench("scanning window<300>", 1000000, [&](unsigned long i) {
+        scanning.push(50.0f + (i % 100) / 10.0f);
+        return scanning.min() + scanning.max();
+    });
+    bench("WindowMinMax<300>", 1000000, [&](unsigned long i) {
+        minmax.push(50.0f + (i % 100) / 10.0f);
+        return minmax.min() + minmax.max();
+    });
+
+    printf("push + median per tick\n");
+    ScanningWindow<301> selecting;
+    fg::Median<301> median;
+    bench("nth_element window<301>", 100000, [&](unsigned long i) {
+        selecting.push(50.0f + (i * 37 % 100) / 10.0f);
+        return selecting.median();
+    });
+    bench("Median<301>", 1000000, [&](unsigned long i) {
+        median.push(50.0f + (i * 37 % 100) / 10.0f);
+        return median.median();
+    });
+
+    printf("push per tick\n");
+    fg::Ema ema(0.05f);
+    bench("Ema", 1000000, [&](unsigned long i) {
+        return ema.push(50.0f + (i % 100) / 10.0f);
+    });
+
+    printf("window RAM\n");
+    printf("  %-40s %9zu bytes\n", "summing Avg<300>", sizeof(summing));
+    printf("  %-40s %9zu bytes\n", "running Avg<300>", sizeof(running));
+    printf("  %-40s %9zu bytes\n", "running Avg<300, Fixed16<100>>", sizeof(fixed));
+    printf("  %-40s %9zu bytes\n", "WindowMinMax<300>", sizeof(minmax));
+    printf("  %-40s %9zu bytes\n", "Median<301>", sizeof(median));
+    printf("  %-40s %9zu bytes\n", "Median<301, Fixed16<100>>", sizeof(fg::Median<301, fg::Fixed16<100>>));
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include "filter.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+
+// mean of the last count values pushed, the way the old Avg summed it
+static double naiveMean(const float* values, int pushed, int count) {
+    int first = pushed > count ? pushed - count : 0;
+    double sum = 0;
+    for (int i = first; i < pushed; i++) {
+        sum += values[i];
+    }
+    return pushed ? sum / (pushed - first) : 0;
+}
+
+// the last count values pushed, sorted
+static void naiveWindow(const float* values, int pushed, int count, float* window, int& length) {
+    int first = pushed > count ? pushed - count : 0;
+    length = pushed - first;
+    std::copy(values + first, values + pushed, window);
+    std::sort(window, window + length);
+}
+
+static float naiveMedian(const float* values, int pushed, int count) {
+    static float window[1000];
+    int length;
+    naiveWindow(values, pushed, count, window, length);
+    if (!length) {
+        return 0;
+    }
+    return length & 1 ? window[length / 2] : (window[length / 2 - 1] + window[length / 2]) / 2.0f;
+}
+
+int test_avg_empty() {
+    IT("is zero before the first sample");
+    fg::Avg<4> avg;
+    IS_TRUE(avg.avg() == 0.0f);
+    IS_TRUE(avg.last() == 0.0f);
+    IS_EQUAL(avg.count(), 0u);
+    END_IT
+}
+
+int test_avg_partial_window() {
+    IT("averages only the samples pushed so far");
+    fg::Avg<10> avg;
+    avg.push(1);
+    avg.push(2);
+    avg.push(6);
+    IS_TRUE(avg.avg() == 3.0f);
+    IS_TRUE(avg.last() == 6.0f);
+    IS_EQUAL(avg.count(), 3u);
+    END_IT
+}
+
+int test_avg_float_matches_naive() {
+    IT("matches the summed mean over many windows");
+    static float values[5000];
+    srand(1);
+    fg::Avg<300> avg;
+    double worst = 0;
+    for (int i = 0; i < 5000; i++) {
+        values[i] = 40.0f + (rand() % 4000) / 100.0f;
+        avg.push(values[i]);
+        double error = fabs(avg.avg() - naiveMean(values, i + 1, 300));
+        worst = error > worst ? error : worst;
+    }
+    TRACE("max error " << worst << "\n");
+    IS_TRUE(worst < 0.001);
+    IS_TRUE(avg.last() == values[4999]);
+    IS_EQUAL(avg.count(), 300u);
+    END_IT
+}
+
+int test_avg_fixed_matches_naive() {
+    IT("matches the summed mean within the Fixed16 resolution");
+    static float values[5000];
+    srand(2);
+    fg::Avg<240, fg::Fixed16<100>> avg;
+    double worst = 0;
+    for (int i = 0; i < 5000; i++) {
+        values[i] = (rand() % 10000) / 100.0f;
+        avg.push(values[i]);
+        double error = fabs(avg.avg() - naiveMean(values, i + 1, 240));
+        worst = error > worst ? error : worst;
+    }
+    TRACE("max error " << worst << "\n");
+    IS_TRUE(worst < 0.005);
+    END_IT
+}
+
+int test_avg_fixed_halves_ram() {
+    IT("stores Fixed16 windows in half the RAM");
+    IS_TRUE(sizeof(fg::Avg<240, fg::Fixed16<100>>) < sizeof(fg::Avg<240>) / 2 + 16);
+    END_IT
+}
+
+int test_avg_clear() {
+    IT("starts over after clear");
+    fg::Avg<3> avg;
+    avg.push(10);
+    avg.push(20);
+    avg.push(30);
+    avg.push(40);
+    avg.clear();
+    avg.push(5);
+    IS_TRUE(avg.avg() == 5.0f);
+    IS_EQUAL(avg.count(), 1u);
+    END_IT
+}
+
+int test_fixed16_rounds_and_saturates() {
+    IT("rounds Fixed16 to the nearest step and saturates at its range");
+    IS_EQUAL(fg::Fixed16<100>::encode(12.345f), 1235);
+    IS_EQUAL(fg::Fixed16<100>::encode(-12.345f), -1235);
+    IS_EQUAL(fg::Fixed16<100>::encode(1000.0f), 32767);
+    IS_EQUAL(fg::Fixed16<100>::encode(-1000.0f), -32768);
+    IS_TRUE(fabs(fg::Fixed16<100>::decode(1235) - 12.35f) < 1e-6);
+    END_IT
+}
+
+int test_ema_primes_and_converges() {
+    IT("starts at the first sample and converges to a step");
+    fg::Ema ema(0.5f);
+    IS_TRUE(ema.push(10) == 10.0f);
+    IS_TRUE(ema.push(20) == 15.0f);
+    IS_TRUE(ema.push(20) == 17.5f);
+    for (int i = 0; i < 50; i++) {
+        ema.push(20);
+    }
+    IS_TRUE(fabs(ema.value() - 20.0f) < 1e-4);
+    ema.clear();
+    IS_TRUE(ema.value() == 0.0f);
+    IS_TRUE(ema.push(-3) == -3.0f);
+    END_IT
+}
+
+int test_minmax_empty_and_partial() {
+    IT("has no extremes before the first sample and tracks a partial window");
+    fg::WindowMinMax<5> minmax;
+    IS_TRUE(minmax.min() == 0.0f);
+    IS_TRUE(minmax.max() == 0.0f);
+    minmax.push(3);
+    minmax.push(-1);
+    minmax.push(7);
+    IS_TRUE(minmax.min() == -1.0f);
+    IS_TRUE(minmax.max() == 7.0f);
+    END_IT
+}
+
+int test_minmax_drops_old_extremes() {
+    IT("forgets extremes that left the window");
+    fg::WindowMinMax<3> minmax;
+    minmax.push(9);
+    minmax.push(1);
+    minmax.push(5);
+    minmax.push(4);
+    IS_TRUE(minmax.max() == 5.0f);
+    IS_TRUE(minmax.min() == 1.0f);
+    minmax.push(6);
+    IS_TRUE(minmax.min() == 4.0f);
+    IS_TRUE(minmax.max() == 6.0f);
+    minmax.clear();
+    minmax.push(2);
+    IS_TRUE(minmax.min() == 2.0f);
+    IS_TRUE(minmax.max() == 2.0f);
+    END_IT
+}
+
+template<typename Filter>
+static bool minMaxMatchesNaive(Filter& minmax, int count, float resolution) {
+    static float values[5000];
+    static float window[1000];
+    for (int i = 0; i < 5000; i++) {
+        // runs of rising and falling values exercise both queues
+        values[i] = (i / 50) % 2 ? (rand() % 1000) / 10.0f : (i % 50) * 2.0f + (rand() % 100) / 100.0f;
+        minmax.push(values[i]);
+        int length;
+        naiveWindow(values, i + 1, count, window, length);
+        if (fabs(minmax.min() - window[0]) > resolution || fabs(minmax.max() - window[length - 1]) > resolution) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int test_minmax_matches_naive() {
+    IT("matches a scan of the window over many windows");
+    srand(3);
+    fg::WindowMinMax<300> minmax;
+    IS_TRUE(minMaxMatchesNaive(minmax, 300, 0.0f));
+    fg::WindowMinMax<60, fg::Fixed16<100>> fixed;
+    IS_TRUE(minMaxMatchesNaive(fixed, 60, 0.005f));
+    END_IT
+}
+
+int test_median_odd_even_and_duplicates() {
+    IT("takes the middle sample or the mean of the middle two");
+    fg::Median<4> median;
+    IS_TRUE(median.median() == 0.0f);
+    median.push(5);
+    IS_TRUE(median.median() == 5.0f);
+    median.push(1);
+    IS_TRUE(median.median() == 3.0f);
+    median.push(9);
+    IS_TRUE(median.median() == 5.0f);
+    median.push(5);
+    IS_TRUE(median.median() == 5.0f);
+    // 5 leaves, the other 5 stays
+    median.push(100);
+    IS_TRUE(median.median() == 7.0f);
+    median.clear();
+    median.push(-2);
+    IS_TRUE(median.median() == -2.0f);
+    END_IT
+}
+
+int test_median_rejects_spikes() {
+    IT("ignores single spikes that move the average");
+    fg::Median<5> median;
+    fg::Avg<5> avg;
+    float readings[] = {20.1f, 20.2f, 85.0f, 20.0f, 20.3f};
+    for (float reading : readings) {
+        median.push(reading);
+        avg.push(reading);
+    }
+    IS_TRUE(median.median() == 20.2f);
+    IS_TRUE(avg.avg() > 30.0f);
+    END_IT
+}
+
+int test_median_matches_naive() {
+    IT("matches the median of the sorted window over many windows");
+    static float values[5000];
+    srand(4);
+    fg::Median<301> odd;
+    fg::Median<240, fg::Fixed16<100>> fixed;
+    bool oddMatches = true;
+    double worst = 0;
+    for (int i = 0; i < 5000; i++) {
+        // few distinct values, so the window holds many duplicates
+        values[i] = (rand() % 500) / 10.0f;
+        odd.push(values[i]);
+        fixed.push(values[i]);
+        oddMatches &= odd.median() == naiveMedian(values, i + 1, 301);
+        double error = fabs(fixed.median() - naiveMedian(values, i + 1, 240));
+        worst = error > worst ? error : worst;
+    }
+    TRACE("max error " << worst << "\n");
+    IS_TRUE(oddMatches);
+    IS_TRUE(worst < 0.005);
+    END_IT
+}
+
+int main()
+{
+    SUITE("Filter");
+    test_avg_empty();
+    test_avg_partial_window();
+    test_avg_float_matches_naive();
+    test_avg_fixed_matches_naive();
+    test_avg_fixed_halves_ram();
+    test_avg_clear();
+    test_fixed16_rounds_and_saturates();
+    test_ema_primes_and_converges();
+    test_minmax_empty_and_partial();
+    test_minmax_drops_old_extremes();
+    test_minmax_matches_naive();
+    test_median_odd_even_and_duplicates();
+    test_median_rejects_spikes();
+    test_median_matches_naive();
+
+    FINISH
+}
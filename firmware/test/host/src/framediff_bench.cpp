@@ -0,0 +1,87 @@
+#include "framediff.h"
+#include "bench.h"
+
+// I2C bytes per second of a 128x64 SSD1306 at the 10 Hz UI tick, counted
+// the way UserInterface::flush() sends: per dirty range 7 bytes of page and
+// column addressing, then the data in chunks of 127 with one control byte
+// each. The whole-frame numbers are what display.display() sent before.
+
+static const uint16_t WIDTH = 128;
+static const uint8_t PAGES = 8;
+static const uint16_t CHUNK = 127;
+static const unsigned TICKS_PER_SECOND = 10;
+
+typedef fg::FrameDiff<WIDTH, PAGES * 8> Diff;
+
+static unsigned rangeBytes(uint16_t first, uint16_t last) {
+    unsigned columns = last - first + 1;
+    return 7 + columns + (columns + CHUNK - 1) / CHUNK;
+}
+
+static unsigned sendDiff(Diff& diff, const uint8_t* frame) {
+    unsigned bytes = 0;
+    for (uint8_t page = 0; page < PAGES; page++) {
+        uint16_t first, last;
+        if (diff.dirty(frame, page, first, last)) {
+            bytes += rangeBytes(first, last);
+            diff.update(frame, page, first, last);
+        }
+    }
+    return bytes;
+}
+
+// draws tick t of a scene into frame
+typedef void (*Scene)(uint8_t* frame, unsigned t);
+
+static void staticDashboard(uint8_t* frame, unsigned) {
+    for (unsigned i = 0; i < WIDTH * PAGES; i++) {
+        frame[i] = (i * 37) & 0xff;
+    }
+}
+
+// one 50 column value in a 16 pixel font, changing every second
+static void valueDashboard(uint8_t* frame, unsigned t) {
+    staticDashboard(frame, t);
+    for (uint8_t page = 2; page < 4; page++) {
+        for (uint16_t column = 60; column < 110; column++) {
+            frame[page * WIDTH + column] = (column * (t / TICKS_PER_SECOND + 1)) & 0xff;
+        }
+    }
+}
+
+// a menu whose selection moves down one 8 pixel line per tick
+static void scrollingMenu(uint8_t* frame, unsigned t) {
+    memset(frame, 0, WIDTH * PAGES);
+    uint8_t selected = t % PAGES;
+    memset(frame + selected * WIDTH, 0xff, WIDTH);
+}
+
+static void measure(const char* name, Scene scene) {
+    Diff diff;
+    uint8_t frame[WIDTH * PAGES];
+    unsigned diffed = 0;
+    for (unsigned t = 0; t < 10 * TICKS_PER_SECOND; t++) {
+        scene(frame, t);
+        diffed += sendDiff(diff, frame);
+    }
+    unsigned full = PAGES * rangeBytes(0, WIDTH - 1) * TICKS_PER_SECOND;
+    printf("  %-24s %6u B/s full frame %6u B/s diffed\n", name, full, diffed / 10);
+}
+
+int main()
+{
+    printf("display bytes per second over 10 s at 10 Hz\n");
+    measure("static dashboard", staticDashboard);
+    measure("changing value", valueDashboard);
+    measure("scrolling menu", scrollingMenu);
+
+    printf("diff cost per frame\n");
+    Diff diff;
+    uint8_t frame[WIDTH * PAGES];
+    staticDashboard(frame, 0);
+    sendDiff(diff, frame);
+    bench("unchanged frame", 1000000, [&](unsigned long) {
+        return (float)sendDiff(diff, frame);
+    });
+    return 0;
+}
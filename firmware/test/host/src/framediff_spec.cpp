@@ -0,0 +1,123 @@
+#include "framediff.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+typedef fg::FrameDiff<128, 64> Diff;
+static const uint16_t WIDTH = 128;
+
+// marks the whole frame as shown
+static void showAll(Diff& diff, const uint8_t* frame) {
+    for (uint8_t page = 0; page < Diff::PAGES; page++) {
+        diff.update(frame, page, 0, WIDTH - 1);
+    }
+}
+
+int test_dirty_before_first_frame() {
+    IT("reports every page in full before anything was shown");
+    Diff diff;
+    uint8_t frame[WIDTH * 8] = {0};
+    for (uint8_t page = 0; page < Diff::PAGES; page++) {
+        uint16_t first = 1, last = 1;
+        IS_TRUE(diff.dirty(frame, page, first, last));
+        IS_EQUAL(first, 0);
+        IS_EQUAL(last, WIDTH - 1);
+    }
+    END_IT
+}
+
+int test_static_frame_clean() {
+    IT("reports nothing for a frame that is already shown");
+    Diff diff;
+    uint8_t frame[WIDTH * 8];
+    memset(frame, 0x5a, sizeof(frame));
+    showAll(diff, frame);
+    for (uint8_t page = 0; page < Diff::PAGES; page++) {
+        uint16_t first, last;
+        IS_FALSE(diff.dirty(frame, page, first, last));
+    }
+    END_IT
+}
+
+int test_changed_columns() {
+    IT("narrows a page to its first and last changed column");
+    Diff diff;
+    uint8_t frame[WIDTH * 8] = {0};
+    showAll(diff, frame);
+    frame[3 * WIDTH + 40] = 0xff;
+    frame[3 * WIDTH + 89] = 0x01;
+    uint16_t first = 0, last = 0;
+    IS_FALSE(diff.dirty(frame, 2, first, last));
+    IS_TRUE(diff.dirty(frame, 3, first, last));
+    IS_EQUAL(first, 40);
+    IS_EQUAL(last, 89);
+    IS_FALSE(diff.dirty(frame, 4, first, last));
+    END_IT
+}
+
+int test_edge_columns() {
+    IT("finds changes in the first and last column");
+    Diff diff;
+    uint8_t frame[WIDTH * 8] = {0};
+    showAll(diff, frame);
+    frame[7 * WIDTH] = 1;
+    frame[7 * WIDTH + WIDTH - 1] = 1;
+    uint16_t first = 0, last = 0;
+    IS_TRUE(diff.dirty(frame, 7, first, last));
+    IS_EQUAL(first, 0);
+    IS_EQUAL(last, WIDTH - 1);
+    END_IT
+}
+
+int test_unconfirmed_range_stays_dirty() {
+    IT("keeps a range dirty until it is confirmed as sent");
+    Diff diff;
+    uint8_t frame[WIDTH * 8] = {0};
+    showAll(diff, frame);
+    frame[10] = 0x80;
+    uint16_t first = 0, last = 0;
+    IS_TRUE(diff.dirty(frame, 0, first, last));
+    // the write failed, nothing is updated
+    IS_TRUE(diff.dirty(frame, 0, first, last));
+    diff.update(frame, 0, first, last);
+    IS_FALSE(diff.dirty(frame, 0, first, last));
+    END_IT
+}
+
+int test_partial_update_keeps_page_invalid() {
+    IT("needs a full page write before partial diffs are trusted");
+    Diff diff;
+    uint8_t frame[WIDTH * 8] = {0};
+    diff.update(frame, 0, 10, 20);
+    uint16_t first = 0, last = 0;
+    IS_TRUE(diff.dirty(frame, 0, first, last));
+    IS_EQUAL(first, 0);
+    IS_EQUAL(last, WIDTH - 1);
+    END_IT
+}
+
+int test_invalidate() {
+    IT("sends everything again after invalidate");
+    Diff diff;
+    uint8_t frame[WIDTH * 8] = {0};
+    showAll(diff, frame);
+    diff.invalidate();
+    uint16_t first = 0, last = 0;
+    IS_TRUE(diff.dirty(frame, 5, first, last));
+    IS_EQUAL(first, 0);
+    IS_EQUAL(last, WIDTH - 1);
+    END_IT
+}
+
+int main()
+{
+    SUITE("FrameDiff");
+    test_dirty_before_first_frame();
+    test_static_frame_clean();
+    test_changed_columns();
+    test_edge_columns();
+    test_unconfirmed_range_stays_dirty();
+    test_partial_update_keeps_page_invalid();
+    test_invalidate();
+
+    FINISH
+}
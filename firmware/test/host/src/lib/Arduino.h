@@ -0,0 +1,18 @@
+#pragma once
+
+// The parts of the Arduino core the tested headers use. Hardware access is
+// declared only, a spec that calls it provides its own fake.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint32_t TickType_t;
+#define configTICK_RATE_HZ 1000
+
+uint32_t millis();
+uint32_t analogReadMilliVolts(uint8_t pin);
+
+#include "WString.h"
+#include "Stream.h"
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Arduino.h"
+
+// Reads back what was printed to it, as the ESP32 core one.
+class StreamString : public Stream, public String {
+  size_t position = 0;
+
+public:
+  size_t print(const String& str) {
+    concat(str.c_str(), str.length());
+    return str.length();
+  }
+
+  int available() override { return length() - position; }
+  int read() override { return available() ? c_str()[position++] : -1; }
+  int peek() override { return available() ? c_str()[position] : -1; }
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+// Arduino String on top of std::string, the members the tested code uses.
+
+#include <string>
+
+class String {
+  std::string s;
+
+public:
+  String(const char* str = "") : s(str ? str : "") {}
+  String(const std::string& str) : s(str) {}
+
+  const char* c_str() const { return s.c_str(); }
+  unsigned int length() const { return s.size(); }
+  bool reserve(unsigned int size) { s.reserve(size); return true; }
+  bool concat(const char* str, unsigned int length) { s.append(str, length); return true; }
+
+  bool equals(const String& other) const { return s == other.s; }
+  bool operator==(const String& other) const { return equals(other); }
+  bool operator!=(const String& other) const { return !equals(other); }
+  bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+  bool endsWith(const String& suffix) const {
+    return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+  }
+
+  int indexOf(char c) const {
+    size_t at = s.find(c);
+    return at == std::string::npos ? -1 : (int)at;
+  }
+  String substring(unsigned int left, unsigned int right) const {
+    if(left > right) {
+      unsigned int swap = left;
+      left = right;
+      right = swap;
+    }
+    if(left >= s.size()) {
+      return String();
+    }
+    return String(s.substr(left, right - left));
+  }
+  String substring(unsigned int left) const { return substring(left, s.size()); }
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Prints the time per call of fn, averaged over iterations calls, and the
+// TSC cycles per call where the host has a TSC. The result is kept alive
+// through a volatile sink so the compiler cannot drop the work.
+template<typename F>
+double bench(const char* name, unsigned long iterations, F fn) {
+  static volatile float sink;
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned long long start_cycles = __rdtsc();
+#endif
+  auto start = std::chrono::steady_clock::now();
+  for(unsigned long i = 0; i < iterations; i++) {
+    sink = fn(i);
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  (void)sink;
+  double per_call = elapsed / iterations;
+#if defined(__x86_64__) || defined(__i386__)
+  double cycles = (double)(__rdtsc() - start_cycles) / iterations;
+  printf("  %-40s %9.1f ns %9.1f cycles\n", name, per_call, cycles);
+#else
+  printf("  %-40s %9.1f ns\n", name, per_call);
+#endif
+  return per_call;
+}
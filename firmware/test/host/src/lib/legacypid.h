@@ -0,0 +1,53 @@
+#pragma once
+
+// fg::Pid before it was templated, in double with the integral clamped
+// but not held while the output saturates. Reference for pid_spec and
+// pid_bench.
+
+#include "filter.h"
+
+class LegacyPid {
+    static constexpr const size_t D_SMOOTHING = 10;
+    const double fp;
+    const double fi;
+    const double fd;
+
+    double previous = 0;
+
+    double p = 0;
+    double i = 0;
+    double d = 0;
+
+    fg::Avg<D_SMOOTHING> current_smooth;
+    size_t d_wait = D_SMOOTHING;
+
+    static double clamp(double min, double max, double value) {
+        return value < min ? min : value > max ? max : value;
+    }
+
+public:
+    LegacyPid(double fp = 1.0, double fi = 0.0, double fd = 0.0) : fp(fp), fi(fi), fd(fd) {}
+
+    double tick(double current, double target) {
+        auto error = target - current;
+        p = fp * error;
+
+        i += fi * error;
+        i = clamp(-1, 1, i);
+
+        current_smooth.push(current);
+        auto smooth_error = target - current_smooth.avg();
+
+        d = fd * (smooth_error - previous);
+        previous = smooth_error;
+
+        if (d_wait) {
+            d = 0;
+            d_wait--;
+        }
+
+        return clamp(0, 1, p + i + d);
+    }
+
+    double getI() const { return i; }
+};
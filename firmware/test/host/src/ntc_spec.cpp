@@ -0,0 +1,109 @@
+#include "ntc.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+static uint32_t fake_millivolts = 0;
+static uint32_t fake_reads = 0;
+
+uint32_t analogReadMilliVolts(uint8_t) {
+    fake_reads++;
+    return fake_millivolts;
+}
+
+// largest error of the table against the formula for codes whose exact
+// temperature lies within low .. high
+static double worstError(double low, double high) {
+    double worst = 0;
+    for (uint16_t code = 1; code < fg::ntc::ADC_MAX; code++) {
+        double exact = fg::ntc::exactTemperature(code);
+        if (exact < low || exact > high) {
+            continue;
+        }
+        double error = fabs(fg::ntcToTemp(code) - exact);
+        worst = error > worst ? error : worst;
+    }
+    return worst;
+}
+
+int test_table_matches_formula() {
+    IT("stays within 0.03 °C of the beta equation from -20 °C to 100 °C");
+    double worst = worstError(-20, 100);
+    TRACE("max error " << worst << " °C\n");
+    IS_TRUE(worst < 0.03);
+    END_IT
+}
+
+int test_table_matches_formula_hot() {
+    IT("stays within 0.4 °C of the beta equation up to 150 °C");
+    double worst = worstError(100, 150);
+    TRACE("max error " << worst << " °C\n");
+    IS_TRUE(worst < 0.4);
+    END_IT
+}
+
+int test_table_exact_on_entries() {
+    IT("is exact on the table entries");
+    for (int index = 1; index * fg::ntc::TABLE_STEP < fg::ntc::ADC_MAX; index++) {
+        uint16_t code = index * fg::ntc::TABLE_STEP;
+        IS_TRUE(fabs(fg::ntcToTemp(code) - fg::ntc::exactTemperature(code)) < 0.001);
+    }
+    END_IT
+}
+
+int test_table_monotonic() {
+    IT("falls monotonically with the ADC code");
+    for (uint16_t code = 1; code <= fg::ntc::ADC_MAX; code++) {
+        IS_TRUE(fg::ntcToTemp(code) <= fg::ntcToTemp(code - 1));
+    }
+    END_IT
+}
+
+int test_table_reference_point() {
+    IT("reads 25 °C when the NTC equals the divider resistor");
+    IS_TRUE(fabs(fg::ntcToTemp(fg::ntc::ADC_MAX / 2) - 25.0f) < 0.05f);
+    END_IT
+}
+
+int test_table_ends_finite() {
+    IT("stays finite at and beyond the ends of the range");
+    IS_TRUE(isfinite(fg::ntcToTemp(0)));
+    IS_TRUE(isfinite(fg::ntcToTemp(fg::ntc::ADC_MAX)));
+    IS_TRUE(fg::ntcToTemp(60000) == fg::ntcToTemp(fg::ntc::ADC_MAX));
+    END_IT
+}
+
+int test_sample_oversamples() {
+    IT("averages the requested number of calibrated reads");
+    fake_reads = 0;
+    fake_millivolts = 1650;
+    IS_EQUAL(fg::ntcSample(0), 2048);
+    IS_EQUAL(fake_reads, (uint32_t)fg::ntc::OVERSAMPLING);
+
+    fake_reads = 0;
+    fake_millivolts = 0;
+    IS_EQUAL(fg::ntcSample(0, 4), 0);
+    IS_EQUAL(fake_reads, 4u);
+    END_IT
+}
+
+int test_sample_clamps() {
+    IT("clamps readings above the supply to the largest code");
+    fake_millivolts = 3400;
+    IS_EQUAL(fg::ntcSample(0), fg::ntc::ADC_MAX);
+    END_IT
+}
+
+int main()
+{
+    SUITE("NTC");
+    test_table_matches_formula();
+    test_table_matches_formula_hot();
+    test_table_exact_on_entries();
+    test_table_monotonic();
+    test_table_reference_point();
+    test_table_ends_finite();
+    test_sample_oversamples();
+    test_sample_clamps();
+
+    FINISH
+}
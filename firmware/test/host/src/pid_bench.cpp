@@ -0,0 +1,26 @@
+#include "pid.h"
+#include "legacypid.h"
+#include "bench.h"
+
+static const unsigned long TICKS = 5000000;
+
+// measurement wobbling around the target, so no variant saturates
+static inline float measurement(unsigned long i) {
+    return 24.5f + (i % 64) / 64.0f;
+}
+
+int main()
+{
+    printf("Pid tick with the heater gains\n");
+    LegacyPid legacy(0.5, 0.001, 100.0);
+    fg::BasicPid<double> in_double(0.5f, 0.001f, 100.0f);
+    fg::Pid in_float(0.5f, 0.001f, 100.0f);
+    fg::BasicPid<fg::Q16_16> in_fixed(0.5f, 0.001f, 100.0f);
+
+    bench("former Pid, double", TICKS, [&](unsigned long i) { return (float)legacy.tick(measurement(i), 25.0); });
+    bench("BasicPid<double>", TICKS, [&](unsigned long i) { return in_double.tick(measurement(i), 25.0f); });
+    bench("Pid (float)", TICKS, [&](unsigned long i) { return in_float.tick(measurement(i), 25.0f); });
+    bench("BasicPid<Q16_16>", TICKS, [&](unsigned long i) { return in_fixed.tick(measurement(i), 25.0f); });
+    printf("  host numbers; the ESP32 has no double FPU, so double costs far more there\n");
+    return 0;
+}
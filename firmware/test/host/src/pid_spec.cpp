@@ -0,0 +1,131 @@
+#include "pid.h"
+#include "legacypid.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <math.h>
+
+// the heater gains of every hwtype
+static const float GAIN_P = 0.5f;
+static const float GAIN_I = 0.001f;
+static const float GAIN_D = 100.0f;
+
+static const float AMBIENT = 15.0f;
+static const float TARGET = 25.0f;
+static const int TICKS = 2 * 60 * 60;
+
+// box warmed by the heater, one tick per second
+struct Plant {
+    float temperature = 18.0f;
+
+    float step(float output) {
+        temperature += (AMBIENT - temperature) / 900.0f + 0.05f * output;
+        return temperature;
+    }
+};
+
+// runs two controllers side by side, each on its own plant, and returns
+// the largest output difference from tick `from` on
+template<typename A, typename B>
+double worstDifference(A& a, B& b, Plant& plant_a, Plant& plant_b, int from = 0) {
+    double worst = 0;
+    for (int tick = 0; tick < TICKS; tick++) {
+        double output_a = a.tick(plant_a.temperature, TARGET);
+        double output_b = b.tick(plant_b.temperature, TARGET);
+        plant_a.step(output_a);
+        plant_b.step(output_b);
+        double difference = fabs(output_a - output_b);
+        if (tick >= from && difference > worst) {
+            worst = difference;
+        }
+    }
+    return worst;
+}
+
+int test_float_matches_double() {
+    IT("runs the same in float as in double");
+    fg::BasicPid<double> reference(GAIN_P, GAIN_I, GAIN_D);
+    fg::Pid pid(GAIN_P, GAIN_I, GAIN_D);
+    Plant plant_reference, plant;
+    double worst = worstDifference(reference, pid, plant_reference, plant);
+    TRACE("max output difference " << worst << "\n");
+    IS_TRUE(worst < 0.002);
+    END_IT
+}
+
+int test_float_matches_legacy() {
+    IT("settles like the former double Pid");
+    LegacyPid legacy(GAIN_P, GAIN_I, GAIN_D);
+    fg::Pid pid(GAIN_P, GAIN_I, GAIN_D);
+    Plant plant_legacy, plant;
+    // the first hour differs by design, anti-windup shortens the overshoot
+    double worst = worstDifference(legacy, pid, plant_legacy, plant, TICKS / 2);
+    TRACE("max output difference " << worst << "\n");
+    IS_TRUE(worst < 0.002);
+    IS_TRUE(fabs(plant_legacy.temperature - TARGET) < 0.01f);
+    IS_TRUE(fabs(plant.temperature - TARGET) < 0.01f);
+    END_IT
+}
+
+int test_fixed_matches_float() {
+    IT("runs the heater gains in Q16.16 within 0.005 of float");
+    fg::Pid pid(GAIN_P, GAIN_I, GAIN_D);
+    fg::BasicPid<fg::Q16_16> fixed(GAIN_P, GAIN_I, GAIN_D);
+    Plant plant, plant_fixed;
+    double worst = worstDifference(pid, fixed, plant, plant_fixed);
+    TRACE("max output difference " << worst << "\n");
+    IS_TRUE(worst < 0.005);
+    IS_TRUE(fabs(plant_fixed.temperature - TARGET) < 0.005f);
+    END_IT
+}
+
+int test_fixed_drops_small_integral_steps() {
+    IT("drops integral steps below the Q16.16 resolution");
+    fg::Pid pid(GAIN_P, GAIN_I, 0);
+    fg::BasicPid<fg::Q16_16> fixed(GAIN_P, GAIN_I, 0);
+    // 0.001 * 0.005 is a third of a Q16.16 step
+    for (int tick = 0; tick < 1000; tick++) {
+        pid.tick(TARGET - 0.005f, TARGET);
+        fixed.tick(TARGET - 0.005f, TARGET);
+    }
+    IS_TRUE(pid.getI() > 0.004f);
+    IS_TRUE(fixed.getI() == 0.0f);
+    END_IT
+}
+
+int test_anti_windup() {
+    IT("holds the integral while the output is saturated");
+    fg::Pid pid(GAIN_P, GAIN_I, GAIN_D);
+    LegacyPid legacy(GAIN_P, GAIN_I, GAIN_D);
+    for (int tick = 0; tick < 1000; tick++) {
+        IS_TRUE(pid.tick(AMBIENT, TARGET) == 1.0f);
+        legacy.tick(AMBIENT, TARGET);
+    }
+    IS_TRUE(pid.getI() == 0.0f);
+    IS_TRUE(legacy.getI() == 1.0);
+    END_IT
+}
+
+int test_derivative_on_measurement() {
+    IT("does not kick the derivative on a setpoint change");
+    fg::Pid pid(GAIN_P, GAIN_I, GAIN_D);
+    for (int tick = 0; tick < 100; tick++) {
+        pid.tick(TARGET, TARGET);
+    }
+    pid.tick(TARGET, TARGET + 2.0f);
+    IS_TRUE(pid.getD() == 0.0f);
+    IS_TRUE(pid.getP() == GAIN_P * 2.0f);
+    END_IT
+}
+
+int main()
+{
+    SUITE("Pid");
+    test_float_matches_double();
+    test_float_matches_legacy();
+    test_fixed_matches_float();
+    test_fixed_drops_small_integral_steps();
+    test_anti_windup();
+    test_derivative_on_measurement();
+
+    FINISH
+}
@@ -0,0 +1,32 @@
+#include "textbuffer.h"
+#include "bench.h"
+#include <iomanip>
+#include <sstream>
+#include <string.h>
+
+// one dashboard value, "23.4C", the way the widgets formatted it before
+// and now
+static float value(unsigned long i) {
+    return 15.0f + (i % 200) / 10.0f;
+}
+
+int main()
+{
+    printf("format a temperature with unit\n");
+    bench("std::stringstream", 1000000, [](unsigned long i) {
+        std::stringstream value_print;
+        value_print << std::fixed << std::setprecision(1) << value(i) << "C";
+        return (float)strlen(value_print.str().c_str());
+    });
+    bench("snprintf", 1000000, [](unsigned long i) {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%.1fC", value(i));
+        return (float)strlen(buffer);
+    });
+    bench("TextBuffer<16>", 1000000, [](unsigned long i) {
+        fg::TextBuffer<16> value_print;
+        value_print.fixed(value(i), 1).append("C");
+        return (float)value_print.len();
+    });
+    return 0;
+}
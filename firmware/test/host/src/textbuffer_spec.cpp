@@ -0,0 +1,89 @@
+#include "textbuffer.h"
+#include "BDDTest.h"
+#include "trace.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int test_fixed_matches_printf() {
+    IT("formats fixed point like printf");
+    srand(3);
+    for (int i = 0; i < 200000; i++) {
+        float value = (rand() - RAND_MAX / 2) / (float)(1 << (rand() % 24));
+        unsigned precision = rand() % 4;
+        fg::TextBuffer<32> text;
+        text.fixed(value, precision);
+        char expected[64];
+        snprintf(expected, sizeof(expected), "%.*f", precision, value);
+        if (strcmp(text.c_str(), expected) != 0) {
+            TRACE(value << " " << precision << ": " << text.c_str() << " != " << expected << "\n");
+        }
+        IS_TRUE(strcmp(text.c_str(), expected) == 0);
+    }
+    END_IT
+}
+
+int test_fixed_rounding_ties() {
+    IT("rounds ties to even like printf");
+    fg::TextBuffer<16> text;
+    text.fixed(0.5f, 0).append(' ').fixed(1.5f, 0).append(' ').fixed(2.5f, 0).append(' ').fixed(0.125f, 2);
+    IS_TRUE(strcmp(text.c_str(), "0 2 2 0.12") == 0);
+    END_IT
+}
+
+int test_fixed_special_values() {
+    IT("writes nan, inf and negative zero");
+    fg::TextBuffer<32> text;
+    text.fixed(NAN, 1).append(' ').fixed(-INFINITY, 1).append(' ').fixed(1e13f, 1).append(' ').fixed(-0.0f, 1);
+    IS_TRUE(strcmp(text.c_str(), "nan -inf inf -0.0") == 0);
+    END_IT
+}
+
+int test_integer() {
+    IT("formats integers over the whole int32 range");
+    const int32_t values[] = {0, 7, -7, 1234567, INT32_MAX, INT32_MIN};
+    for (auto value : values) {
+        fg::TextBuffer<16> text;
+        text.integer(value);
+        char expected[16];
+        snprintf(expected, sizeof(expected), "%d", value);
+        IS_TRUE(strcmp(text.c_str(), expected) == 0);
+    }
+    END_IT
+}
+
+int test_truncates() {
+    IT("truncates output that does not fit and stays terminated");
+    fg::TextBuffer<6> text;
+    text.append("RSSI: ").fixed(-67.0f, 0);
+    IS_TRUE(strcmp(text.c_str(), "RSSI:") == 0);
+    IS_EQUAL(text.len(), 5u);
+    END_IT
+}
+
+int test_repeat_and_clear() {
+    IT("repeats characters and starts over after clear");
+    fg::TextBuffer<16> text;
+    text.repeat('#', 3).append("x");
+    IS_TRUE(strcmp(text.c_str(), "###x") == 0);
+    text.clear();
+    IS_EQUAL(text.len(), 0u);
+    IS_TRUE(strcmp(text.c_str(), "") == 0);
+    text.fixed(23.45f, 1).append('C');
+    IS_TRUE(strcmp(text.c_str(), "23.5C") == 0);
+    END_IT
+}
+
+int main()
+{
+    SUITE("TextBuffer");
+    test_fixed_matches_printf();
+    test_fixed_rounding_ties();
+    test_fixed_special_values();
+    test_integer();
+    test_truncates();
+    test_repeat_and_clear();
+
+    FINISH
+}
@@ -0,0 +1,119 @@
+#include "TopicSubscriptionList.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+typedef TopicSubscriptionList::Record Record;
+
+// Handler calls, per topic the handler was subscribed for
+struct Calls {
+    int control = 0;
+    int tunnel = 0;
+    String tunnelPayload;
+};
+
+static Record controlRecord(Calls& calls) {
+    return { "fg/control", NULL, [&calls](const String&, const String&) { calls.control++; }, NULL };
+}
+
+static Record tunnelRecord(Calls& calls) {
+    return { "fg/tunnel_write", NULL, NULL, [&calls](const String&, Stream& payload, uint32_t length) {
+        calls.tunnel++;
+        for(uint32_t i = 0; i < length; i++) {
+            char c = payload.read();
+            calls.tunnelPayload.concat(&c, 1);
+        }
+    } };
+}
+
+int test_resubscribe_keeps_handlers_apart() {
+    IT("dispatches each topic to its own handler after subscribing twice");
+    Calls calls;
+    TopicSubscriptionList list;
+    // connect, then reconnect subscribing the same topics again
+    for(int connection = 0; connection < 2; connection++) {
+        list.set(controlRecord(calls));
+        list.set(tunnelRecord(calls));
+    }
+    IS_EQUAL(list.size(), 2u);
+
+    list.dispatch("fg/control", "{}");
+    IS_EQUAL(calls.control, 1);
+    IS_EQUAL(calls.tunnel, 0);
+
+    list.dispatch("fg/tunnel_write", "data");
+    IS_EQUAL(calls.control, 1);
+    IS_EQUAL(calls.tunnel, 1);
+    IS_TRUE(calls.tunnelPayload == "data");
+    END_IT
+}
+
+int test_resubscribe_replaces_kind() {
+    IT("keeps only the callback of the last subscription of a topic");
+    Calls calls;
+    int received = 0;
+    TopicSubscriptionList list;
+    list.set({ "fg/tunnel_write", [&received](const String&) { received++; }, NULL, NULL });
+    list.set(tunnelRecord(calls));
+    IS_EQUAL(list.size(), 1u);
+    IS_TRUE(list[0].callback == NULL);
+    IS_TRUE(list[0].callbackWithTopic == NULL);
+    IS_TRUE(list[0].streamCallback != NULL);
+
+    list.dispatch("fg/tunnel_write", "data");
+    IS_EQUAL(received, 0);
+    IS_EQUAL(calls.tunnel, 1);
+    END_IT
+}
+
+int test_stream_subscriber() {
+    IT("streams to a topic only when no subscription needs a String");
+    Calls calls;
+    TopicSubscriptionList list;
+    list.set(controlRecord(calls));
+    list.set(tunnelRecord(calls));
+    IS_TRUE(list.streamSubscriber("fg/tunnel_write") != NULL);
+    IS_TRUE(list.streamSubscriber("fg/control") == NULL);
+    IS_TRUE(list.streamSubscriber("fg/other") == NULL);
+
+    // a wildcard String subscription needs the tunnel payload as well
+    list.set({ "fg/#", [](const String&) {}, NULL, NULL });
+    IS_TRUE(list.streamSubscriber("fg/tunnel_write") == NULL);
+    END_IT
+}
+
+int test_remove() {
+    IT("removes a topic and nothing else");
+    Calls calls;
+    TopicSubscriptionList list;
+    list.set(controlRecord(calls));
+    list.set(tunnelRecord(calls));
+    IS_TRUE(list.remove("fg/control"));
+    IS_FALSE(list.remove("fg/control"));
+    IS_FALSE(list.contains("fg/control"));
+    IS_TRUE(list.contains("fg/tunnel_write"));
+    list.dispatch("fg/control", "{}");
+    IS_EQUAL(calls.control, 0);
+    END_IT
+}
+
+int test_match() {
+    IT("matches topics with a wildcard");
+    IS_TRUE(TopicSubscriptionList::match("fg/control", "fg/control"));
+    IS_FALSE(TopicSubscriptionList::match("fg/control", "fg/controls"));
+    IS_TRUE(TopicSubscriptionList::match("fg/#", "fg/a/b"));
+    IS_TRUE(TopicSubscriptionList::match("fg/+/state", "fg/a/state"));
+    IS_FALSE(TopicSubscriptionList::match("fg/+/state", "fg/a/b/state"));
+    END_IT
+}
+
+int main()
+{
+    SUITE("TopicSubscriptionList");
+    test_resubscribe_keeps_handlers_apart();
+    test_resubscribe_replaces_kind();
+    test_stream_subscriber();
+    test_remove();
+    test_match();
+
+    FINISH
+}
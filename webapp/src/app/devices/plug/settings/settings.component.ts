@@ -162,6 +162,10 @@ export class PlugSettingsComponent implements OnInit {
           "device_id": device_settings.fan?.device_id || "none",
           "speed": device_settings.fan?.speed || 100
         },
+        "daisy": {
+          "node": device_settings.daisy?.node || 0,
+          "fast": device_settings.daisy?.fast || false
+        },
         "limits": {
           "overtemperature": {
             enabled: device_settings.limits?.overtemperature.enabled || false,
@@ -251,6 +255,10 @@ export class PlugSettingsComponent implements OnInit {
           "device_id": "none",
           "speed": 100
         },
+        "daisy": {
+          "node": 0,
+          "fast": false
+        },
         "limits": {
           "overtemperature": {
             enabled: false,